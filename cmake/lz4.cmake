@@ -0,0 +1,30 @@
+if(NOT DEFINED LZ4_CONFIGURED)
+	# Enable ExternalProject CMake module
+	include(ExternalProject)
+
+	# Download and build lz4
+	ExternalProject_Add(
+	  lz4
+	  GIT_REPOSITORY https://github.com/lz4/lz4.git
+	  GIT_TAG v1.9.4
+	  PREFIX ${CMAKE_CURRENT_BINARY_DIR}/lz4
+	  SOURCE_SUBDIR build/cmake
+	  CMAKE_ARGS -DBUILD_SHARED_LIBS=OFF -DBUILD_STATIC_LIBS=ON -DLZ4_BUILD_CLI=OFF -DLZ4_BUILD_LEGACY_LZ4C=OFF
+	  INSTALL_COMMAND ""
+	)
+
+	# Get the binary and source dirs
+	ExternalProject_Get_Property(lz4 source_dir binary_dir)
+
+	# Create a liblz4 target to be used as a dependency by test programs
+	add_library(liblz4 IMPORTED STATIC GLOBAL)
+	add_dependencies(liblz4 lz4)
+
+	# Set liblz4 properties
+	set_target_properties(liblz4 PROPERTIES
+	  "IMPORTED_LOCATION" "${binary_dir}/${CMAKE_CFG_INTDIR}/lz4.lib"
+	)
+	include_directories("${source_dir}/lib")
+
+	set(LZ4_CONFIGURED TRUE)
+endif()
@@ -0,0 +1,37 @@
+#include "asset_file.h"
+
+#include "core/pack_archive.h"
+
+namespace Core {
+
+bool AssetFile::Open(const filesystem::path& path) {
+  Close();
+
+  // Empty files are rejected the same way whether they come from an archive or not
+  if (ReadPackedFile(path, &m_packed_data_)) {
+    if (m_packed_data_.empty()) {
+      return false;
+    }
+
+    m_data_ = m_packed_data_.data();
+    m_size_ = m_packed_data_.size();
+    return true;
+  }
+
+  if (!m_file_.Open(path)) {
+    return false;
+  }
+
+  m_data_ = m_file_.GetData();
+  m_size_ = m_file_.GetSize();
+  return true;
+}
+
+void AssetFile::Close() {
+  m_file_.Close();
+  m_packed_data_.clear();
+  m_data_ = nullptr;
+  m_size_ = 0;
+}
+
+}  // namespace Core
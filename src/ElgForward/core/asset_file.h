@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "core/mapped_file.h"
+
+namespace Core {
+
+// Whole asset file, decompressed from a mounted pack archive or mapped straight from disk when no archive holds it
+class AssetFile {
+public:
+  AssetFile() = default;
+  ~AssetFile() = default;
+
+  AssetFile(const AssetFile& other) = delete;
+  AssetFile& operator=(const AssetFile& other) = delete;
+
+  bool Open(const filesystem::path& path);
+
+  void Close();
+
+  const uint8_t* GetData() const {
+    return m_data_;
+  }
+
+  size_t GetSize() const {
+    return m_size_;
+  }
+
+private:
+  MappedFile m_file_;
+  std::vector<uint8_t> m_packed_data_;
+  const uint8_t* m_data_ = nullptr;
+  size_t m_size_ = 0;
+};
+
+}  // namespace Core
@@ -26,6 +26,10 @@ public:
     m_storage_[key] = handle;
   }
 
+  void Remove(const KeyType& key) {
+    m_storage_.erase(key);
+  }
+
 private:
   std::unordered_map<KeyType, HandleType, std::hash<KeyType>, std::equal_to<KeyType>> m_storage_;
 };
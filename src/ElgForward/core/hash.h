@@ -7,6 +7,7 @@
  */
 
 #include <functional>
+#include <string_view>
 
 namespace hash_detail {
 
@@ -94,7 +95,7 @@ struct hash<D3D11_INPUT_ELEMENT_DESC> {
   size_t operator()(const D3D11_INPUT_ELEMENT_DESC& d) const {
     size_t seed = 0;
 
-    hash_combine(seed, d.SemanticName);
+    hash_combine(seed, std::string_view(d.SemanticName));
     hash_combine(seed, d.SemanticIndex);
     hash_combine(seed, d.Format);
     hash_combine(seed, d.InputSlot);
@@ -113,6 +114,13 @@ struct hash<std::vector<D3D11_INPUT_ELEMENT_DESC>> {
   }
 };
 
+template<>
+struct hash<std::vector<ID3D11ShaderResourceView*>> {
+  size_t operator()(const std::vector<ID3D11ShaderResourceView*>& v) const {
+    return hash_range(std::begin(v), std::end(v));
+  }
+};
+
 template<>
 struct equal_to<D3D11_INPUT_ELEMENT_DESC> {
   bool operator()(const D3D11_INPUT_ELEMENT_DESC& lhs, const D3D11_INPUT_ELEMENT_DESC& rhs) const {
@@ -1,24 +1,22 @@
 #include "json_helpers.h"
 
-#include <fstream>
-
 #pragma warning(push)
 #pragma warning(disable: 4706)
 #include <nlohmann/json.hpp>
 #pragma warning(pop)
 
+#include "core/asset_file.h"
 #include "core/filesystem.h"
 
 namespace Core {
 
 bool ReadJsonFile(const filesystem::path& path, nlohmann::json* json) {
-  std::ifstream input(path);
-
-  if (!input.good()) {
+  AssetFile file;
+  if (!file.Open(path)) {
     return false;
   }
 
-  input >> *json;
+  *json = nlohmann::json::parse(file.GetData(), file.GetData() + file.GetSize());
 
   return true;
 }
@@ -0,0 +1,632 @@
+#include "json_stream.h"
+
+#include <charconv>
+#include <utility>
+#include <vector>
+
+#include "core/asset_file.h"
+
+namespace Core {
+
+// Turns parse events into visitor calls for the records and a document for everything else
+class JsonStreamHandler {
+ public:
+  JsonStreamHandler(const std::string& record_array, JsonRecordVisitor* visitor, nlohmann::json* json)
+      : m_record_array_(record_array), m_visitor_(visitor), m_root_(json) {
+  }
+
+  void Null() {
+    JsonStreamValue value;
+    Scalar(value, nullptr);
+  }
+
+  void Boolean(bool b) {
+    JsonStreamValue value;
+    value.ValueType = JsonStreamValue::Type::Boolean;
+    value.Boolean = b;
+    Scalar(value, b);
+  }
+
+  void Integer(int64_t i) {
+    JsonStreamValue value;
+    value.ValueType = JsonStreamValue::Type::Integer;
+    value.Number = static_cast<double>(i);
+    Scalar(value, i);
+  }
+
+  void Unsigned(uint64_t u) {
+    JsonStreamValue value;
+    value.ValueType = JsonStreamValue::Type::Integer;
+    value.Number = static_cast<double>(u);
+    Scalar(value, u);
+  }
+
+  void Float(double f) {
+    JsonStreamValue value;
+    value.ValueType = JsonStreamValue::Type::Float;
+    value.Number = f;
+    Scalar(value, f);
+  }
+
+  void String(std::string& s) {
+    JsonStreamValue value;
+    value.ValueType = JsonStreamValue::Type::String;
+    value.String = &s;
+    Scalar(value, s);
+  }
+
+  void StartObject() {
+    if (m_in_records_) {
+      StartRecordStructure(false);
+      return;
+    }
+
+    m_dom_stack_.push_back(Insert(nlohmann::json::object()));
+  }
+
+  void Key(const std::string& k) {
+    if (m_in_records_) {
+      auto& context = m_record_stack_.back();
+      m_path_.resize(context.PathLength);
+      if (!m_path_.empty()) {
+        m_path_ += '.';
+      }
+      m_path_ += k;
+      return;
+    }
+
+    m_key_ = k;
+  }
+
+  void EndObject() {
+    if (m_in_records_) {
+      EndRecordStructure();
+      return;
+    }
+
+    m_dom_stack_.pop_back();
+  }
+
+  void StartArray() {
+    if (m_in_records_) {
+      StartRecordStructure(true);
+      return;
+    }
+
+    // Only the array directly under the root object is streamed
+    if (m_dom_stack_.size() == 1 && m_dom_stack_.back()->is_object() && m_key_ == m_record_array_) {
+      Insert(nlohmann::json::array());
+      m_in_records_ = true;
+      return;
+    }
+
+    m_dom_stack_.push_back(Insert(nlohmann::json::array()));
+  }
+
+  void EndArray() {
+    if (m_in_records_) {
+      if (m_record_stack_.empty()) {
+        m_in_records_ = false;
+      } else {
+        EndRecordStructure();
+      }
+      return;
+    }
+
+    m_dom_stack_.pop_back();
+  }
+
+ private:
+  struct RecordContext {
+    bool IsArray;
+    int32_t Index;
+    size_t PathLength;
+  };
+
+  nlohmann::json* Insert(nlohmann::json&& value) {
+    if (m_dom_stack_.empty()) {
+      *m_root_ = std::move(value);
+      return m_root_;
+    }
+
+    auto* parent = m_dom_stack_.back();
+    if (parent->is_array()) {
+      parent->push_back(std::move(value));
+      return &parent->back();
+    }
+
+    auto& member = (*parent)[m_key_];
+    member = std::move(value);
+    return &member;
+  }
+
+  template <typename T>
+  void Scalar(const JsonStreamValue& value, const T& dom_value) {
+    if (!m_in_records_) {
+      Insert(nlohmann::json(dom_value));
+      return;
+    }
+
+    if (m_record_stack_.empty()) {
+      m_path_.clear();
+      m_visitor_->BeginRecord();
+      m_visitor_->Value(m_path_, -1, value);
+      m_visitor_->EndRecord();
+      return;
+    }
+
+    ReportRecordValue(value);
+  }
+
+  void ReportRecordValue(const JsonStreamValue& value) {
+    auto& context = m_record_stack_.back();
+    if (context.IsArray) {
+      m_visitor_->Value(m_path_, context.Index, value);
+      context.Index += 1;
+    } else {
+      m_visitor_->Value(m_path_, -1, value);
+    }
+  }
+
+  void StartRecordStructure(bool is_array) {
+    if (m_record_stack_.empty()) {
+      m_path_.clear();
+      m_visitor_->BeginRecord();
+      if (is_array) {
+        JsonStreamValue value;
+        value.ValueType = JsonStreamValue::Type::Array;
+        m_visitor_->Value(m_path_, -1, value);
+      }
+      m_record_stack_.push_back({ is_array, 0, 0 });
+      return;
+    }
+
+    JsonStreamValue value;
+    value.ValueType = is_array ? JsonStreamValue::Type::Array : JsonStreamValue::Type::Object;
+    ReportRecordValue(value);
+
+    // Members of an object read from m_path_ through their keys, elements of an array read from the path it was
+    // found at. An array directly inside an array gets its own path so its elements never pass for the outer ones.
+    if (m_record_stack_.back().IsArray && is_array) {
+      m_path_ += "[]";
+    }
+    m_record_stack_.push_back({ is_array, 0, m_path_.size() });
+  }
+
+  void EndRecordStructure() {
+    m_record_stack_.pop_back();
+    if (m_record_stack_.empty()) {
+      m_visitor_->EndRecord();
+      return;
+    }
+
+    // Back to the path of the enclosing structure, the next key or element overwrites the rest
+    auto& context = m_record_stack_.back();
+    if (context.IsArray) {
+      m_path_.resize(context.PathLength);
+    }
+  }
+
+  const std::string& m_record_array_;
+  JsonRecordVisitor* m_visitor_;
+  nlohmann::json* m_root_;
+
+  std::vector<nlohmann::json*> m_dom_stack_;
+  std::string m_key_;
+
+  bool m_in_records_ = false;
+  std::vector<RecordContext> m_record_stack_;
+  std::string m_path_;
+};
+
+// Minimal RFC 8259 parser working straight on the mapped bytes. Strings and numbers are decoded in place instead of
+// going through a token buffer, which is where most of the time of a general purpose parser goes on scene files.
+class JsonStreamParser {
+ public:
+  JsonStreamParser(const char* begin, const char* end, JsonStreamHandler* handler)
+      : m_cursor_(begin), m_end_(end), m_handler_(handler) {
+  }
+
+  bool Parse() {
+    // Byte order marks are allowed in front of the document
+    if (m_end_ - m_cursor_ >= 3 && m_cursor_[0] == '\xEF' && m_cursor_[1] == '\xBB' && m_cursor_[2] == '\xBF') {
+      m_cursor_ += 3;
+    }
+
+    // true for arrays, false for objects
+    std::vector<bool> containers;
+
+    while (true) {
+      if (!SkipWhitespace()) {
+        return false;
+      }
+
+      // Value
+      auto c = *m_cursor_;
+      if (c == '{') {
+        m_cursor_ += 1;
+        m_handler_->StartObject();
+        if (!SkipWhitespace()) {
+          return false;
+        }
+
+        if (*m_cursor_ == '}') {
+          m_cursor_ += 1;
+          m_handler_->EndObject();
+        } else {
+          containers.push_back(false);
+          if (!ParseKey()) {
+            return false;
+          }
+          continue;
+        }
+      } else if (c == '[') {
+        m_cursor_ += 1;
+        m_handler_->StartArray();
+        if (!SkipWhitespace()) {
+          return false;
+        }
+
+        if (*m_cursor_ == ']') {
+          m_cursor_ += 1;
+          m_handler_->EndArray();
+        } else {
+          containers.push_back(true);
+          continue;
+        }
+      } else if (c == '"') {
+        if (!ParseString()) {
+          return false;
+        }
+        m_handler_->String(m_string_);
+      } else if (c == 't') {
+        if (!ParseLiteral("true")) {
+          return false;
+        }
+        m_handler_->Boolean(true);
+      } else if (c == 'f') {
+        if (!ParseLiteral("false")) {
+          return false;
+        }
+        m_handler_->Boolean(false);
+      } else if (c == 'n') {
+        if (!ParseLiteral("null")) {
+          return false;
+        }
+        m_handler_->Null();
+      } else if (!ParseNumber()) {
+        return false;
+      }
+
+      // Separators and closing brackets after the value
+      while (true) {
+        if (containers.empty()) {
+          while (m_cursor_ != m_end_ && IsWhitespace(*m_cursor_)) {
+            ++m_cursor_;
+          }
+          return m_cursor_ == m_end_;
+        }
+
+        if (!SkipWhitespace()) {
+          return false;
+        }
+
+        bool is_array = containers.back();
+        c = *m_cursor_++;
+        if (c == ',') {
+          if (!is_array && !ParseKey()) {
+            return false;
+          }
+          break;
+        }
+
+        if (c == (is_array ? ']' : '}')) {
+          containers.pop_back();
+          if (is_array) {
+            m_handler_->EndArray();
+          } else {
+            m_handler_->EndObject();
+          }
+          continue;
+        }
+
+        return false;
+      }
+    }
+  }
+
+ private:
+  static bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  // Returns false at the end of the input, nothing that calls it may end there
+  bool SkipWhitespace() {
+    while (m_cursor_ != m_end_ && IsWhitespace(*m_cursor_)) {
+      ++m_cursor_;
+    }
+    return m_cursor_ != m_end_;
+  }
+
+  bool ParseKey() {
+    if (!SkipWhitespace() || *m_cursor_ != '"' || !ParseString()) {
+      return false;
+    }
+
+    if (!SkipWhitespace() || *m_cursor_ != ':') {
+      return false;
+    }
+    m_cursor_ += 1;
+
+    m_handler_->Key(m_string_);
+    return true;
+  }
+
+  bool ParseLiteral(const char* literal) {
+    for (; *literal != '\0'; ++literal, ++m_cursor_) {
+      if (m_cursor_ == m_end_ || *m_cursor_ != *literal) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  }
+
+  bool ParseHex4(uint32_t* code_unit) {
+    if (m_end_ - m_cursor_ < 4) {
+      return false;
+    }
+
+    *code_unit = 0;
+    for (int i = 0; i < 4; ++i) {
+      auto digit = HexValue(*m_cursor_++);
+      if (digit < 0) {
+        return false;
+      }
+      *code_unit = (*code_unit << 4) | static_cast<uint32_t>(digit);
+    }
+    return true;
+  }
+
+  void AppendUtf8(uint32_t code_point) {
+    if (code_point < 0x80) {
+      m_string_ += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+      m_string_ += static_cast<char>(0xC0 | (code_point >> 6));
+      m_string_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+      m_string_ += static_cast<char>(0xE0 | (code_point >> 12));
+      m_string_ += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      m_string_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+      m_string_ += static_cast<char>(0xF0 | (code_point >> 18));
+      m_string_ += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+      m_string_ += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      m_string_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+  }
+
+  bool ParseEscape() {
+    if (m_cursor_ == m_end_) {
+      return false;
+    }
+
+    switch (*m_cursor_++) {
+      case '"': m_string_ += '"'; return true;
+      case '\\': m_string_ += '\\'; return true;
+      case '/': m_string_ += '/'; return true;
+      case 'b': m_string_ += '\b'; return true;
+      case 'f': m_string_ += '\f'; return true;
+      case 'n': m_string_ += '\n'; return true;
+      case 'r': m_string_ += '\r'; return true;
+      case 't': m_string_ += '\t'; return true;
+      case 'u': break;
+      default: return false;
+    }
+
+    uint32_t code_point;
+    if (!ParseHex4(&code_point)) {
+      return false;
+    }
+
+    if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+      // High surrogate, the low half has to follow as another escape
+      uint32_t low;
+      if (m_end_ - m_cursor_ < 2 || m_cursor_[0] != '\\' || m_cursor_[1] != 'u') {
+        return false;
+      }
+      m_cursor_ += 2;
+      if (!ParseHex4(&low) || low < 0xDC00 || low > 0xDFFF) {
+        return false;
+      }
+      code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+    } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+      return false;
+    }
+
+    AppendUtf8(code_point);
+    return true;
+  }
+
+  // Decodes the string starting at the opening quote into m_string_, which keeps its capacity between strings
+  bool ParseString() {
+    m_cursor_ += 1;
+    m_string_.clear();
+
+    while (true) {
+      auto run_start = m_cursor_;
+      while (m_cursor_ != m_end_ && *m_cursor_ != '"' && *m_cursor_ != '\\' && static_cast<unsigned char>(*m_cursor_) >= 0x20) {
+        ++m_cursor_;
+      }
+      m_string_.append(run_start, m_cursor_);
+
+      if (m_cursor_ == m_end_) {
+        return false;
+      }
+
+      auto c = *m_cursor_++;
+      if (c == '"') {
+        return true;
+      }
+
+      if (c != '\\' || !ParseEscape()) {
+        return false;
+      }
+    }
+  }
+
+  bool SkipDigits() {
+    auto start = m_cursor_;
+    while (m_cursor_ != m_end_ && *m_cursor_ >= '0' && *m_cursor_ <= '9') {
+      ++m_cursor_;
+    }
+    return m_cursor_ != start;
+  }
+
+  bool ParseNumber() {
+    auto start = m_cursor_;
+    bool is_float = false;
+
+    if (*m_cursor_ == '-') {
+      ++m_cursor_;
+    }
+
+    // No leading zeros
+    if (m_cursor_ != m_end_ && *m_cursor_ == '0') {
+      ++m_cursor_;
+    } else if (!SkipDigits()) {
+      return false;
+    }
+
+    if (m_cursor_ != m_end_ && *m_cursor_ == '.') {
+      ++m_cursor_;
+      is_float = true;
+      if (!SkipDigits()) {
+        return false;
+      }
+    }
+
+    if (m_cursor_ != m_end_ && (*m_cursor_ == 'e' || *m_cursor_ == 'E')) {
+      ++m_cursor_;
+      is_float = true;
+      if (m_cursor_ != m_end_ && (*m_cursor_ == '+' || *m_cursor_ == '-')) {
+        ++m_cursor_;
+      }
+      if (!SkipDigits()) {
+        return false;
+      }
+    }
+
+    // Integers that do not fit 64 bits are kept as floats, like nlohmann::json does
+    if (!is_float) {
+      if (*start == '-') {
+        int64_t value;
+        auto result = std::from_chars(start, m_cursor_, value);
+        if (result.ec == std::errc()) {
+          m_handler_->Integer(value);
+          return true;
+        }
+      } else {
+        uint64_t value;
+        auto result = std::from_chars(start, m_cursor_, value);
+        if (result.ec == std::errc()) {
+          m_handler_->Unsigned(value);
+          return true;
+        }
+      }
+    }
+
+    double value;
+    auto result = std::from_chars(start, m_cursor_, value);
+    if (result.ec != std::errc()) {
+      return false;
+    }
+
+    m_handler_->Float(value);
+    return true;
+  }
+
+  const char* m_cursor_;
+  const char* m_end_;
+  JsonStreamHandler* m_handler_;
+  std::string m_string_;
+};
+
+JsonStreamValue GetStreamValue(const nlohmann::json& json_value) {
+  JsonStreamValue value;
+  if (json_value.is_boolean()) {
+    value.ValueType = JsonStreamValue::Type::Boolean;
+    value.Boolean = json_value.get<bool>();
+  } else if (json_value.is_number_float()) {
+    value.ValueType = JsonStreamValue::Type::Float;
+    value.Number = json_value.get<double>();
+  } else if (json_value.is_number()) {
+    value.ValueType = JsonStreamValue::Type::Integer;
+    value.Number = json_value.get<double>();
+  } else if (json_value.is_string()) {
+    value.ValueType = JsonStreamValue::Type::String;
+    value.String = &json_value.get_ref<const std::string&>();
+  } else if (json_value.is_object()) {
+    value.ValueType = JsonStreamValue::Type::Object;
+  } else if (json_value.is_array()) {
+    value.ValueType = JsonStreamValue::Type::Array;
+  }
+  return value;
+}
+
+void VisitJsonMembers(const std::string& path, const nlohmann::json& json_value, bool in_array, JsonRecordVisitor* visitor) {
+  if (json_value.is_object()) {
+    for (auto it = json_value.begin(); it != json_value.end(); ++it) {
+      auto member_path = path.empty() ? it.key() : path + '.' + it.key();
+      visitor->Value(member_path, -1, GetStreamValue(it.value()));
+      VisitJsonMembers(member_path, it.value(), false, visitor);
+    }
+  } else if (json_value.is_array()) {
+    auto element_path = in_array ? path + "[]" : path;
+    int32_t index = 0;
+    for (const auto& element : json_value) {
+      visitor->Value(element_path, index++, GetStreamValue(element));
+      VisitJsonMembers(element_path, element, true, visitor);
+    }
+  }
+}
+
+void VisitJsonRecord(const nlohmann::json& record, JsonRecordVisitor* visitor) {
+  std::string path;
+
+  visitor->BeginRecord();
+  if (!record.is_object()) {
+    visitor->Value(path, -1, GetStreamValue(record));
+  }
+  VisitJsonMembers(path, record, false, visitor);
+  visitor->EndRecord();
+}
+
+bool StreamJsonFile(const filesystem::path& path, const std::string& record_array, JsonRecordVisitor* visitor,
+                    nlohmann::json* json) {
+  AssetFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+
+  auto begin = reinterpret_cast<const char*>(file.GetData());
+  auto end = begin + file.GetSize();
+
+  JsonStreamHandler handler(record_array, visitor, json);
+  JsonStreamParser parser(begin, end, &handler);
+  return parser.Parse();
+}
+
+}  // namespace Core
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#pragma warning(push)
+#pragma warning(disable: 4706)
+#include <nlohmann/json.hpp>
+#pragma warning(pop)
+
+#include "core/filesystem.h"
+
+namespace Core {
+
+struct JsonStreamValue {
+  enum class Type {
+    Null,
+    Boolean,
+    Integer,
+    Float,
+    String,
+    Object,  // Members and elements follow as values of their own
+    Array,
+  };
+
+  Type ValueType = Type::Null;
+  bool Boolean = false;
+  double Number = 0.0;
+  const std::string* String = nullptr;  // Only valid during the callback
+};
+
+// Receives the elements of a streamed array one at a time
+class JsonRecordVisitor {
+ public:
+  virtual ~JsonRecordVisitor() = default;
+
+  virtual void BeginRecord() = 0;
+
+  // path joins the keys from the record root with '.', an array directly inside another array adds "[]". index is
+  // the position inside the enclosing array or -1 for object members and the record root.
+  virtual void Value(const std::string& path, int32_t index, const JsonStreamValue& value) = 0;
+
+  virtual void EndRecord() = 0;
+};
+
+// Parses a JSON asset file in memory without building a document for the top level array record_array - its elements
+// go to the visitor as they are parsed and the array is left empty in *json. Everything else is returned in *json
+// like ReadJsonFile does. Records visited before a parse error are not taken back.
+bool StreamJsonFile(const filesystem::path& path, const std::string& record_array, JsonRecordVisitor* visitor,
+                    nlohmann::json* json);
+
+// Sends an already parsed value to the visitor as a single record, with the same events StreamJsonFile produces
+void VisitJsonRecord(const nlohmann::json& record, JsonRecordVisitor* visitor);
+
+// Collects a float array of a record, accepting the same values as ReadFloat/ReadFloat3/ReadFloat4
+template <size_t N>
+struct JsonStreamFloats {
+  float Values[N] = {};
+  uint32_t Size = 0;
+  bool Present = false;
+  bool Valid = true;
+
+  void Read(int32_t index, const JsonStreamValue& value) {
+    Present = true;
+
+    if (index < 0) {
+      if (N == 1 && value.ValueType == JsonStreamValue::Type::Float) {
+        Values[0] = static_cast<float>(value.Number);
+        Size = 1;
+      } else if (value.ValueType != JsonStreamValue::Type::Array) {
+        Valid = false;
+      }
+      return;
+    }
+
+    if (value.ValueType != JsonStreamValue::Type::Float || static_cast<size_t>(index) >= N) {
+      Valid = false;
+      return;
+    }
+
+    Values[index] = static_cast<float>(value.Number);
+    Size = std::max(Size, static_cast<uint32_t>(index) + 1);
+  }
+
+  bool HasSize(uint32_t size) const {
+    return Present && Valid && Size == size;
+  }
+
+  void Reset() {
+    Size = 0;
+    Present = false;
+    Valid = true;
+  }
+};
+
+}  // namespace Core
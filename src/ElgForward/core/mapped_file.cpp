@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+namespace Core {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_file_(std::exchange(other.m_file_, INVALID_HANDLE_VALUE)),
+      m_mapping_(std::exchange(other.m_mapping_, nullptr)),
+      m_data_(std::exchange(other.m_data_, nullptr)),
+      m_size_(std::exchange(other.m_size_, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    m_file_ = std::exchange(other.m_file_, INVALID_HANDLE_VALUE);
+    m_mapping_ = std::exchange(other.m_mapping_, nullptr);
+    m_data_ = std::exchange(other.m_data_, nullptr);
+    m_size_ = std::exchange(other.m_size_, 0);
+  }
+  return *this;
+}
+
+bool MappedFile::Open(const filesystem::path& path) {
+  Close();
+
+  m_file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (m_file_ == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(m_file_, &file_size) || file_size.QuadPart == 0) {
+    Close();
+    return false;
+  }
+
+  m_mapping_ = CreateFileMappingW(m_file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping_ == nullptr) {
+    Close();
+    return false;
+  }
+
+  m_data_ = static_cast<const uint8_t*>(MapViewOfFile(m_mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (m_data_ == nullptr) {
+    Close();
+    return false;
+  }
+
+  m_size_ = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_data_ != nullptr) {
+    UnmapViewOfFile(m_data_);
+    m_data_ = nullptr;
+  }
+
+  if (m_mapping_ != nullptr) {
+    CloseHandle(m_mapping_);
+    m_mapping_ = nullptr;
+  }
+
+  if (m_file_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_file_);
+    m_file_ = INVALID_HANDLE_VALUE;
+  }
+
+  m_size_ = 0;
+}
+
+}  // namespace Core
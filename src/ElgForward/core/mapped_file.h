@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Windows.h>
+
+#include "core/filesystem.h"
+
+namespace Core {
+
+// Read only view of a whole file, unmapped when the object goes away
+class MappedFile {
+public:
+  MappedFile() = default;
+
+  ~MappedFile() {
+    Close();
+  }
+
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  bool Open(const filesystem::path& path);
+
+  void Close();
+
+  const uint8_t* GetData() const {
+    return m_data_;
+  }
+
+  size_t GetSize() const {
+    return m_size_;
+  }
+
+private:
+  HANDLE m_file_ = INVALID_HANDLE_VALUE;
+  HANDLE m_mapping_ = nullptr;
+  const uint8_t* m_data_ = nullptr;
+  size_t m_size_ = 0;
+};
+
+}  // namespace Core
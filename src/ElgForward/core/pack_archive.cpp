@@ -0,0 +1,331 @@
+#include "pack_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <lz4.h>
+
+namespace Core {
+
+bool PackArchive::Open(const filesystem::path& path) {
+  Close();
+
+  if (!m_file_.Open(path)) {
+    return false;
+  }
+
+  auto data = m_file_.GetData();
+  auto size = m_file_.GetSize();
+
+  if (size < sizeof(PackFile::Header)) {
+    Close();
+    return false;
+  }
+
+  const auto& header = *reinterpret_cast<const PackFile::Header*>(data);
+  bool is_header_valid = header.Magic == PackFile::Magic
+                      && header.Version == PackFile::Version
+                      && header.FileSize == size
+                      && header.BlockSize > 0
+                      && header.BlockSize <= static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE);
+  if (!is_header_valid) {
+    Close();
+    return false;
+  }
+
+  auto is_section_valid = [size](const PackFile::Section& section, size_t element_size, size_t alignment) {
+    return section.Offset % alignment == 0
+        && section.Offset <= size
+        && section.Count <= (size - section.Offset) / element_size;
+  };
+
+  if (!is_section_valid(header.Entries, sizeof(PackFile::Entry), alignof(PackFile::Entry)) ||
+      !is_section_valid(header.Blocks, sizeof(uint32_t), alignof(uint32_t))) {
+    Close();
+    return false;
+  }
+
+  m_block_size_ = header.BlockSize;
+  m_entries_ = reinterpret_cast<const PackFile::Entry*>(data + header.Entries.Offset);
+  m_entry_count_ = static_cast<size_t>(header.Entries.Count);
+  m_blocks_ = reinterpret_cast<const uint32_t*>(data + header.Blocks.Offset);
+  m_block_count_ = static_cast<size_t>(header.Blocks.Count);
+
+  bool is_sorted = std::is_sorted(m_entries_, m_entries_ + m_entry_count_, [](const auto& lhs, const auto& rhs) {
+    return lhs.PathHash < rhs.PathHash;
+  });
+  bool are_entries_valid = std::all_of(m_entries_, m_entries_ + m_entry_count_, [this](const auto& entry) {
+    return IsEntryValid(entry);
+  });
+  if (!is_sorted || !are_entries_valid) {
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+void PackArchive::Close() {
+  m_file_.Close();
+  m_block_size_ = 0;
+  m_entries_ = nullptr;
+  m_entry_count_ = 0;
+  m_blocks_ = nullptr;
+  m_block_count_ = 0;
+}
+
+bool PackArchive::IsEntryValid(const PackFile::Entry& entry) const {
+  auto size = m_file_.GetSize();
+  if (entry.Offset > size || entry.StoredSize > size - entry.Offset) {
+    return false;
+  }
+
+  switch (entry.CompressionType) {
+    case PackFile::Compression::None:
+      return entry.StoredSize == entry.Size;
+    case PackFile::Compression::Lz4: {
+      auto block_count = PackFile::GetBlockCount(entry.Size, m_block_size_);
+      if (entry.FirstBlock > m_block_count_ || block_count > m_block_count_ - entry.FirstBlock) {
+        return false;
+      }
+
+      // Blocks have to cover the blob exactly and none may be larger than its source
+      uint64_t stored_size = 0;
+      for (uint64_t i = 0; i < block_count; ++i) {
+        auto block_source_size = std::min<uint64_t>(m_block_size_, entry.Size - i * m_block_size_);
+        auto block_stored_size = m_blocks_[entry.FirstBlock + i];
+        if (block_stored_size == 0 || block_stored_size > block_source_size) {
+          return false;
+        }
+        stored_size += block_stored_size;
+      }
+      return stored_size == entry.StoredSize;
+    }
+    default:
+      return false;
+  }
+}
+
+const PackFile::Entry* PackArchive::Find(const filesystem::path& relative_path) const {
+  auto path_hash = PackFile::HashPath(relative_path);
+
+  auto entries_end = m_entries_ + m_entry_count_;
+  auto entry_it = std::lower_bound(m_entries_, entries_end, path_hash, [](const auto& entry, uint64_t hash) {
+    return entry.PathHash < hash;
+  });
+
+  if (entry_it == entries_end || entry_it->PathHash != path_hash) {
+    return nullptr;
+  }
+
+  return entry_it;
+}
+
+bool PackArchive::Read(const PackFile::Entry& entry, std::vector<uint8_t>* data) const {
+  std::vector<std::vector<uint8_t>> results;
+  if (!Read(std::vector<const PackFile::Entry*>{ &entry }, &results)) {
+    return false;
+  }
+
+  *data = std::move(results[0]);
+  return true;
+}
+
+struct BlockJob {
+  const uint8_t* Source;
+  uint32_t SourceSize;
+  uint8_t* Destination;
+  uint32_t Size;
+};
+
+bool PackArchive::Read(const std::vector<const PackFile::Entry*>& entries, std::vector<std::vector<uint8_t>>* data) const {
+  std::vector<std::vector<uint8_t>> results(entries.size());
+  std::vector<uint8_t*> buffers(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    results[i].resize(static_cast<size_t>(entries[i]->Size));
+    buffers[i] = results[i].data();
+  }
+
+  if (!Read(entries, buffers)) {
+    return false;
+  }
+
+  *data = std::move(results);
+  return true;
+}
+
+bool PackArchive::Read(const std::vector<const PackFile::Entry*>& entries, const std::vector<uint8_t*>& buffers) const {
+  auto file_data = m_file_.GetData();
+
+  std::vector<BlockJob> jobs;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const auto& entry = *entries[i];
+    auto buffer = buffers[i];
+
+    auto source = file_data + entry.Offset;
+    if (entry.CompressionType == PackFile::Compression::None) {
+      if (entry.Size > 0) {
+        std::memcpy(buffer, source, static_cast<size_t>(entry.Size));
+      }
+      continue;
+    }
+
+    auto block_count = PackFile::GetBlockCount(entry.Size, m_block_size_);
+    for (uint64_t block = 0; block < block_count; ++block) {
+      BlockJob job;
+      job.Source = source;
+      job.SourceSize = m_blocks_[entry.FirstBlock + block];
+      job.Destination = buffer + static_cast<size_t>(block * m_block_size_);
+      job.Size = static_cast<uint32_t>(std::min<uint64_t>(m_block_size_, entry.Size - block * m_block_size_));
+      jobs.emplace_back(job);
+
+      source += job.SourceSize;
+    }
+  }
+
+  auto job_count = static_cast<uint32_t>(jobs.size());
+  std::vector<uint8_t> jobs_ok(jobs.size(), 0);
+
+  auto worker_count = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), job_count);
+
+  auto run_worker = [&](uint32_t worker_index) {
+    for (auto i = worker_index; i < job_count; i += worker_count) {
+      const auto& job = jobs[i];
+      if (job.SourceSize == job.Size) {
+        std::memcpy(job.Destination, job.Source, job.Size);
+        jobs_ok[i] = 1;
+        continue;
+      }
+
+      auto decompressed_size = LZ4_decompress_safe(reinterpret_cast<const char*>(job.Source), reinterpret_cast<char*>(job.Destination),
+                                                   static_cast<int>(job.SourceSize), static_cast<int>(job.Size));
+      jobs_ok[i] = decompressed_size == static_cast<int>(job.Size) ? 1 : 0;
+    }
+  };
+
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
+
+  if (worker_count > 0) {
+    run_worker(0);
+  }
+
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  return std::find(std::begin(jobs_ok), std::end(jobs_ok), 0) == std::end(jobs_ok);
+}
+
+struct MountedPackArchive {
+  PackArchive Archive;
+  filesystem::path RootPath;
+};
+
+std::vector<std::unique_ptr<MountedPackArchive>> g_mounted_archives_;
+
+bool MountPackArchive(const filesystem::path& pack_path, const filesystem::path& root_path) {
+  auto mounted_archive = std::make_unique<MountedPackArchive>();
+  if (!mounted_archive->Archive.Open(pack_path)) {
+    return false;
+  }
+
+  mounted_archive->RootPath = root_path;
+  g_mounted_archives_.emplace_back(std::move(mounted_archive));
+  return true;
+}
+
+void UnmountPackArchives() {
+  g_mounted_archives_.clear();
+}
+
+bool FindPackedFile(const filesystem::path& path, const PackArchive** archive, const PackFile::Entry** entry) {
+  for (const auto& mounted_archive : g_mounted_archives_) {
+    filesystem::path relative_path;
+    if (!PackFile::GetRelativePath(path, mounted_archive->RootPath, &relative_path)) {
+      continue;
+    }
+
+    *entry = mounted_archive->Archive.Find(relative_path);
+    if (*entry != nullptr) {
+      *archive = &mounted_archive->Archive;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ReadPackedFile(const filesystem::path& path, std::vector<uint8_t>* data) {
+  const PackArchive* archive;
+  const PackFile::Entry* entry;
+  if (!FindPackedFile(path, &archive, &entry)) {
+    return false;
+  }
+
+  return archive->Read(*entry, data);
+}
+
+bool ReadLooseFile(const filesystem::path& path, std::vector<uint8_t>* data) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return false;
+  }
+
+  data->resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(data->data()), static_cast<std::streamsize>(data->size()));
+  return static_cast<bool>(file);
+}
+
+bool ReadAssetFiles(const std::vector<filesystem::path>& paths, std::vector<std::vector<uint8_t>>* data) {
+  std::vector<std::vector<uint8_t>> results(paths.size());
+
+  // Packed files are batched per archive, so the blocks of all of them share the workers
+  std::vector<const PackArchive*> archives(paths.size(), nullptr);
+  std::vector<const PackFile::Entry*> entries(paths.size(), nullptr);
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (!FindPackedFile(paths[i], &archives[i], &entries[i])) {
+      archives[i] = nullptr;
+      if (!ReadLooseFile(paths[i], &results[i])) {
+        return false;
+      }
+    }
+  }
+
+  for (const auto& mounted_archive : g_mounted_archives_) {
+    std::vector<size_t> indices;
+    std::vector<const PackFile::Entry*> archive_entries;
+    for (size_t i = 0; i < paths.size(); ++i) {
+      if (archives[i] == &mounted_archive->Archive) {
+        indices.emplace_back(i);
+        archive_entries.emplace_back(entries[i]);
+      }
+    }
+
+    if (archive_entries.empty()) {
+      continue;
+    }
+
+    std::vector<std::vector<uint8_t>> archive_results;
+    if (!mounted_archive->Archive.Read(archive_entries, &archive_results)) {
+      return false;
+    }
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+      results[indices[i]] = std::move(archive_results[i]);
+    }
+  }
+
+  *data = std::move(results);
+  return true;
+}
+
+}  // namespace Core
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "core/mapped_file.h"
+#include "core/pack_file.h"
+
+namespace Core {
+
+// Read only view of an archive written by ElgPack. The directory is checked once when the archive is opened, reads
+// only decompress.
+class PackArchive {
+public:
+  PackArchive() = default;
+  ~PackArchive() = default;
+
+  PackArchive(const PackArchive& other) = delete;
+  PackArchive& operator=(const PackArchive& other) = delete;
+
+  bool Open(const filesystem::path& path);
+
+  void Close();
+
+  // Returns nullptr when the archive doesn't hold the path, which is relative to the archive root
+  const PackFile::Entry* Find(const filesystem::path& relative_path) const;
+
+  bool Read(const PackFile::Entry& entry, std::vector<uint8_t>* data) const;
+
+  // Blocks of all entries are decompressed together on all cores
+  bool Read(const std::vector<const PackFile::Entry*>& entries, std::vector<std::vector<uint8_t>>* data) const;
+
+  // Same as above into buffers the caller owns, each has to hold the Size of its entry
+  bool Read(const std::vector<const PackFile::Entry*>& entries, const std::vector<uint8_t*>& buffers) const;
+
+private:
+  bool IsEntryValid(const PackFile::Entry& entry) const;
+
+  MappedFile m_file_;
+  uint32_t m_block_size_ = 0;
+  const PackFile::Entry* m_entries_ = nullptr;
+  size_t m_entry_count_ = 0;
+  const uint32_t* m_blocks_ = nullptr;
+  size_t m_block_count_ = 0;
+};
+
+// Archives are searched before loose files. Mount them before loading starts, reads from loader threads don't lock.
+bool MountPackArchive(const filesystem::path& pack_path, const filesystem::path& root_path);
+
+void UnmountPackArchives();
+
+// First mounted archive holding the file
+bool FindPackedFile(const filesystem::path& path, const PackArchive** archive, const PackFile::Entry** entry);
+
+// Fails when no mounted archive holds the file
+bool ReadPackedFile(const filesystem::path& path, std::vector<uint8_t>* data);
+
+// Files missing from the archives are read from disk, every file is read or the call fails
+bool ReadAssetFiles(const std::vector<filesystem::path>& paths, std::vector<std::vector<uint8_t>>* data);
+
+}  // namespace Core
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/filesystem.h"
+
+namespace Core {
+namespace PackFile {
+
+// Layout of the asset archives written by ElgPack. The header and directory sit at the front of the file so opening
+// an archive touches one contiguous range, every blob starts on its own aligned offset and is split into blocks that
+// are LZ4 compressed independently, so one large blob still decompresses on all cores.
+
+const uint32_t Magic = 0x4B504C45;  // "ELPK"
+const uint32_t Version = 1;
+
+const uint64_t BlobAlignment = 4096;
+const uint32_t BlockSize = 256 * 1024;
+
+enum class Compression : uint32_t {
+  None = 0,  // Blob holds the file as is
+  Lz4 = 1,  // Blob holds the blocks back to back, a block as large as its source is stored uncompressed
+};
+
+// Array of Count elements at Offset bytes from the start of the file
+struct Section {
+  uint64_t Offset;
+  uint64_t Count;
+};
+
+struct Entry {
+  uint64_t PathHash;  // Entries are sorted by it
+  uint64_t Offset;
+  uint64_t StoredSize;
+  uint64_t Size;
+  uint32_t FirstBlock;  // Into the block table, Lz4 entries only
+  Compression CompressionType;
+};
+
+struct Header {
+  uint32_t Magic;
+  uint32_t Version;
+  uint64_t FileSize;
+  uint32_t BlockSize;
+  uint32_t Reserved;
+  Section Entries;  // Entry
+  Section Blocks;  // uint32_t stored size of each block
+};
+
+inline uint64_t GetBlockCount(uint64_t size, uint32_t block_size) {
+  return (size + block_size - 1) / block_size;
+}
+
+// FNV-1a of the normalized path relative to the archive root - stable across builds, unlike std::hash, and case
+// insensitive like the file system the assets come from
+inline uint64_t HashPath(const filesystem::path& relative_path) {
+  auto path_string = relative_path.lexically_normal().generic_string();
+
+  uint64_t hash = 0xcbf29ce484222325;
+  for (auto c : path_string) {
+    hash ^= static_cast<uint8_t>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+// Fails for paths outside the root
+inline bool GetRelativePath(const filesystem::path& path, const filesystem::path& root_path, filesystem::path* relative_path) {
+  auto relative = path.lexically_normal().lexically_relative(root_path.lexically_normal());
+  if (relative.empty() || *relative.begin() == "..") {
+    return false;
+  }
+
+  *relative_path = relative;
+  return true;
+}
+
+}  // namespace PackFile
+}  // namespace Core
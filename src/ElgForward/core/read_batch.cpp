@@ -0,0 +1,167 @@
+#include "read_batch.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/pack_archive.h"
+
+namespace Core {
+
+// Large files go out as several reads so the OS can keep more than one request per file in flight
+const DWORD ReadChunkSize = 8 * 1024 * 1024;
+
+bool GetAssetFileSize(const filesystem::path& path, size_t* size) {
+  const PackArchive* archive;
+  const PackFile::Entry* entry;
+  if (FindPackedFile(path, &archive, &entry)) {
+    *size = static_cast<size_t>(entry->Size);
+    return true;
+  }
+
+  std::error_code error;
+  auto file_size = filesystem::file_size(path, error);
+  if (error) {
+    return false;
+  }
+
+  *size = static_cast<size_t>(file_size);
+  return true;
+}
+
+ReadBatch::~ReadBatch() {
+  for (auto& read : m_reads_) {
+    if (read->Unpacked.valid()) {
+      read->Unpacked.wait();
+    }
+
+    for (auto& chunk : read->Chunks) {
+      if (chunk.Issued) {
+        DWORD transferred;
+        GetOverlappedResult(read->File, &chunk.Overlapped, &transferred, TRUE);
+      }
+
+      if (chunk.Overlapped.hEvent != nullptr) {
+        CloseHandle(chunk.Overlapped.hEvent);
+      }
+    }
+
+    if (read->File != INVALID_HANDLE_VALUE) {
+      CloseHandle(read->File);
+    }
+  }
+}
+
+size_t ReadBatch::Add(const filesystem::path& path, uint8_t* buffer, size_t size) {
+  auto read = std::make_unique<Read>();
+  read->Path = path;
+  read->Buffer = buffer;
+  read->Size = size;
+
+  m_reads_.emplace_back(std::move(read));
+  return m_reads_.size() - 1;
+}
+
+void ReadBatch::IssueOverlapped(Read* read) {
+  read->File = CreateFileW(read->Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (read->File == INVALID_HANDLE_VALUE) {
+    return;
+  }
+
+  // Same rule as for packed files, the buffer has to match the whole file
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(read->File, &file_size) || static_cast<uint64_t>(file_size.QuadPart) != read->Size) {
+    return;
+  }
+
+  // Chunks are sized up front, the OVERLAPPED structures must not move while the reads are in flight
+  auto chunk_count = (read->Size + ReadChunkSize - 1) / ReadChunkSize;
+  read->Chunks.resize(chunk_count);
+
+  for (size_t i = 0; i < chunk_count; ++i) {
+    auto& chunk = read->Chunks[i];
+    auto offset = static_cast<uint64_t>(i) * ReadChunkSize;
+    chunk.Size = static_cast<DWORD>(std::min<uint64_t>(ReadChunkSize, read->Size - offset));
+    chunk.Overlapped.Offset = static_cast<DWORD>(offset);
+    chunk.Overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    chunk.Overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (chunk.Overlapped.hEvent == nullptr) {
+      return;
+    }
+
+    // Reads that complete right away still signal the event, Wait handles both the same way
+    if (!ReadFile(read->File, read->Buffer + offset, chunk.Size, nullptr, &chunk.Overlapped) && GetLastError() != ERROR_IO_PENDING) {
+      return;
+    }
+    chunk.Issued = true;
+  }
+
+  read->Issued = true;
+}
+
+void ReadBatch::Submit() {
+  if (m_submitted_) {
+    return;
+  }
+  m_submitted_ = true;
+
+  // Packed files are grouped per archive, the blocks of a group share the decompression workers
+  std::unordered_map<const PackArchive*, std::vector<Read*>> packed_reads;
+  std::unordered_map<const PackArchive*, std::vector<const PackFile::Entry*>> packed_entries;
+
+  for (auto& read : m_reads_) {
+    const PackArchive* archive;
+    const PackFile::Entry* entry;
+    if (FindPackedFile(read->Path, &archive, &entry)) {
+      if (entry->Size == read->Size) {
+        packed_reads[archive].emplace_back(read.get());
+        packed_entries[archive].emplace_back(entry);
+      }
+      continue;
+    }
+
+    IssueOverlapped(read.get());
+  }
+
+  for (auto& archive_reads : packed_reads) {
+    auto archive = archive_reads.first;
+    const auto& reads = archive_reads.second;
+
+    std::vector<uint8_t*> buffers;
+    for (auto read : reads) {
+      buffers.emplace_back(read->Buffer);
+    }
+
+    auto unpacked = std::async(std::launch::async, [archive, entries = std::move(packed_entries[archive]), buffers = std::move(buffers)]() {
+      return archive->Read(entries, buffers);
+    }).share();
+
+    for (auto read : reads) {
+      read->Unpacked = unpacked;
+      read->Issued = true;
+    }
+  }
+}
+
+bool ReadBatch::Wait(size_t index) {
+  auto& read = *m_reads_[index];
+  if (!read.Issued) {
+    return false;
+  }
+
+  if (read.Unpacked.valid()) {
+    return read.Unpacked.get();
+  }
+
+  bool read_ok = true;
+  for (auto& chunk : read.Chunks) {
+    DWORD transferred = 0;
+    if (!GetOverlappedResult(read.File, &chunk.Overlapped, &transferred, TRUE) || transferred != chunk.Size) {
+      read_ok = false;
+    }
+  }
+
+  return read_ok;
+}
+
+}  // namespace Core
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <Windows.h>
+
+#include "core/filesystem.h"
+
+namespace Core {
+
+// Size of the file in the mounted pack archives, or on disk when no archive holds it
+bool GetAssetFileSize(const filesystem::path& path, size_t* size);
+
+// Whole file reads into buffers the caller owns. Submit issues every read of the batch at once - loose files as
+// overlapped reads the OS queues and completes without a thread per read, files from mounted pack archives are
+// decompressed on workers - so each file can be decoded as soon as it lands while the rest are still in flight.
+class ReadBatch {
+public:
+  ReadBatch() = default;
+
+  // Waits for the reads still in flight, they write into the caller's buffers
+  ~ReadBatch();
+
+  ReadBatch(const ReadBatch& other) = delete;
+  ReadBatch& operator=(const ReadBatch& other) = delete;
+
+  // The buffer has to hold the size bytes of the file and outlive the batch. Returns the index to wait on.
+  size_t Add(const filesystem::path& path, uint8_t* buffer, size_t size);
+
+  void Submit();
+
+  // Blocks until the read is done, false when it failed. Any thread can wait on any read of a submitted batch.
+  bool Wait(size_t index);
+
+private:
+  struct Chunk {
+    OVERLAPPED Overlapped = {};
+    DWORD Size = 0;
+    bool Issued = false;
+  };
+
+  struct Read {
+    filesystem::path Path;
+    uint8_t* Buffer = nullptr;
+    size_t Size = 0;
+    bool Issued = false;  // Stays false when the read couldn't be started
+    HANDLE File = INVALID_HANDLE_VALUE;
+    std::vector<Chunk> Chunks;  // Loose files, one overlapped read per chunk
+    std::shared_future<bool> Unpacked;  // Packed files, shared by every read from the same archive
+  };
+
+  void IssueOverlapped(Read* read);
+
+  std::vector<std::unique_ptr<Read>> m_reads_;
+  bool m_submitted_ = false;
+};
+
+}  // namespace Core
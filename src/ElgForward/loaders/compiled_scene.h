@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Loaders {
+namespace CompiledScene {
+
+// Layout of the binary scenes written by CompileScene. Everything is stored as the loader uses it, so a mapped file
+// is read in place - sections start 16 byte aligned, matrices are ready for the transform table and
+// lights are kept as one array per attribute.
+
+const uint32_t Magic = 0x53474C45;  // "ELGS"
+const uint32_t Version = 2;
+
+const uint64_t SectionAlignment = 16;
+
+// Array of Count elements at Offset bytes from the start of the file
+struct Section {
+  uint64_t Offset;
+  uint64_t Count;
+};
+
+struct StringEntry {
+  uint32_t Offset;  // Into the string data section, strings are not null terminated
+  uint32_t Length;
+};
+
+const uint32_t DrawableHasTransform = 1;
+
+struct DrawableRecord {
+  uint32_t Name;  // String index
+  uint32_t Mesh;  // Index into the mesh name table
+  uint32_t Material;  // Index into the material name table
+  uint32_t Flags;
+};
+
+// File the scene was compiled from. A compiled scene is only loaded while every source still has the same contents.
+struct SourceRecord {
+  uint32_t Path;  // String index, relative to the base path unless the file is outside of it
+  uint32_t Reserved;
+  uint64_t Size;
+  uint64_t ContentHash;  // HashContents of the whole file
+};
+
+// Attributes a light type doesn't have are left empty
+struct LightArrays {
+  uint64_t Count;
+  Section Positions;  // DirectX::XMFLOAT4
+  Section Directions;  // DirectX::XMFLOAT4
+  Section DiffuseColors;  // DirectX::XMFLOAT4
+  Section SpecularColors;  // DirectX::XMFLOAT4
+  Section Ranges;  // float
+  Section Angles;  // float
+  Section Intensities;  // float
+  Section Enabled;  // uint8_t
+};
+
+struct Header {
+  uint32_t Magic;
+  uint32_t Version;
+  uint64_t FileSize;
+  Section StringData;  // char
+  Section Strings;  // StringEntry
+  Section MeshNames;  // uint32_t string index
+  Section MaterialNames;  // uint32_t string index
+  Section Drawables;  // DrawableRecord
+  Section Transforms;  // Rendering::Transform::TransformAndInverseTranspose, one per drawable
+  LightArrays DirectionalLights;
+  LightArrays SpotLights;
+  LightArrays PointLights;
+  Section Resources;  // char - JSON with the meshes, materials, textures and camera entries of the scene
+  Section Sources;  // SourceRecord - the scene file, then the lights and textures files it embeds
+};
+
+// FNV-1a, stable across builds so a compiled scene can be checked against its sources on any machine
+inline uint64_t HashContents(const uint8_t* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+// Returns nullptr when the section doesn't fit the file or isn't aligned for T
+template <typename T>
+const T* GetSection(const uint8_t* data, size_t size, const Section& section) {
+  if (section.Count == 0) {
+    return reinterpret_cast<const T*>(data);
+  }
+
+  bool is_valid = section.Offset % alignof(T) == 0
+               && section.Offset <= size
+               && section.Count <= (size - section.Offset) / sizeof(T);
+  if (!is_valid) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<const T*>(data + section.Offset);
+}
+
+}  // namespace CompiledScene
+}  // namespace Loaders
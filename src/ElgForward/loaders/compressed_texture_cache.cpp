@@ -0,0 +1,116 @@
+#include "compressed_texture_cache.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+
+#include "core/hash.h"
+#include "rendering/block_compression.h"
+
+namespace Loaders {
+
+const uint32_t CacheMagic = 0x43544C45;  // "ELTC"
+const uint32_t CacheVersion = 1;  // Bump when the encoder output changes
+
+size_t GetCompressedTextureKey(const std::vector<std::vector<uint8_t>>& sources, const std::string& settings) {
+  size_t seed = 0;
+
+  for (const auto& source : sources) {
+    hash_combine(seed, std::string_view(reinterpret_cast<const char*>(source.data()), source.size()));
+  }
+
+  hash_combine(seed, settings);
+  hash_combine(seed, CacheVersion);
+
+  return seed;
+}
+
+filesystem::path GetCompressedTexturePath(size_t key, const filesystem::path& cache_path) {
+  std::stringstream filename;
+  filename << std::hex << std::setw(sizeof(size_t) * 2) << std::setfill('0') << key << ".bct";
+  return cache_path / filename.str();
+}
+
+template<typename T>
+bool Read(std::ifstream& stream, T* value) {
+  stream.read(reinterpret_cast<char*>(value), sizeof(T));
+  return static_cast<bool>(stream);
+}
+
+template<typename T>
+void Write(std::ofstream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool ReadCompressedTexture(const filesystem::path& path, size_t key, CompressedTexture* texture) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t stored_key;
+  if (!Read(stream, &magic) || !Read(stream, &version) || !Read(stream, &stored_key)) {
+    return false;
+  }
+
+  if (magic != CacheMagic || version != CacheVersion || stored_key != key) {
+    return false;
+  }
+
+  CompressedTexture result;
+  uint32_t level_count;
+  if (!Read(stream, &result.Format) || !Read(stream, &level_count)) {
+    return false;
+  }
+
+  if (!Rendering::BlockCompression::IsBlockCompressed(result.Format)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < level_count; ++i) {
+    CompressedTextureLevel level;
+    if (!Read(stream, &level.Width) || !Read(stream, &level.Height)) {
+      return false;
+    }
+
+    level.Data.resize(Rendering::BlockCompression::GetEncodedSize(result.Format, level.Width, level.Height));
+    stream.read(reinterpret_cast<char*>(level.Data.data()), level.Data.size());
+    if (!stream) {
+      return false;
+    }
+
+    result.Levels.emplace_back(std::move(level));
+  }
+
+  *texture = std::move(result);
+  return true;
+}
+
+bool WriteCompressedTexture(const filesystem::path& path, size_t key, const CompressedTexture& texture) {
+  std::error_code error;
+  filesystem::create_directories(path.parent_path(), error);
+
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    return false;
+  }
+
+  Write(stream, CacheMagic);
+  Write(stream, CacheVersion);
+  Write(stream, static_cast<uint64_t>(key));
+  Write(stream, texture.Format);
+  Write(stream, static_cast<uint32_t>(texture.Levels.size()));
+
+  for (const auto& level : texture.Levels) {
+    Write(stream, level.Width);
+    Write(stream, level.Height);
+    stream.write(reinterpret_cast<const char*>(level.Data.data()), level.Data.size());
+  }
+
+  return static_cast<bool>(stream);
+}
+
+}  // namespace Loaders
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "core/filesystem.h"
+
+namespace Loaders {
+
+struct CompressedTextureLevel {
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  std::vector<uint8_t> Data = {};
+};
+
+struct CompressedTexture {
+  DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+  std::vector<CompressedTextureLevel> Levels = {};
+};
+
+// Content based key - covers the source image files, the requested compression and mip settings and the encoder version
+size_t GetCompressedTextureKey(const std::vector<std::vector<uint8_t>>& sources, const std::string& settings);
+
+filesystem::path GetCompressedTexturePath(size_t key, const filesystem::path& cache_path);
+
+// Fails when the file is missing, malformed or was written for a different key
+bool ReadCompressedTexture(const filesystem::path& path, size_t key, CompressedTexture* texture);
+
+bool WriteCompressedTexture(const filesystem::path& path, size_t key, const CompressedTexture& texture);
+
+}  // namespace Loaders
@@ -1,5 +1,7 @@
 #include "light_loader.h"
 
+#include <vector>
+
 #pragma warning(push)
 #pragma warning(disable: 4706)
 #include <nlohmann/json.hpp>
@@ -7,9 +9,8 @@
 
 #include <dxfw/dxfw.h>
 
-#include "core/json_helpers.h"
 #include "core/filesystem.h"
-#include "rendering/typed_structured_buffer.h"
+#include "core/json_stream.h"
 #include "rendering/lights/directional_light.h"
 #include "rendering/lights/point_light.h"
 #include "rendering/lights/spot_light.h"
@@ -18,186 +19,235 @@ using namespace Rendering;
 
 namespace Loaders {
 
-bool ReadDirectionalLight(const nlohmann::json& json_light, Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::DirectionalLight> directional_lights) {
-  Rendering::Lights::DirectionalLight directional_light;
-
-  float direction[3];
-  if (!Core::ReadFloat3(json_light["direction"], direction)) {
-    return false;
+// Collects the values of one lights entry, whether it comes from a parsed document or straight from the file
+class LightReader : public Core::JsonRecordVisitor {
+ public:
+  LightReader(std::vector<Rendering::Lights::DirectionalLight>* directional_lights,
+              std::vector<Rendering::Lights::SpotLight>* spot_lights,
+              std::vector<Rendering::Lights::PointLight>* point_lights)
+      : m_directional_lights_(directional_lights), m_spot_lights_(spot_lights), m_point_lights_(point_lights) {
+  }
+
+  void BeginRecord() override {
+    m_is_object_ = true;
+    m_has_type_ = false;
+    m_position_.Reset();
+    m_direction_.Reset();
+    m_diffuse_.Reset();
+    m_specular_.Reset();
+    m_angle_.Reset();
+    m_range_.Reset();
+    m_intensity_.Reset();
+    m_has_enabled_ = false;
+  }
+
+  void Value(const std::string& path, int32_t index, const Core::JsonStreamValue& value) override {
+    if (path.empty()) {
+      m_is_object_ = false;
+    } else if (path == "type") {
+      m_has_type_ = value.ValueType == Core::JsonStreamValue::Type::String;
+      if (m_has_type_) {
+        m_type_ = *value.String;
+      }
+    } else if (path == "position") {
+      m_position_.Read(index, value);
+    } else if (path == "direction") {
+      m_direction_.Read(index, value);
+    } else if (path == "diffuse") {
+      m_diffuse_.Read(index, value);
+    } else if (path == "specular") {
+      m_specular_.Read(index, value);
+    } else if (path == "angle") {
+      m_angle_.Read(index, value);
+    } else if (path == "range") {
+      m_range_.Read(index, value);
+    } else if (path == "intensity") {
+      m_intensity_.Read(index, value);
+    } else if (path == "enabled") {
+      m_has_enabled_ = value.ValueType == Core::JsonStreamValue::Type::Boolean;
+      m_enabled_ = value.Boolean;
+    }
   }
-  directional_light.DirectionWorldSpace = DirectX::XMVectorSet(direction[0], direction[1], direction[2], 0.0f);
 
-  float diffuse[4];
-  if (Core::ReadFloat4(json_light["diffuse"], diffuse)) {
-    directional_light.DiffuseColor = DirectX::XMVectorSet(diffuse[0], diffuse[1], diffuse[2], diffuse[3]);
-  }
+  void EndRecord() override {
+    auto entry_index = m_entry_index_++;
 
-  float specular[4];
-  if (Core::ReadFloat4(json_light["specular"], specular)) {
-    directional_light.SpecularColor = DirectX::XMVectorSet(specular[0], specular[1], specular[2], specular[3]);
-  }
+    if (!m_is_object_) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid lights entry %d", entry_index);
+      return;
+    }
 
-  float intensity;
-  if (Core::ReadFloat(json_light["intensity"], &intensity)) {
-    directional_light.Intensity = intensity;
-  }
+    if (!m_has_type_) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid light type in lights entry %d", entry_index);
+      return;
+    }
 
-  bool enabled;
-  if (Core::ReadBool(json_light["enabled"], &enabled)) {
-    directional_light.Enabled = enabled;
-  }
+    if (m_type_ == "directional") {
+      if (!AddDirectionalLight()) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Invalid directional light entry %d", entry_index);
+      }
+      return;
+    }
 
-  return StructuredBuffer::Add(directional_lights, &directional_light);
-}
+    if (m_type_ == "spot") {
+      if (!AddSpotLight()) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Invalid spot light entry %d", entry_index);
+      }
+      return;
+    }
 
-bool ReadSpotLight(const nlohmann::json& json_light, Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::SpotLight> spot_lights) {
-  Rendering::Lights::SpotLight spot_light;
+    if (m_type_ == "point") {
+      if (!AddPointLight()) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Invalid point light entry %d", entry_index);
+      }
+      return;
+    }
 
-  float position[3];
-  if (!Core::ReadFloat3(json_light["position"], position)) {
-    return false;
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid light type %S", m_type_.c_str());
   }
-  spot_light.PositionWorldSpace = DirectX::XMVectorSet(position[0], position[1], position[2], 1.0f);
 
-  float direction[3];
-  if (!Core::ReadFloat3(json_light["direction"], direction)) {
-    return false;
-  }
-  spot_light.DirectionWorldSpace = DirectX::XMVectorSet(direction[0], direction[1], direction[2], 0.0f);
+ private:
+  template <typename Light>
+  void ReadColorsAndIntensity(Light* light) {
+    if (m_diffuse_.HasSize(4)) {
+      const auto* diffuse = m_diffuse_.Values;
+      light->DiffuseColor = DirectX::XMVectorSet(diffuse[0], diffuse[1], diffuse[2], diffuse[3]);
+    }
 
-  float diffuse[4];
-  if (Core::ReadFloat4(json_light["diffuse"], diffuse)) {
-    spot_light.DiffuseColor = DirectX::XMVectorSet(diffuse[0], diffuse[1], diffuse[2], diffuse[3]);
-  }
+    if (m_specular_.HasSize(4)) {
+      const auto* specular = m_specular_.Values;
+      light->SpecularColor = DirectX::XMVectorSet(specular[0], specular[1], specular[2], specular[3]);
+    }
 
-  float specular[4];
-  if (Core::ReadFloat4(json_light["specular"], specular)) {
-    spot_light.SpecularColor = DirectX::XMVectorSet(specular[0], specular[1], specular[2], specular[3]);
-  }
+    if (m_intensity_.HasSize(1)) {
+      light->Intensity = m_intensity_.Values[0];
+    }
 
-  float angle;
-  if (Core::ReadFloat(json_light["angle"], &angle)) {
-    spot_light.SpotlightAngle = angle;
+    if (m_has_enabled_) {
+      light->Enabled = m_enabled_;
+    }
   }
 
-  float range;
-  if (Core::ReadFloat(json_light["range"], &range)) {
-    spot_light.Range = range;
-  }
+  bool AddDirectionalLight() {
+    Rendering::Lights::DirectionalLight directional_light;
 
-  float intensity;
-  if (Core::ReadFloat(json_light["intensity"], &intensity)) {
-    spot_light.Intensity = intensity;
-  }
+    if (!m_direction_.HasSize(3)) {
+      return false;
+    }
+    const auto* direction = m_direction_.Values;
+    directional_light.DirectionWorldSpace = DirectX::XMVectorSet(direction[0], direction[1], direction[2], 0.0f);
 
-  bool enabled;
-  if (Core::ReadBool(json_light["enabled"], &enabled)) {
-    spot_light.Enabled = enabled;
+    ReadColorsAndIntensity(&directional_light);
+
+    m_directional_lights_->emplace_back(directional_light);
+    return true;
   }
 
-  return StructuredBuffer::Add(spot_lights, &spot_light);
-}
+  bool AddSpotLight() {
+    Rendering::Lights::SpotLight spot_light;
 
-bool ReadPointLight(const nlohmann::json& json_light, Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::PointLight> point_lights) {
-  Rendering::Lights::PointLight point_light;
+    if (!m_position_.HasSize(3)) {
+      return false;
+    }
+    const auto* position = m_position_.Values;
+    spot_light.PositionWorldSpace = DirectX::XMVectorSet(position[0], position[1], position[2], 1.0f);
 
-  float position[3];
-  if (!Core::ReadFloat3(json_light["position"], position)) {
-    return false;
-  }
-  point_light.PositionWorldSpace = DirectX::XMVectorSet(position[0], position[1], position[2], 1.0f);
+    if (!m_direction_.HasSize(3)) {
+      return false;
+    }
+    const auto* direction = m_direction_.Values;
+    spot_light.DirectionWorldSpace = DirectX::XMVectorSet(direction[0], direction[1], direction[2], 0.0f);
 
-  float diffuse[4];
-  if (Core::ReadFloat4(json_light["diffuse"], diffuse)) {
-    point_light.DiffuseColor = DirectX::XMVectorSet(diffuse[0], diffuse[1], diffuse[2], diffuse[3]);
-  }
+    if (m_angle_.HasSize(1)) {
+      spot_light.SpotlightAngle = m_angle_.Values[0];
+    }
 
-  float specular[4];
-  if (Core::ReadFloat4(json_light["specular"], specular)) {
-    point_light.SpecularColor = DirectX::XMVectorSet(specular[0], specular[1], specular[2], specular[3]);
-  }
+    if (m_range_.HasSize(1)) {
+      spot_light.Range = m_range_.Values[0];
+    }
 
-  float range;
-  if (Core::ReadFloat(json_light["range"], &range)) {
-    point_light.Range = range;
-  }
+    ReadColorsAndIntensity(&spot_light);
 
-  float intensity;
-  if (Core::ReadFloat(json_light["intensity"], &intensity)) {
-    point_light.Intensity = intensity;
+    m_spot_lights_->emplace_back(spot_light);
+    return true;
   }
 
-  bool enabled;
-  if (Core::ReadBool(json_light["enabled"], &enabled)) {
-    point_light.Enabled = enabled;
+  bool AddPointLight() {
+    Rendering::Lights::PointLight point_light;
+
+    if (!m_position_.HasSize(3)) {
+      return false;
+    }
+    const auto* position = m_position_.Values;
+    point_light.PositionWorldSpace = DirectX::XMVectorSet(position[0], position[1], position[2], 1.0f);
+
+    if (m_range_.HasSize(1)) {
+      point_light.Range = m_range_.Values[0];
+    }
+
+    ReadColorsAndIntensity(&point_light);
+
+    m_point_lights_->emplace_back(point_light);
+    return true;
   }
 
-  return StructuredBuffer::Add(point_lights, &point_light);
-}
+  std::vector<Rendering::Lights::DirectionalLight>* m_directional_lights_;
+  std::vector<Rendering::Lights::SpotLight>* m_spot_lights_;
+  std::vector<Rendering::Lights::PointLight>* m_point_lights_;
+
+  int32_t m_entry_index_ = 0;
+  bool m_is_object_ = true;
+  bool m_has_type_ = false;
+  std::string m_type_;
+  Core::JsonStreamFloats<3> m_position_;
+  Core::JsonStreamFloats<3> m_direction_;
+  Core::JsonStreamFloats<4> m_diffuse_;
+  Core::JsonStreamFloats<4> m_specular_;
+  Core::JsonStreamFloats<1> m_angle_;
+  Core::JsonStreamFloats<1> m_range_;
+  Core::JsonStreamFloats<1> m_intensity_;
+  bool m_has_enabled_ = false;
+  bool m_enabled_ = false;
+};
 
 bool ReadLightsFromJson(const nlohmann::json& json_lights,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::DirectionalLight> directional_lights,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::SpotLight> spot_lights,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::PointLight> point_lights) {
+                        std::vector<Rendering::Lights::DirectionalLight>* directional_lights,
+                        std::vector<Rendering::Lights::SpotLight>* spot_lights,
+                        std::vector<Rendering::Lights::PointLight>* point_lights) {
   const auto& json_lights_array = json_lights["lights"];
   if (!json_lights_array.is_array()) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Invalid lights JSON %S", json_lights.dump().c_str());
     return false;
   }
 
+  LightReader reader(directional_lights, spot_lights, point_lights);
   for (const auto& json_light : json_lights_array) {
-    if (!json_light.is_object()) {
-      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid lights entry %S", json_light.dump().c_str());
-      continue;
-    }
-
-    const auto& json_light_type = json_light["type"];
-    if (!json_light_type.is_string()) {
-      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid light type %S", json_light_type.dump().c_str());
-      continue;
-    }
-
-    const std::string& light_type = json_light_type;
-    if (light_type == "directional") {
-      if (!ReadDirectionalLight(json_light, directional_lights)) {
-        DXFW_TRACE(__FILE__, __LINE__, false, "Reached max directional lights", "");
-      }
-      continue;
-    }
-
-    if (light_type == "spot") {
-      if (!ReadSpotLight(json_light, spot_lights)) {
-        DXFW_TRACE(__FILE__, __LINE__, false, "Reached max spot lights", "");
-      }
-      continue;
-    }
-
-    if (light_type == "point") {
-      if (!ReadPointLight(json_light, point_lights)) {
-        DXFW_TRACE(__FILE__, __LINE__, false, "Reached max point lights", "");
-      }
-      continue;
-    }
-
-    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid light type %S", light_type.c_str());
+    Core::VisitJsonRecord(json_light, &reader);
   }
 
   return true;
 }
 
 bool ReadLightsFromFile(const filesystem::path& lights_path,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::DirectionalLight> directional_lights,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::SpotLight> spot_lights,
-                        Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::PointLight> point_lights) {
+                        std::vector<Rendering::Lights::DirectionalLight>* directional_lights,
+                        std::vector<Rendering::Lights::SpotLight>* spot_lights,
+                        std::vector<Rendering::Lights::PointLight>* point_lights) {
+  // Light entries are read as the file is parsed, large light files never exist as a whole document
   nlohmann::json json_lights;
+  LightReader reader(directional_lights, spot_lights, point_lights);
 
-  bool load_ok = Core::ReadJsonFile(lights_path, &json_lights);
+  bool load_ok = Core::StreamJsonFile(lights_path, "lights", &reader, &json_lights);
   if (!load_ok) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Error reading lights file from %s", lights_path.string().c_str());
     return false;
   }
 
-  return ReadLightsFromJson(json_lights, directional_lights, spot_lights, point_lights);
+  if (!json_lights["lights"].is_array()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid lights JSON %S", json_lights.dump().c_str());
+    return false;
+  }
+
+  return true;
 }
 
 }  // namespace Loaders
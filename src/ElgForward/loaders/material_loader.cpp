@@ -8,7 +8,9 @@
 #include "core/filesystem.h"
 #include "core/json_helpers.h"
 #include "rendering/typed_constant_buffer.h"
+#include "rendering/typed_structured_buffer.h"
 #include "rendering/materials/basic.h"
+#include "rendering/shader_permutation.h"
 #include "rendering/dxgi_format_helper.h"
 #include "loaders/texture_loader.h"
 #include "shaders/registers.h"
@@ -29,6 +31,51 @@ bool MaterialTypeFromString(const std::string& type, MaterialType* value) {
   return false;
 }
 
+bool LightingToBasicPixelShader(const std::string& lighting, std::string* ps_filename) {
+  if (lighting == "forward") {
+    *ps_filename = "basic_ps.hlsl";
+    return true;
+  }
+  if (lighting == "clustered") {
+    *ps_filename = "basic_clustered_ps.hlsl";
+    return true;
+  }
+  if (lighting == "per_object") {
+    *ps_filename = "basic_object_lights_ps.hlsl";
+    return true;
+  }
+  return false;
+}
+
+// "table" packs the material parameters into the per type material table instead of a constant buffer
+bool UseMaterialTableFromString(const std::string& parameters, bool* result) {
+  if (parameters == "constant_buffer") {
+    *result = false;
+    return true;
+  }
+  if (parameters == "table") {
+    *result = true;
+    return true;
+  }
+  return false;
+}
+
+bool CullModeFromString(const std::string& cull_mode, D3D11_CULL_MODE* result) {
+  if (cull_mode == "none") {
+    *result = D3D11_CULL_NONE;
+    return true;
+  }
+  if (cull_mode == "front") {
+    *result = D3D11_CULL_FRONT;
+    return true;
+  }
+  if (cull_mode == "back") {
+    *result = D3D11_CULL_BACK;
+    return true;
+  }
+  return false;
+}
+
 bool IsTextureCompatible(const Rendering::ShaderReflection::TexureDescription& description, const TextureIdentifier& identifier) {
   if (description.BindSlotCount != Rendering::Texture::GetSlotCount(identifier.Texture)) {
     return false;
@@ -51,40 +98,52 @@ bool IsTextureCompatible(const Rendering::ShaderReflection::TexureDescription& d
 }
 
 template<typename T>
-void FillInTextures(const T& shader_data, const std::vector<TextureIdentifier>& textures,
+void FillInTextures(const T& shader_data, const TextureIndex& textures,
                     const std::unordered_map<size_t, uint32_t>& texture_to_slot_map,
                     std::array<Rendering::Texture::Handle, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>* material_textures) {
-  auto hasher = std::hash<std::string>();
+  if (texture_to_slot_map.empty()) {
+    return;
+  }
+
+  // Reflected texture covering each register
+  std::array<const Rendering::ShaderReflection::TexureDescription*, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> slot_descriptions = {};
+  for (auto it = shader_data.ReflectionData.Texures.rbegin(); it != shader_data.ReflectionData.Texures.rend(); ++it) {
+    for (auto i = it->BindSlotStart; i < it->BindSlotStart + it->BindSlotCount && i < slot_descriptions.size(); ++i) {
+      slot_descriptions[i] = &*it;
+    }
+  }
 
   for (const auto& mapping_entry : texture_to_slot_map) {
     auto texture_register = mapping_entry.second;
-    auto texture_desc_it = std::find_if(std::begin(shader_data.ReflectionData.Texures), std::end(shader_data.ReflectionData.Texures), [texture_register](const auto& description) {
-      return (description.BindSlotStart <= texture_register) && (texture_register < description.BindSlotStart + description.BindSlotCount);
-    });
-      
-    auto name_hash = mapping_entry.first;
-    auto texture_identifier_it = std::find_if(std::begin(textures), std::end(textures), [name_hash](const auto& identifier) {
-      return identifier.Hash == name_hash;
-    });
-
-    if (texture_desc_it != std::end(shader_data.ReflectionData.Texures) &&
-        texture_identifier_it != std::end(textures) &&
-        IsTextureCompatible(*texture_desc_it, *texture_identifier_it)) {
-      for (auto i = texture_desc_it->BindSlotStart; i < texture_desc_it->BindSlotStart + texture_desc_it->BindSlotCount; ++i) {
-        material_textures->at(i) = texture_identifier_it->Texture;
+    if (texture_register >= slot_descriptions.size() || slot_descriptions[texture_register] == nullptr) {
+      continue;
+    }
+    const auto& texture_desc = *slot_descriptions[texture_register];
+
+    auto texture_identifier_it = textures.find(mapping_entry.first);
+    if (texture_identifier_it == std::end(textures)) {
+      continue;
+    }
+    const auto& texture_identifier = *texture_identifier_it->second;
+
+    if (IsTextureCompatible(texture_desc, texture_identifier)) {
+      for (auto i = texture_desc.BindSlotStart; i < texture_desc.BindSlotStart + texture_desc.BindSlotCount; ++i) {
+        material_textures->at(i) = texture_identifier.Texture;
       }
     }
   }
 }
 
 template<typename T>
-bool CreateMaterial(const std::string& id, const filesystem::path& vs_path, const filesystem::path& ps_path, T* data,
+bool CreateMaterial(const std::string& id, const Rendering::ShaderPermutation::Permutation& vs_permutation,
+                    const Rendering::ShaderPermutation::Permutation& ps_permutation, const filesystem::path& shader_cache_path, T* data,
                     const std::unordered_map<size_t, uint32_t>& vs_texture_to_slot_map,
                     const std::unordered_map<size_t, uint32_t>& ps_texture_to_slot_map,
-                    const std::vector<TextureIdentifier>& textures, ID3D11Device* device, MaterialIdentifier* material) {
+                    const TextureIndex& textures, ID3D11Device* device, MaterialIdentifier* material) {
   material->Hash = std::hash<std::string>()(id);
+  material->Name = id;
 
-  material->Material.VertexShader = Rendering::VertexShader::Create(vs_path, std::unordered_map<std::string, Rendering::VertexDataChannel>(), device);
+  material->Material.VertexShader = Rendering::VertexShader::Create(vs_permutation, shader_cache_path, std::unordered_map<std::string, Rendering::VertexDataChannel>(), device);
   if (!material->Material.VertexShader.IsValid()) {
     return false;
   }
@@ -92,7 +151,7 @@ bool CreateMaterial(const std::string& id, const filesystem::path& vs_path, cons
   auto vs_shader_data = Rendering::VertexShader::Retreive(material->Material.VertexShader);
   FillInTextures(*vs_shader_data, textures, vs_texture_to_slot_map, &material->Material.VertexShaderTextures);
 
-  material->Material.PixelShader = Rendering::PixelShader::Create(ps_path, device);
+  material->Material.PixelShader = Rendering::PixelShader::Create(ps_permutation, shader_cache_path, device);
   if (!material->Material.PixelShader.IsValid()) {
     return false;
   }
@@ -109,12 +168,34 @@ bool CreateMaterial(const std::string& id, const filesystem::path& vs_path, cons
 }
 
 bool ReadBasicMaterial(const nlohmann::json& json_material, const filesystem::path& base_path,
-                       const std::vector<TextureIdentifier>& textures, ID3D11Device* device,
+                       const TextureIndex& textures, ID3D11Device* device,
                        MaterialIdentifier* material) {
   const std::string& name = json_material["name"];
 
-  auto vs_path = base_path / "basic_vs.cso";
-  auto ps_path = base_path / "basic_ps.cso";
+  std::string lighting = json_material.value("lighting", "forward");
+  std::string ps_filename;
+  if (!LightingToBasicPixelShader(lighting, &ps_filename)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unknown lighting %S for material %S", lighting.c_str(), name.c_str());
+    return false;
+  }
+
+  std::string parameters = json_material.value("parameters", "constant_buffer");
+  bool use_material_table;
+  if (!UseMaterialTableFromString(parameters, &use_material_table)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unknown parameters mode %S for material %S", parameters.c_str(), name.c_str());
+    return false;
+  }
+
+  auto shader_path = base_path / "shaders";
+  auto shader_cache_path = base_path / "shader_cache";
+
+  Rendering::ShaderPermutation::Permutation vs_permutation;
+  vs_permutation.SourcePath = shader_path / "basic_vs.hlsl";
+  vs_permutation.Target = "vs_5_0";
+
+  Rendering::ShaderPermutation::Permutation ps_permutation;
+  ps_permutation.SourcePath = shader_path / ps_filename;
+  ps_permutation.Target = "ps_5_0";
 
   Rendering::Materials::Basic basic_material;
   std::unordered_map<size_t, uint32_t> vs_texture_to_slot_map;
@@ -135,18 +216,70 @@ bool ReadBasicMaterial(const nlohmann::json& json_material, const filesystem::pa
     basic_material.SpecularPower = specular_power;
   }
 
+  bool diffuse_texture_array = false;
   std::string diffuse_texture = json_material.value("diffuse_texture", "");
   if (!diffuse_texture.empty()) {
+    auto diffuse_texture_hash = std::hash<std::string>()(diffuse_texture);
     basic_material.HasDiffuseTexture = true;
-    ps_texture_to_slot_map[std::hash<std::string>()(diffuse_texture)] = DIFFUSE_TEXTURE_REGISTER;
+    ps_texture_to_slot_map[diffuse_texture_hash] = DIFFUSE_TEXTURE_REGISTER;
+
+    auto texture_identifier_it = textures.find(diffuse_texture_hash);
+    if (texture_identifier_it != std::end(textures)) {
+      const auto& texture_identifier = *texture_identifier_it->second;
+      diffuse_texture_array = Rendering::Texture::GetType(texture_identifier.Texture) == Rendering::Texture::Type::DIM_2_ARRAY;
+      basic_material.DiffuseTextureLayer = texture_identifier.Layer;
+      basic_material.DiffuseTextureUvScaleOffset = DirectX::XMLoadFloat4(&texture_identifier.UvScaleOffset);
+    }
+  }
+  ps_permutation.Defines["HAS_DIFFUSE_TEXTURE"] = basic_material.HasDiffuseTexture ? "1" : "0";
+  ps_permutation.Defines["DIFFUSE_TEXTURE_ARRAY"] = diffuse_texture_array ? "1" : "0";
+  ps_permutation.Defines["MATERIAL_TABLE"] = use_material_table ? "1" : "0";
+
+  bool material_ok = CreateMaterial(name, vs_permutation, ps_permutation, shader_cache_path, &basic_material, vs_texture_to_slot_map, ps_texture_to_slot_map,
+                                    textures, device, material);
+  if (!material_ok) {
+    return false;
+  }
+
+  if (use_material_table) {
+    auto material_table = Rendering::StructuredBuffer::Create<Rendering::Materials::GpuBasic>(Rendering::Materials::BasicMaterialTableName,
+                                                                                             Rendering::Materials::MaxBasicMaterials,
+                                                                                             nullptr, 0, device);
+    if (!material_table.IsValid()) {
+      return false;
+    }
+
+    auto gpu_material = Rendering::Materials::Pack(basic_material);
+    auto table_index = static_cast<uint32_t>(Rendering::StructuredBuffer::GetCurrentSize(material_table));
+    if (!Rendering::StructuredBuffer::Add(material_table, &gpu_material)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Material table is full, can't add material %S", name.c_str());
+      return false;
+    }
+
+    material->Material.TableIndex = table_index;
+  }
+
+  std::string cull_mode = json_material.value("cull_mode", "back");
+  if (!CullModeFromString(cull_mode, &material->Material.RasterizerState.CullMode)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unknown cull mode %S for material %S", cull_mode.c_str(), name.c_str());
+    return false;
   }
 
-  return CreateMaterial(name, vs_path, ps_path, &basic_material, vs_texture_to_slot_map, ps_texture_to_slot_map,
-                        textures, device, material);
+  bool alpha_blend = false;
+  Core::ReadBool(json_material.value("alpha_blend", nlohmann::json(false)), &alpha_blend);
+  if (alpha_blend) {
+    auto& render_target_blend = material->Material.BlendState.RenderTarget[0];
+    render_target_blend.BlendEnable = TRUE;
+    render_target_blend.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+    render_target_blend.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+    render_target_blend.BlendOp = D3D11_BLEND_OP_ADD;
+  }
+
+  return true;
 }
 
 bool ReadMaterial(const nlohmann::json& json_material, const filesystem::path& base_path,
-                  const std::vector<TextureIdentifier>& textures, ID3D11Device* device,
+                  const TextureIndex& textures, ID3D11Device* device,
                   MaterialIdentifier* material) {
   bool is_valid_material_entry = json_material["name"].is_string()
                               && json_material["type"].is_string();
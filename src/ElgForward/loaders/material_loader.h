@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #pragma warning(push)
 #pragma warning(disable: 4706)
 #include <nlohmann/json.hpp>
@@ -14,11 +16,12 @@ namespace Loaders {
 
 struct MaterialIdentifier {
   size_t Hash;
+  std::string Name;
   Rendering::Material::Material Material;
 };
 
 bool ReadMaterial(const nlohmann::json& json_material, const filesystem::path& base_path,
-                  const std::vector<TextureIdentifier>& identifiers, ID3D11Device* device,
+                  const TextureIndex& textures, ID3D11Device* device,
                   MaterialIdentifier* material);
 
 }  // namespace Loaders
@@ -1,14 +1,18 @@
 #include "mesh_loader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <memory>
 
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 
 #pragma warning(push)
 #pragma warning(disable: 4201)
 #pragma warning(disable: 4305)
+#include <assimp/cfileio.h>
 #include <assimp/cimport.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -21,6 +25,7 @@
 
 #include <dxfw/dxfw.h>
 
+#include "core/asset_file.h"
 #include "core/filesystem.h"
 #include "core/hash.h"
 #include "core/resource_array.h"
@@ -67,6 +72,97 @@ public:
   }
 };
 
+// Lets assimp open the mesh and everything it references, like .mtl files, through the mounted pack archives
+struct AiAssetFile {
+  Core::AssetFile File;
+  size_t Position = 0;
+};
+
+AiAssetFile* GetAssetFile(aiFile* file) {
+  return reinterpret_cast<AiAssetFile*>(file->UserData);
+}
+
+size_t AiAssetFileRead(aiFile* file, char* buffer, size_t size, size_t count) {
+  auto asset_file = GetAssetFile(file);
+  if (size == 0) {
+    return 0;
+  }
+
+  auto read_count = std::min(count, (asset_file->File.GetSize() - asset_file->Position) / size);
+  std::memcpy(buffer, asset_file->File.GetData() + asset_file->Position, read_count * size);
+  asset_file->Position += read_count * size;
+  return read_count;
+}
+
+size_t AiAssetFileWrite(aiFile*, const char*, size_t, size_t) {
+  return 0;
+}
+
+size_t AiAssetFileTell(aiFile* file) {
+  return GetAssetFile(file)->Position;
+}
+
+size_t AiAssetFileSize(aiFile* file) {
+  return GetAssetFile(file)->File.GetSize();
+}
+
+// Backward seeks arrive as wrapped around offsets, so the unsigned sum lands on the right position
+aiReturn AiAssetFileSeek(aiFile* file, size_t offset, aiOrigin origin) {
+  auto asset_file = GetAssetFile(file);
+  auto size = asset_file->File.GetSize();
+
+  size_t position;
+  switch (origin) {
+    case aiOrigin_SET:
+      position = offset;
+      break;
+    case aiOrigin_CUR:
+      position = asset_file->Position + offset;
+      break;
+    case aiOrigin_END:
+      position = size + offset;
+      break;
+    default:
+      return aiReturn_FAILURE;
+  }
+
+  if (position > size) {
+    return aiReturn_FAILURE;
+  }
+
+  asset_file->Position = position;
+  return aiReturn_SUCCESS;
+}
+
+void AiAssetFileFlush(aiFile*) {
+}
+
+aiFile* AiAssetFileOpen(aiFileIO*, const char* path, const char* mode) {
+  if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr) {
+    return nullptr;
+  }
+
+  auto asset_file = std::make_unique<AiAssetFile>();
+  if (!asset_file->File.Open(path)) {
+    return nullptr;
+  }
+
+  auto file = new aiFile();
+  file->ReadProc = AiAssetFileRead;
+  file->WriteProc = AiAssetFileWrite;
+  file->TellProc = AiAssetFileTell;
+  file->FileSizeProc = AiAssetFileSize;
+  file->SeekProc = AiAssetFileSeek;
+  file->FlushProc = AiAssetFileFlush;
+  file->UserData = reinterpret_cast<aiUserData>(asset_file.release());
+  return file;
+}
+
+void AiAssetFileClose(aiFileIO*, aiFile* file) {
+  delete GetAssetFile(file);
+  delete file;
+}
+
 template<typename T>
 bool AddVertexBufferToMesh(size_t hash, const std::vector<T>& data, DXGI_FORMAT format, VertexDataChannel channel, ID3D11Device* device, Mesh::Mesh* mesh) {
   auto vb_handle = Rendering::VertexBuffer::Create(hash, data, device);
@@ -233,9 +329,14 @@ bool ReadMeshes(const std::string& prefix, const filesystem::path& path, const M
   AiLogStreamGuard log_stream_guard(aiGetPredefinedLogStream(aiDefaultLogStream_DEBUGGER, nullptr));
 
   std::string path_string = path.string();
-  std::unique_ptr<const aiScene, AiSceneDeleter> scene(aiImportFile(path_string.c_str(), aiProcessPreset_TargetRealtime_MaxQuality));
+  aiFileIO file_io;
+  file_io.OpenProc = AiAssetFileOpen;
+  file_io.CloseProc = AiAssetFileClose;
+  file_io.UserData = nullptr;
 
-  if (!scene->HasMeshes()) {
+  std::unique_ptr<const aiScene, AiSceneDeleter> scene(aiImportFileEx(path_string.c_str(), aiProcessPreset_TargetRealtime_MaxQuality, &file_io));
+
+  if (!scene || !scene->HasMeshes()) {
     return false;
   }
 
@@ -247,7 +348,7 @@ bool ReadMeshes(const std::string& prefix, const filesystem::path& path, const M
 
     auto cached_handle = Mesh::Exists(mesh_hash);
     if (cached_handle.IsValid()) {
-      identifiers->emplace_back(MeshIdentifier{ mesh_hash, cached_handle });
+      identifiers->emplace_back(MeshIdentifier{ mesh_hash, mesh_name, cached_handle });
       continue;
     }
 
@@ -265,6 +366,9 @@ bool ReadMeshes(const std::string& prefix, const filesystem::path& path, const M
       if (!prep_ok) {
         return false;
       }
+
+      static_assert(sizeof(aiVector3D) == sizeof(DirectX::XMFLOAT3), "aiVector3D must be layout compatible with XMFLOAT3");
+      DirectX::BoundingSphere::CreateFromPoints(mesh->Bounds, vertex_count, reinterpret_cast<const DirectX::XMFLOAT3*>(imported_mesh->mVertices), sizeof(aiVector3D));
     }
 
     if (imported_mesh->HasNormals()) {
@@ -326,7 +430,7 @@ bool ReadMeshes(const std::string& prefix, const filesystem::path& path, const M
     }
 
     auto new_mesh_handle = Mesh::Create(mesh_hash, std::move(mesh));
-    identifiers->emplace_back(MeshIdentifier{ mesh_hash, new_mesh_handle });
+    identifiers->emplace_back(MeshIdentifier{ mesh_hash, mesh_name, new_mesh_handle });
   }
 
   return true;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <d3d11.h>
@@ -16,6 +17,7 @@ namespace Loaders {
 
 struct MeshIdentifier {
   size_t Hash;
+  std::string Name;
   Rendering::Mesh::Handle handle;
 };
 
@@ -0,0 +1,307 @@
+#include "scene_compiler.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#pragma warning(push)
+#pragma warning(disable: 4706)
+#include <nlohmann/json.hpp>
+#pragma warning(pop)
+
+#include <dxfw/dxfw.h>
+
+#include "core/asset_file.h"
+#include "core/json_helpers.h"
+#include "core/pack_file.h"
+#include "loaders/compiled_scene.h"
+#include "loaders/light_loader.h"
+#include "loaders/scene_file.h"
+#include "loaders/transform_loader.h"
+#include "rendering/transform_and_inverse_transpose.h"
+
+namespace Loaders {
+
+template <typename T>
+CompiledScene::Section AppendSection(const T* values, size_t count, std::vector<uint8_t>* output) {
+  auto offset = (output->size() + CompiledScene::SectionAlignment - 1) & ~(CompiledScene::SectionAlignment - 1);
+  output->resize(offset + count * sizeof(T), 0);
+  if (count > 0) {
+    std::memcpy(output->data() + offset, values, count * sizeof(T));
+  }
+
+  return { offset, count };
+}
+
+template <typename T>
+CompiledScene::Section AppendSection(const std::vector<T>& values, std::vector<uint8_t>* output) {
+  return AppendSection(values.data(), values.size(), output);
+}
+
+// Strings and name tables share one string pool, repeated strings are stored once
+class StringTable {
+ public:
+  uint32_t Add(const std::string& value) {
+    auto it = m_indices_.find(value);
+    if (it != m_indices_.end()) {
+      return it->second;
+    }
+
+    auto index = static_cast<uint32_t>(m_entries_.size());
+    m_entries_.push_back({ static_cast<uint32_t>(m_data_.size()), static_cast<uint32_t>(value.size()) });
+    m_data_.insert(m_data_.end(), value.begin(), value.end());
+    m_indices_.emplace(value, index);
+    return index;
+  }
+
+  const std::vector<char>& GetData() const {
+    return m_data_;
+  }
+
+  const std::vector<CompiledScene::StringEntry>& GetEntries() const {
+    return m_entries_;
+  }
+
+ private:
+  std::vector<char> m_data_;
+  std::vector<CompiledScene::StringEntry> m_entries_;
+  std::unordered_map<std::string, uint32_t> m_indices_;
+};
+
+// Index of a name in a mesh or material name table, names are added in order of first use
+uint32_t GetNameIndex(const std::string& name, StringTable* strings, std::vector<uint32_t>* names,
+                      std::unordered_map<std::string, uint32_t>* name_indices) {
+  auto it = name_indices->find(name);
+  if (it != name_indices->end()) {
+    return it->second;
+  }
+
+  auto index = static_cast<uint32_t>(names->size());
+  names->push_back(strings->Add(name));
+  name_indices->emplace(name, index);
+  return index;
+}
+
+// Sizes and hashes the files the scene was compiled from, they are read the same way the loader checks them later
+bool AddSources(const std::vector<filesystem::path>& source_paths, const filesystem::path& base_path, StringTable* strings,
+                std::vector<CompiledScene::SourceRecord>* sources) {
+  for (const auto& source_path : source_paths) {
+    Core::AssetFile file;
+    if (!file.Open(source_path)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading scene source %s", source_path.string().c_str());
+      return false;
+    }
+
+    filesystem::path relative_path;
+    if (!Core::PackFile::GetRelativePath(filesystem::absolute(source_path), filesystem::absolute(base_path), &relative_path)) {
+      relative_path = filesystem::absolute(source_path);
+    }
+
+    CompiledScene::SourceRecord source = {};
+    source.Path = strings->Add(relative_path.generic_string());
+    source.Size = file.GetSize();
+    source.ContentHash = CompiledScene::HashContents(file.GetData(), file.GetSize());
+    sources->push_back(source);
+  }
+
+  return true;
+}
+
+// One array per light attribute, the loader copies them into the light structures
+struct LightAttributes {
+  std::vector<DirectX::XMFLOAT4> Positions;
+  std::vector<DirectX::XMFLOAT4> Directions;
+  std::vector<DirectX::XMFLOAT4> DiffuseColors;
+  std::vector<DirectX::XMFLOAT4> SpecularColors;
+  std::vector<float> Ranges;
+  std::vector<float> Angles;
+  std::vector<float> Intensities;
+  std::vector<uint8_t> Enabled;
+
+  template <typename Light>
+  void AddColors(const Light& light) {
+    DirectX::XMFLOAT4 color;
+    DirectX::XMStoreFloat4(&color, light.DiffuseColor);
+    DiffuseColors.push_back(color);
+    DirectX::XMStoreFloat4(&color, light.SpecularColor);
+    SpecularColors.push_back(color);
+    Intensities.push_back(light.Intensity);
+    Enabled.push_back(light.Enabled ? 1 : 0);
+  }
+
+  static void Add(const DirectX::XMVECTOR& value, std::vector<DirectX::XMFLOAT4>* values) {
+    DirectX::XMFLOAT4 stored;
+    DirectX::XMStoreFloat4(&stored, value);
+    values->push_back(stored);
+  }
+
+  CompiledScene::LightArrays Append(size_t count, std::vector<uint8_t>* output) const {
+    CompiledScene::LightArrays arrays;
+    arrays.Count = count;
+    arrays.Positions = AppendSection(Positions, output);
+    arrays.Directions = AppendSection(Directions, output);
+    arrays.DiffuseColors = AppendSection(DiffuseColors, output);
+    arrays.SpecularColors = AppendSection(SpecularColors, output);
+    arrays.Ranges = AppendSection(Ranges, output);
+    arrays.Angles = AppendSection(Angles, output);
+    arrays.Intensities = AppendSection(Intensities, output);
+    arrays.Enabled = AppendSection(Enabled, output);
+    return arrays;
+  }
+};
+
+bool CompileLights(const nlohmann::json& json_scene, const filesystem::path& base_path, CompiledScene::Header* header,
+                   std::vector<uint8_t>* output, std::vector<filesystem::path>* source_paths) {
+  std::vector<Rendering::Lights::DirectionalLight> directional_lights;
+  std::vector<Rendering::Lights::SpotLight> spot_lights;
+  std::vector<Rendering::Lights::PointLight> point_lights;
+
+  auto lights_it = json_scene.find("lights");
+  if (lights_it != json_scene.end()) {
+    if (!lights_it->is_string()) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid lights entry [%S]", lights_it->dump().c_str());
+      return false;
+    }
+
+    const std::string& lights_relative_path = *lights_it;
+    auto lights_path = base_path / lights_relative_path;
+    if (!ReadLightsFromFile(lights_path, &directional_lights, &spot_lights, &point_lights)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading lights from %s", lights_path.string().c_str());
+      return false;
+    }
+
+    source_paths->push_back(lights_path);
+  }
+
+  LightAttributes directional_attributes;
+  for (const auto& light : directional_lights) {
+    LightAttributes::Add(light.DirectionWorldSpace, &directional_attributes.Directions);
+    directional_attributes.AddColors(light);
+  }
+  header->DirectionalLights = directional_attributes.Append(directional_lights.size(), output);
+
+  LightAttributes spot_attributes;
+  for (const auto& light : spot_lights) {
+    LightAttributes::Add(light.PositionWorldSpace, &spot_attributes.Positions);
+    LightAttributes::Add(light.DirectionWorldSpace, &spot_attributes.Directions);
+    spot_attributes.Angles.push_back(light.SpotlightAngle);
+    spot_attributes.Ranges.push_back(light.Range);
+    spot_attributes.AddColors(light);
+  }
+  header->SpotLights = spot_attributes.Append(spot_lights.size(), output);
+
+  LightAttributes point_attributes;
+  for (const auto& light : point_lights) {
+    LightAttributes::Add(light.PositionWorldSpace, &point_attributes.Positions);
+    point_attributes.Ranges.push_back(light.Range);
+    point_attributes.AddColors(light);
+  }
+  header->PointLights = point_attributes.Append(point_lights.size(), output);
+
+  return true;
+}
+
+bool CompileScene(const filesystem::path& scene_path, const filesystem::path& base_path, const filesystem::path& output_path) {
+  nlohmann::json json_scene;
+  std::vector<DrawableDescription> drawables;
+  if (!ReadSceneFile(scene_path, &json_scene, &drawables)) {
+    return false;
+  }
+
+  // The header is filled in last, everything else is appended behind it
+  CompiledScene::Header header = {};
+  header.Magic = CompiledScene::Magic;
+  header.Version = CompiledScene::Version;
+
+  std::vector<uint8_t> output(sizeof(CompiledScene::Header), 0);
+
+  std::vector<filesystem::path> source_paths = { scene_path };
+
+  // Drawables
+  StringTable strings;
+  std::vector<uint32_t> mesh_names;
+  std::vector<uint32_t> material_names;
+  std::unordered_map<std::string, uint32_t> mesh_indices;
+  std::unordered_map<std::string, uint32_t> material_indices;
+
+  std::vector<CompiledScene::DrawableRecord> records;
+  std::vector<Rendering::Transform::TransformAndInverseTranspose> transforms;
+  records.reserve(drawables.size());
+  transforms.reserve(drawables.size());
+
+  for (const auto& drawable : drawables) {
+    CompiledScene::DrawableRecord record;
+    record.Name = strings.Add(drawable.Name);
+    record.Mesh = GetNameIndex(drawable.MeshName, &strings, &mesh_names, &mesh_indices);
+    record.Material = GetNameIndex(drawable.MaterialName, &strings, &material_names, &material_indices);
+    record.Flags = drawable.HasTransform ? CompiledScene::DrawableHasTransform : 0;
+    records.push_back(record);
+
+    transforms.push_back(ComputeTransform(drawable.Transform));
+  }
+
+  header.Drawables = AppendSection(records, &output);
+  header.Transforms = AppendSection(transforms, &output);
+  header.MeshNames = AppendSection(mesh_names, &output);
+  header.MaterialNames = AppendSection(material_names, &output);
+
+  // Lights
+  if (!CompileLights(json_scene, base_path, &header, &output, &source_paths)) {
+    return false;
+  }
+
+  // Meshes, materials and the camera stay JSON, with the textures document pulled in so loading opens a single file
+  json_scene.erase("scene");
+  json_scene.erase("lights");
+
+  auto textures_it = json_scene.find("textures");
+  if (textures_it != json_scene.end() && textures_it->is_string()) {
+    const std::string& textures_relative_path = *textures_it;
+    auto textures_path = base_path / textures_relative_path;
+
+    nlohmann::json json_textures;
+    if (!Core::ReadJsonFile(textures_path, &json_textures)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading textures file from %s", textures_path.string().c_str());
+      return false;
+    }
+    *textures_it = std::move(json_textures);
+
+    source_paths.push_back(textures_path);
+  }
+
+  auto resources = json_scene.dump();
+  header.Resources = AppendSection(resources.data(), resources.size(), &output);
+
+  // Sources add their paths to the string pool, so it goes last
+  std::vector<CompiledScene::SourceRecord> sources;
+  if (!AddSources(source_paths, base_path, &strings, &sources)) {
+    return false;
+  }
+
+  header.Sources = AppendSection(sources, &output);
+  header.StringData = AppendSection(strings.GetData(), &output);
+  header.Strings = AppendSection(strings.GetEntries(), &output);
+
+  header.FileSize = output.size();
+  std::memcpy(output.data(), &header, sizeof(header));
+
+  std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+  if (!output_file.good()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error creating compiled scene %s", output_path.string().c_str());
+    return false;
+  }
+
+  output_file.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+  if (!output_file.good()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error writing compiled scene %s", output_path.string().c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace Loaders
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "core/filesystem.h"
+
+namespace Loaders {
+
+// Writes the scene at scene_path, with the lights and textures files it refers to, as a binary scene that
+// LoadCompiledScene reads without parsing. Paths inside the scene are resolved against base_path like LoadScene does.
+// The size and content hash of every file that went in are recorded, so the loader can tell when one of them changed.
+bool CompileScene(const filesystem::path& scene_path, const filesystem::path& base_path, const filesystem::path& output_path);
+
+}  // namespace Loaders
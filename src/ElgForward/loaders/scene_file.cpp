@@ -0,0 +1,108 @@
+#include "scene_file.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <dxfw/dxfw.h>
+
+#include "core/json_stream.h"
+
+namespace Loaders {
+
+// Reads drawable entries straight into descriptions while the scene file is parsed
+class DrawableReader : public Core::JsonRecordVisitor {
+ public:
+  explicit DrawableReader(std::vector<DrawableDescription>* drawables)
+      : m_drawables_(drawables) {
+  }
+
+  void BeginRecord() override {
+    m_is_object_ = true;
+    m_has_name_ = false;
+    m_has_mesh_name_ = false;
+    m_has_material_name_ = false;
+    m_drawable_ = {};
+    m_translation_.Reset();
+    m_rotation_.Reset();
+    m_scale_.Reset();
+  }
+
+  void Value(const std::string& path, int32_t index, const Core::JsonStreamValue& value) override {
+    bool is_string = value.ValueType == Core::JsonStreamValue::Type::String;
+
+    if (path.empty()) {
+      m_is_object_ = false;
+    } else if (path == "name") {
+      m_has_name_ = is_string;
+      if (is_string) {
+        m_drawable_.Name = *value.String;
+      }
+    } else if (path == "mesh_name") {
+      m_has_mesh_name_ = is_string;
+      if (is_string) {
+        m_drawable_.MeshName = *value.String;
+      }
+    } else if (path == "material_name") {
+      m_has_material_name_ = is_string;
+      if (is_string) {
+        m_drawable_.MaterialName = *value.String;
+      }
+    } else if (path == "transform") {
+      m_drawable_.HasTransform = value.ValueType == Core::JsonStreamValue::Type::Object;
+    } else if (path == "transform.translation") {
+      m_translation_.Read(index, value);
+    } else if (path == "transform.rotation") {
+      m_rotation_.Read(index, value);
+    } else if (path == "transform.scale") {
+      m_scale_.Read(index, value);
+    }
+  }
+
+  void EndRecord() override {
+    auto entry_index = m_entry_index_++;
+
+    bool is_valid_drawable_entry = m_is_object_ && m_has_name_ && m_has_mesh_name_ && m_has_material_name_;
+    if (!is_valid_drawable_entry) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable entry %d", entry_index);
+      return;
+    }
+
+    auto& transform = m_drawable_.Transform;
+    transform.HasTranslation = m_translation_.HasSize(3);
+    std::copy(std::begin(m_translation_.Values), std::end(m_translation_.Values), transform.Translation);
+    transform.RotationSize = (m_rotation_.HasSize(3) || m_rotation_.HasSize(4)) ? m_rotation_.Size : 0;
+    std::copy(std::begin(m_rotation_.Values), std::end(m_rotation_.Values), transform.Rotation);
+    transform.HasScale = m_scale_.HasSize(3);
+    std::copy(std::begin(m_scale_.Values), std::end(m_scale_.Values), transform.Scale);
+
+    m_drawables_->emplace_back(std::move(m_drawable_));
+  }
+
+ private:
+  std::vector<DrawableDescription>* m_drawables_;
+
+  int32_t m_entry_index_ = 0;
+  bool m_is_object_ = true;
+  bool m_has_name_ = false;
+  bool m_has_mesh_name_ = false;
+  bool m_has_material_name_ = false;
+  DrawableDescription m_drawable_;
+  Core::JsonStreamFloats<3> m_translation_;
+  Core::JsonStreamFloats<4> m_rotation_;
+  Core::JsonStreamFloats<3> m_scale_;
+};
+
+bool ReadSceneFile(const filesystem::path& path, nlohmann::json* json_scene, std::vector<DrawableDescription>* drawables) {
+  // Drawable entries are read as the file is parsed, the rest of the scene is small enough for a document
+  DrawableReader drawable_reader(drawables);
+
+  bool load_ok = Core::StreamJsonFile(path, "scene", &drawable_reader, json_scene);
+  if (!load_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error reading scene file from %s", path.string().c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace Loaders
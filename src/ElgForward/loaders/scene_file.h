@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable: 4706)
+#include <nlohmann/json.hpp>
+#pragma warning(pop)
+
+#include "core/filesystem.h"
+#include "loaders/transform_loader.h"
+
+namespace Loaders {
+
+// Everything a drawable entry names, kept until the meshes and materials it refers to are loaded
+struct DrawableDescription {
+  std::string Name;
+  std::string MeshName;
+  std::string MaterialName;
+  bool HasTransform = false;
+  TransformDescription Transform;
+};
+
+// Reads a scene file - drawable entries are streamed into descriptions, the other entries end up in *json_scene
+bool ReadSceneFile(const filesystem::path& path, nlohmann::json* json_scene, std::vector<DrawableDescription>* drawables);
+
+}  // namespace Loaders
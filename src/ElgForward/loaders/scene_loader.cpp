@@ -1,5 +1,11 @@
 #include "scene_loader.h"
 
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
 #pragma warning(push)
 #pragma warning(disable: 4706)
 #include <nlohmann/json.hpp>
@@ -7,11 +13,15 @@
 
 #include <dxfw/dxfw.h>
 
+#include "core/asset_file.h"
 #include "core/json_helpers.h"
+#include "core/read_batch.h"
+#include "loaders/compiled_scene.h"
 #include "loaders/light_loader.h"
 #include "loaders/camera_loader.h"
 #include "loaders/material_loader.h"
 #include "loaders/mesh_loader.h"
+#include "loaders/scene_file.h"
 #include "loaders/transform_loader.h"
 #include "loaders/texture_loader.h"
 #include "rendering/screen.h"
@@ -43,76 +53,129 @@ void ReadMeshes(const nlohmann::json& json_scene, const filesystem::path& base_p
   }
 }
 
-void ReadDrawableTransform(const std::string& drawable_name, const nlohmann::json& json_drawable, DirectXState* state, Rendering::Transform::Transform* transform) {
-  const auto& json_transform = json_drawable["transform"];
-  
-  if (!json_transform.is_object()) {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable transform entry [%S]", json_transform.dump().c_str());
+void AddDrawable(const Rendering::Mesh::Mesh& mesh, const MaterialIdentifier& material, const Rendering::Transform::Transform& transform,
+                 const std::string& mesh_name, const std::string& material_name, DirectXState* state,
+                 std::vector<Rendering::Drawable>* drawables) {
+  Rendering::Drawable drawable;
+  bool drawable_ok = CreateDrawable(mesh, material.Hash, material.Material, transform, state->device.Get(), &drawable);
+  if (!drawable_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable from mesh %S and material %S - CreateDrawable failed", mesh_name.c_str(), material_name.c_str());
     return;
   }
 
-  bool transform_ok = ReadTransform(drawable_name, json_transform, state->device.Get(), transform);
+  drawables->emplace_back(std::move(drawable));
+}
 
-  if (!transform_ok) {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Error reading drawable transform entry [%S]", json_transform.dump().c_str());
+// Meshes and materials by name, built once per load so every drawable is resolved without scanning the lists. Keyed
+// by the name itself, two names with the same hash still resolve to their own entries. The first entry wins when
+// names repeat.
+using MeshIndex = std::unordered_map<std::string, const Rendering::Mesh::Mesh*>;
+using MaterialIndex = std::unordered_map<std::string, const MaterialIdentifier*>;
+
+MeshIndex BuildMeshIndex(const std::vector<MeshIdentifier>& mesh_identifiers) {
+  MeshIndex index;
+  index.reserve(mesh_identifiers.size());
+  for (const auto& identifier : mesh_identifiers) {
+    if (index.find(identifier.Name) == std::end(index)) {
+      index.emplace(identifier.Name, Rendering::Mesh::Retreive(identifier.handle));
+    }
   }
+  return index;
 }
 
-void BuildDrawables(const nlohmann::json& json_scene, const std::vector<MeshIdentifier>& mesh_indetifiers,
+MaterialIndex BuildMaterialIndex(const std::vector<MaterialIdentifier>& materials) {
+  MaterialIndex index;
+  index.reserve(materials.size());
+  for (const auto& material : materials) {
+    index.emplace(material.Name, &material);
+  }
+  return index;
+}
+
+// Everything a drawable needs that doesn't touch the device
+struct PreparedDrawable {
+  const Rendering::Mesh::Mesh* Mesh = nullptr;
+  const MaterialIdentifier* Material = nullptr;
+  Rendering::Transform::TransformAndInverseTranspose Transform;
+};
+
+void BuildDrawables(const std::vector<DrawableDescription>& drawable_descriptions, const std::vector<MeshIdentifier>& mesh_indetifiers,
                     const std::vector<MaterialIdentifier>& materials, DirectXState* state,
                     std::vector<Rendering::Drawable>* drawables) {
-  const auto& json_drawables = json_scene["scene"];
+  auto meshes = BuildMeshIndex(mesh_indetifiers);
+  auto material_identifiers = BuildMaterialIndex(materials);
 
-  for (const auto& json_drawable : json_drawables) {
-    bool is_valid_drawable_entry = json_drawable["name"].is_string()
-                                && json_drawable["mesh_name"].is_string()
-                                && json_drawable["material_name"].is_string();
+  // Name lookups and transform math run on all cores, resource creation below stays on the calling thread
+  auto drawable_count = static_cast<uint32_t>(drawable_descriptions.size());
+  std::vector<PreparedDrawable> prepared_drawables(drawable_count);
 
-    if (!is_valid_drawable_entry) {
-      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable entry %S", json_drawable.dump().c_str());
-      continue;
+  auto worker_count = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), drawable_count);
+  auto drawables_per_worker = worker_count > 0 ? (drawable_count + worker_count - 1) / worker_count : 0;
+
+  auto run_worker = [&](uint32_t worker_index) {
+    auto drawable_begin = std::min(worker_index * drawables_per_worker, drawable_count);
+    auto drawable_end = std::min(drawable_begin + drawables_per_worker, drawable_count);
+
+    for (auto i = drawable_begin; i < drawable_end; ++i) {
+      const auto& drawable_description = drawable_descriptions[i];
+      auto& prepared_drawable = prepared_drawables[i];
+
+      auto mesh_it = meshes.find(drawable_description.MeshName);
+      if (mesh_it != std::end(meshes)) {
+        prepared_drawable.Mesh = mesh_it->second;
+      }
+
+      auto material_it = material_identifiers.find(drawable_description.MaterialName);
+      if (material_it != std::end(material_identifiers)) {
+        prepared_drawable.Material = material_it->second;
+      }
+
+      if (prepared_drawable.Mesh != nullptr && prepared_drawable.Material != nullptr && drawable_description.HasTransform) {
+        prepared_drawable.Transform = ComputeTransform(drawable_description.Transform);
+      }
     }
+  };
 
-    const std::string& drawable_name = json_drawable["name"];
-    const std::string& mesh_name = json_drawable["mesh_name"];
-    const std::string& material_name = json_drawable["material_name"];
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
 
-    std::hash<std::string> hasher;
-    auto drawable_name_hash = hasher(drawable_name);
-    auto mesh_name_hash = hasher(mesh_name);
-    auto material_name_hash = hasher(material_name);
+  if (worker_count > 0) {
+    run_worker(0);
+  }
 
-    auto mesh_indetifier_it = std::find_if(std::begin(mesh_indetifiers), std::end(mesh_indetifiers), [mesh_name_hash](const auto& identifier){
-      return mesh_name_hash == identifier.Hash;
-    });
+  for (auto& future : futures) {
+    future.get();
+  }
 
-    if (mesh_indetifier_it == std::end(mesh_indetifiers)) {
+  drawables->reserve(drawables->size() + drawable_descriptions.size());
+
+  for (uint32_t i = 0; i < drawable_count; ++i) {
+    const auto& drawable_description = drawable_descriptions[i];
+    const auto& prepared_drawable = prepared_drawables[i];
+    const auto& drawable_name = drawable_description.Name;
+    const auto& mesh_name = drawable_description.MeshName;
+    const auto& material_name = drawable_description.MaterialName;
+
+    if (prepared_drawable.Mesh == nullptr) {
       DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable from mesh %S and material %S - mesh not found", mesh_name.c_str(), material_name.c_str());
       continue;
     }
 
-    auto mesh = Rendering::Mesh::Retreive(mesh_indetifier_it->handle);
-
-    auto material_identifier_it = std::find_if(std::begin(materials), std::end(materials), [material_name_hash](const auto& material) {
-      return material_name_hash == material.Hash;
-    });
-
-    if (material_identifier_it == std::end(materials)) {
+    if (prepared_drawable.Material == nullptr) {
       DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable from mesh %S and material %S - material not found", mesh_name.c_str(), material_name.c_str());
       continue;
     }
 
     Rendering::Transform::Transform transform;
-    ReadDrawableTransform(drawable_name, json_drawable, state, &transform);
-
-    Rendering::Drawable drawable;
-    bool drawable_ok = CreateDrawable(drawable_name_hash, *mesh, material_identifier_it->Hash, material_identifier_it->Material, transform, state->device.Get(), &drawable);
-    if (!drawable_ok) {
-      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable from mesh %S and material %S - CreateDrawable failed", mesh_name.c_str(), material_name.c_str());
-      continue;
+    if (!drawable_description.HasTransform) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable transform entry in %S", drawable_name.c_str());
+    } else if (!CreateTransform(prepared_drawable.Transform, &transform)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable transform for %S", drawable_name.c_str());
     }
 
-    drawables->emplace_back(std::move(drawable));
+    AddDrawable(*prepared_drawable.Mesh, *prepared_drawable.Material, transform, mesh_name, material_name, state, drawables);
   }
 }
 
@@ -120,10 +183,11 @@ void ReadMaterials(const nlohmann::json& json_scene, const filesystem::path& bas
                    const std::vector<TextureIdentifier>& textures, DirectXState* state,
                    std::vector<MaterialIdentifier>* materials) {
   const auto& json_materials = json_scene["materials"];
+  auto texture_index = BuildTextureIndex(textures);
 
   for (const auto& json_material : json_materials) {
     MaterialIdentifier new_material;
-    bool material_ok = ReadMaterial(json_material, base_path, textures, state->device.Get(), &new_material);
+    bool material_ok = ReadMaterial(json_material, base_path, texture_index, state->device.Get(), &new_material);
     if (!material_ok) {
       DXFW_TRACE(__FILE__, __LINE__, false, "Error loading material [%S]", json_material.dump().c_str());
     }
@@ -145,8 +209,7 @@ void ReadLights(const nlohmann::json& json_scene, const filesystem::path& base_p
 
   const std::string& lights_relative_path = *lights_it;
   auto lights_path = base_path / lights_relative_path;
-  bool lights_ok = ReadLightsFromFile(lights_path, scene->DirectionalLightsStructuredBuffer,
-                                      scene->SpotLightsStructuredBuffer, scene->PointLightsStructuredBuffer);
+  bool lights_ok = ReadLightsFromFile(lights_path, &scene->DirectionalLights, &scene->SpotLights, &scene->PointLights);
   if (!lights_ok) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Error reading lights from [%S]", lights_path.c_str());
   }
@@ -158,6 +221,14 @@ void ReadTextures(const nlohmann::json& json_scene, const filesystem::path& base
     return;
   }
 
+  // Compiled scenes carry the textures document itself
+  if (textures_it->is_object()) {
+    if (!ReadTexturesFromJson(*textures_it, base_path, state->device.Get(), textures)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading textures [%S]", textures_it->dump().c_str());
+    }
+    return;
+  }
+
   if (!textures_it->is_string()) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Invalid textures entry [%S]", textures_it->dump().c_str());
     return;
@@ -188,10 +259,8 @@ void ReadCamera(const nlohmann::json& json_scene, const filesystem::path& base_p
 
 bool LoadScene(const filesystem::path& path, const filesystem::path& base_path, DirectXState* state, Scene* scene) {
   nlohmann::json json_scene;
-  
-  bool load_ok = Core::ReadJsonFile(path, &json_scene);
-  if (!load_ok) {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Error reading scene file from %S", path.c_str());
+  std::vector<DrawableDescription> drawable_descriptions;
+  if (!ReadSceneFile(path, &json_scene, &drawable_descriptions)) {
     return false;
   }
 
@@ -206,11 +275,296 @@ bool LoadScene(const filesystem::path& path, const filesystem::path& base_path,
   
   ReadLights(json_scene, base_path, scene);
 
-  BuildDrawables(json_scene, mesh_identifiers, materials, state, &scene->Drawables);
+  BuildDrawables(drawable_descriptions, mesh_identifiers, materials, state, &scene->Drawables);
   
   ReadCamera(json_scene, base_path, state, scene);
 
   return true;
 }
 
+// Light arrays of a compiled scene, checked against the file once so the copies below can't read past it
+struct CompiledLights {
+  size_t Count = 0;
+  const DirectX::XMFLOAT4* Positions = nullptr;
+  const DirectX::XMFLOAT4* Directions = nullptr;
+  const DirectX::XMFLOAT4* DiffuseColors = nullptr;
+  const DirectX::XMFLOAT4* SpecularColors = nullptr;
+  const float* Ranges = nullptr;
+  const float* Angles = nullptr;
+  const float* Intensities = nullptr;
+  const uint8_t* Enabled = nullptr;
+};
+
+bool GetCompiledLights(const Core::AssetFile& file, const CompiledScene::LightArrays& arrays, CompiledLights* lights) {
+  auto data = file.GetData();
+  auto size = file.GetSize();
+
+  // Attributes are either missing or hold one value per light
+  auto has_valid_count = [&arrays](const CompiledScene::Section& section) {
+    return section.Count == 0 || section.Count == arrays.Count;
+  };
+
+  bool are_counts_valid = has_valid_count(arrays.Positions) && has_valid_count(arrays.Directions)
+                       && has_valid_count(arrays.DiffuseColors) && has_valid_count(arrays.SpecularColors)
+                       && has_valid_count(arrays.Ranges) && has_valid_count(arrays.Angles)
+                       && has_valid_count(arrays.Intensities) && has_valid_count(arrays.Enabled);
+  if (!are_counts_valid) {
+    return false;
+  }
+
+  lights->Count = static_cast<size_t>(arrays.Count);
+  lights->Positions = arrays.Positions.Count ? CompiledScene::GetSection<DirectX::XMFLOAT4>(data, size, arrays.Positions) : nullptr;
+  lights->Directions = arrays.Directions.Count ? CompiledScene::GetSection<DirectX::XMFLOAT4>(data, size, arrays.Directions) : nullptr;
+  lights->DiffuseColors = arrays.DiffuseColors.Count ? CompiledScene::GetSection<DirectX::XMFLOAT4>(data, size, arrays.DiffuseColors) : nullptr;
+  lights->SpecularColors = arrays.SpecularColors.Count ? CompiledScene::GetSection<DirectX::XMFLOAT4>(data, size, arrays.SpecularColors) : nullptr;
+  lights->Ranges = arrays.Ranges.Count ? CompiledScene::GetSection<float>(data, size, arrays.Ranges) : nullptr;
+  lights->Angles = arrays.Angles.Count ? CompiledScene::GetSection<float>(data, size, arrays.Angles) : nullptr;
+  lights->Intensities = arrays.Intensities.Count ? CompiledScene::GetSection<float>(data, size, arrays.Intensities) : nullptr;
+  lights->Enabled = arrays.Enabled.Count ? CompiledScene::GetSection<uint8_t>(data, size, arrays.Enabled) : nullptr;
+
+  auto is_mapped = [](const CompiledScene::Section& section, const void* values) {
+    return section.Count == 0 || values != nullptr;
+  };
+
+  return is_mapped(arrays.Positions, lights->Positions) && is_mapped(arrays.Directions, lights->Directions)
+      && is_mapped(arrays.DiffuseColors, lights->DiffuseColors) && is_mapped(arrays.SpecularColors, lights->SpecularColors)
+      && is_mapped(arrays.Ranges, lights->Ranges) && is_mapped(arrays.Angles, lights->Angles)
+      && is_mapped(arrays.Intensities, lights->Intensities) && is_mapped(arrays.Enabled, lights->Enabled);
+}
+
+template <typename Light>
+void ReadCompiledLightColors(const CompiledLights& lights, size_t index, Light* light) {
+  if (lights.DiffuseColors != nullptr) {
+    light->DiffuseColor = DirectX::XMLoadFloat4(&lights.DiffuseColors[index]);
+  }
+
+  if (lights.SpecularColors != nullptr) {
+    light->SpecularColor = DirectX::XMLoadFloat4(&lights.SpecularColors[index]);
+  }
+
+  if (lights.Intensities != nullptr) {
+    light->Intensity = lights.Intensities[index];
+  }
+
+  if (lights.Enabled != nullptr) {
+    light->Enabled = lights.Enabled[index] != 0;
+  }
+}
+
+bool ReadCompiledLights(const Core::AssetFile& file, const CompiledScene::Header& header, Scene* scene) {
+  CompiledLights directional_lights;
+  CompiledLights spot_lights;
+  CompiledLights point_lights;
+
+  bool lights_ok = GetCompiledLights(file, header.DirectionalLights, &directional_lights)
+                && GetCompiledLights(file, header.SpotLights, &spot_lights)
+                && GetCompiledLights(file, header.PointLights, &point_lights);
+
+  // Every light type needs its placement
+  bool has_placement = (directional_lights.Count == 0 || directional_lights.Directions != nullptr)
+                    && (spot_lights.Count == 0 || (spot_lights.Positions != nullptr && spot_lights.Directions != nullptr))
+                    && (point_lights.Count == 0 || point_lights.Positions != nullptr);
+  if (!lights_ok || !has_placement) {
+    return false;
+  }
+
+  scene->DirectionalLights.reserve(scene->DirectionalLights.size() + directional_lights.Count);
+  for (size_t i = 0; i < directional_lights.Count; ++i) {
+    Rendering::Lights::DirectionalLight directional_light;
+    directional_light.DirectionWorldSpace = DirectX::XMLoadFloat4(&directional_lights.Directions[i]);
+    ReadCompiledLightColors(directional_lights, i, &directional_light);
+    scene->DirectionalLights.emplace_back(directional_light);
+  }
+
+  scene->SpotLights.reserve(scene->SpotLights.size() + spot_lights.Count);
+  for (size_t i = 0; i < spot_lights.Count; ++i) {
+    Rendering::Lights::SpotLight spot_light;
+    spot_light.PositionWorldSpace = DirectX::XMLoadFloat4(&spot_lights.Positions[i]);
+    spot_light.DirectionWorldSpace = DirectX::XMLoadFloat4(&spot_lights.Directions[i]);
+    if (spot_lights.Angles != nullptr) {
+      spot_light.SpotlightAngle = spot_lights.Angles[i];
+    }
+    if (spot_lights.Ranges != nullptr) {
+      spot_light.Range = spot_lights.Ranges[i];
+    }
+    ReadCompiledLightColors(spot_lights, i, &spot_light);
+    scene->SpotLights.emplace_back(spot_light);
+  }
+
+  scene->PointLights.reserve(scene->PointLights.size() + point_lights.Count);
+  for (size_t i = 0; i < point_lights.Count; ++i) {
+    Rendering::Lights::PointLight point_light;
+    point_light.PositionWorldSpace = DirectX::XMLoadFloat4(&point_lights.Positions[i]);
+    if (point_lights.Ranges != nullptr) {
+      point_light.Range = point_lights.Ranges[i];
+    }
+    ReadCompiledLightColors(point_lights, i, &point_light);
+    scene->PointLights.emplace_back(point_light);
+  }
+
+  return true;
+}
+
+// Sizes are compared first, so only files that kept their size are read and hashed
+bool IsSourceCurrent(const filesystem::path& path, const CompiledScene::SourceRecord& source) {
+  size_t size;
+  if (!Core::GetAssetFileSize(path, &size) || size != source.Size) {
+    return false;
+  }
+
+  Core::AssetFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+
+  return CompiledScene::HashContents(file.GetData(), file.GetSize()) == source.ContentHash;
+}
+
+bool LoadCompiledScene(const filesystem::path& path, const filesystem::path& base_path, DirectXState* state, Scene* scene) {
+  Core::AssetFile file;
+  if (!file.Open(path)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error opening compiled scene %s", path.string().c_str());
+    return false;
+  }
+
+  auto data = file.GetData();
+  auto size = file.GetSize();
+  const auto* header = reinterpret_cast<const CompiledScene::Header*>(data);
+
+  bool is_header_valid = size >= sizeof(CompiledScene::Header)
+                      && header->Magic == CompiledScene::Magic
+                      && header->Version == CompiledScene::Version
+                      && header->FileSize == size;
+  if (!is_header_valid) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid compiled scene header in %s", path.string().c_str());
+    return false;
+  }
+
+  const auto* string_data = CompiledScene::GetSection<char>(data, size, header->StringData);
+  const auto* strings = CompiledScene::GetSection<CompiledScene::StringEntry>(data, size, header->Strings);
+  const auto* mesh_names = CompiledScene::GetSection<uint32_t>(data, size, header->MeshNames);
+  const auto* material_names = CompiledScene::GetSection<uint32_t>(data, size, header->MaterialNames);
+  const auto* drawable_records = CompiledScene::GetSection<CompiledScene::DrawableRecord>(data, size, header->Drawables);
+  const auto* transforms = CompiledScene::GetSection<Rendering::Transform::TransformAndInverseTranspose>(data, size, header->Transforms);
+  const auto* resources = CompiledScene::GetSection<char>(data, size, header->Resources);
+  const auto* sources = CompiledScene::GetSection<CompiledScene::SourceRecord>(data, size, header->Sources);
+
+  bool are_sections_valid = string_data != nullptr && strings != nullptr && mesh_names != nullptr && material_names != nullptr
+                         && drawable_records != nullptr && transforms != nullptr && resources != nullptr && sources != nullptr
+                         && header->Transforms.Count == header->Drawables.Count
+                         && header->Sources.Count > 0;
+  if (!are_sections_valid) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid compiled scene sections in %s", path.string().c_str());
+    return false;
+  }
+
+  auto get_string = [&](uint32_t index, std::string* output) {
+    if (index >= header->Strings.Count) {
+      return false;
+    }
+
+    const auto& entry = strings[index];
+    if (static_cast<uint64_t>(entry.Offset) + entry.Length > header->StringData.Count) {
+      return false;
+    }
+
+    output->assign(string_data + entry.Offset, entry.Length);
+    return true;
+  };
+
+  // The scene file and the lights and textures embedded in it are checked before anything is created
+  std::string source_path;
+  for (size_t i = 0; i < header->Sources.Count; ++i) {
+    if (!get_string(sources[i].Path, &source_path) || !IsSourceCurrent(base_path / source_path, sources[i])) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Compiled scene %s is out of date", path.string().c_str());
+      return false;
+    }
+  }
+
+  // Meshes, materials, textures and camera still go through their JSON readers, they are a handful of entries
+  auto json_scene = nlohmann::json::parse(resources, resources + header->Resources.Count, nullptr, false);
+  if (json_scene.is_discarded() || !json_scene.is_object()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid compiled scene resources in %s", path.string().c_str());
+    return false;
+  }
+
+  std::vector<MeshIdentifier> mesh_identifiers;
+  ReadMeshes(json_scene, base_path, state, &mesh_identifiers);
+
+  std::vector<TextureIdentifier> textures;
+  ReadTextures(json_scene, base_path, state, &textures);
+
+  std::vector<MaterialIdentifier> materials;
+  ReadMaterials(json_scene, base_path, textures, state, &materials);
+
+  if (!ReadCompiledLights(file, *header, scene)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid compiled scene lights in %s", path.string().c_str());
+  }
+
+  // Drawables refer to the name tables, so every mesh and material is looked up once
+  auto mesh_index = BuildMeshIndex(mesh_identifiers);
+  auto material_index = BuildMaterialIndex(materials);
+
+  std::vector<std::string> mesh_name_strings(static_cast<size_t>(header->MeshNames.Count));
+  std::vector<const Rendering::Mesh::Mesh*> meshes(mesh_name_strings.size(), nullptr);
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    if (!get_string(mesh_names[i], &mesh_name_strings[i])) {
+      continue;
+    }
+
+    auto mesh_it = mesh_index.find(mesh_name_strings[i]);
+    if (mesh_it == std::end(mesh_index)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Mesh %S used by compiled scene drawables not found", mesh_name_strings[i].c_str());
+      continue;
+    }
+
+    meshes[i] = mesh_it->second;
+  }
+
+  std::vector<std::string> material_name_strings(static_cast<size_t>(header->MaterialNames.Count));
+  std::vector<const MaterialIdentifier*> material_identifiers(material_name_strings.size(), nullptr);
+  for (size_t i = 0; i < material_identifiers.size(); ++i) {
+    if (!get_string(material_names[i], &material_name_strings[i])) {
+      continue;
+    }
+
+    auto material_it = material_index.find(material_name_strings[i]);
+    if (material_it == std::end(material_index)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Material %S used by compiled scene drawables not found", material_name_strings[i].c_str());
+      continue;
+    }
+
+    material_identifiers[i] = material_it->second;
+  }
+
+  scene->Drawables.reserve(scene->Drawables.size() + static_cast<size_t>(header->Drawables.Count));
+
+  std::string drawable_name;
+  for (size_t i = 0; i < header->Drawables.Count; ++i) {
+    const auto& record = drawable_records[i];
+
+    bool is_valid_record = get_string(record.Name, &drawable_name)
+                        && record.Mesh < meshes.size() && meshes[record.Mesh] != nullptr
+                        && record.Material < material_identifiers.size() && material_identifiers[record.Material] != nullptr;
+    if (!is_valid_record) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid compiled drawable record %u", static_cast<uint32_t>(i));
+      continue;
+    }
+
+    Rendering::Transform::Transform transform;
+    if ((record.Flags & CompiledScene::DrawableHasTransform) == 0) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable transform entry in %S", drawable_name.c_str());
+    } else if (!CreateTransform(transforms[i], &transform)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating drawable transform for %S", drawable_name.c_str());
+    }
+
+    AddDrawable(*meshes[record.Mesh], *material_identifiers[record.Material], transform,
+                mesh_name_strings[record.Mesh], material_name_strings[record.Material], state, &scene->Drawables);
+  }
+
+  ReadCamera(json_scene, base_path, state, scene);
+
+  return true;
+}
+
 }  // namespace Loaders
@@ -1,10 +1,23 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable: 4706)
+#include <nlohmann/json.hpp>
+#pragma warning(pop)
+
 #include "scene.h"
 #include "directx_state.h"
+#include "loaders/scene_file.h"
 
 namespace Loaders {
 
 bool LoadScene(const filesystem::path& path, const filesystem::path& base_path, DirectXState* state, Scene* scene);
 
+// Loads a scene written by CompileScene, drawables and lights are read in place from the mapped file. Fails without
+// loading anything when a file the scene was compiled from has changed since.
+bool LoadCompiledScene(const filesystem::path& path, const filesystem::path& base_path, DirectXState* state, Scene* scene);
+
 }  // namespace Loaders
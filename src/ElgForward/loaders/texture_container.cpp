@@ -0,0 +1,417 @@
+#include "texture_container.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Loaders {
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+  return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+const uint32_t DdsMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+const uint32_t DdsPixelFormatFourCC = 0x4;
+const uint32_t DdsPixelFormatRgb = 0x40;
+const uint32_t DdsPixelFormatLuminance = 0x20000;
+
+const uint32_t DdsCaps2Cubemap = 0x200;
+const uint32_t DdsCaps2CubemapAllFaces = 0xFC00;
+const uint32_t DdsCaps2Volume = 0x200000;
+
+const uint32_t DdsResourceDimensionTexture2D = 3;
+const uint32_t DdsResourceMiscTextureCube = 0x4;
+
+struct DdsPixelFormat {
+  uint32_t Size;
+  uint32_t Flags;
+  uint32_t FourCC;
+  uint32_t RgbBitCount;
+  uint32_t RBitMask;
+  uint32_t GBitMask;
+  uint32_t BBitMask;
+  uint32_t ABitMask;
+};
+
+struct DdsHeader {
+  uint32_t Size;
+  uint32_t Flags;
+  uint32_t Height;
+  uint32_t Width;
+  uint32_t PitchOrLinearSize;
+  uint32_t Depth;
+  uint32_t MipMapCount;
+  uint32_t Reserved1[11];
+  DdsPixelFormat PixelFormat;
+  uint32_t Caps;
+  uint32_t Caps2;
+  uint32_t Caps3;
+  uint32_t Caps4;
+  uint32_t Reserved2;
+};
+
+struct DdsHeaderDx10 {
+  DXGI_FORMAT Format;
+  uint32_t ResourceDimension;
+  uint32_t MiscFlag;
+  uint32_t ArraySize;
+  uint32_t MiscFlags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS header size mismatch");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header size mismatch");
+
+const uint8_t Ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+struct Ktx2Header {
+  uint8_t Identifier[12];
+  uint32_t VkFormat;
+  uint32_t TypeSize;
+  uint32_t PixelWidth;
+  uint32_t PixelHeight;
+  uint32_t PixelDepth;
+  uint32_t LayerCount;
+  uint32_t FaceCount;
+  uint32_t LevelCount;
+  uint32_t SupercompressionScheme;
+  uint32_t DfdByteOffset;
+  uint32_t DfdByteLength;
+  uint32_t KvdByteOffset;
+  uint32_t KvdByteLength;
+  uint64_t SgdByteOffset;
+  uint64_t SgdByteLength;
+};
+
+struct Ktx2Level {
+  uint64_t ByteOffset;
+  uint64_t ByteLength;
+  uint64_t UncompressedByteLength;
+};
+
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header size mismatch");
+static_assert(sizeof(Ktx2Level) == 24, "KTX2 level index size mismatch");
+
+bool GetSurfaceInfo(DXGI_FORMAT format, uint32_t width, uint32_t height, UINT* row_pitch, UINT* slice_pitch) {
+  uint32_t block_size = 0;
+  uint32_t pixel_size = 0;
+
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+      block_size = 8;
+      break;
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+      block_size = 16;
+      break;
+    case DXGI_FORMAT_R8_UNORM:
+      pixel_size = 1;
+      break;
+    case DXGI_FORMAT_R8G8_UNORM:
+    case DXGI_FORMAT_R16_FLOAT:
+      pixel_size = 2;
+      break;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+    case DXGI_FORMAT_R11G11B10_FLOAT:
+    case DXGI_FORMAT_R16G16_FLOAT:
+    case DXGI_FORMAT_R32_FLOAT:
+      pixel_size = 4;
+      break;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32_FLOAT:
+      pixel_size = 8;
+      break;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+      pixel_size = 16;
+      break;
+    default:
+      return false;
+  }
+
+  if (block_size > 0) {
+    *row_pitch = std::max(1u, (width + 3) / 4) * block_size;
+    *slice_pitch = *row_pitch * std::max(1u, (height + 3) / 4);
+  } else {
+    *row_pitch = width * pixel_size;
+    *slice_pitch = *row_pitch * height;
+  }
+
+  return true;
+}
+
+Rendering::Texture::Type GetTextureType(bool is_cube, uint32_t array_size) {
+  if (is_cube) {
+    return array_size > 6 ? Rendering::Texture::Type::CUBE_ARRAY : Rendering::Texture::Type::CUBE;
+  }
+  return array_size > 1 ? Rendering::Texture::Type::DIM_2_ARRAY : Rendering::Texture::Type::DIM_2;
+}
+
+DXGI_FORMAT GetLegacyDdsFormat(const DdsPixelFormat& pixel_format) {
+  if (pixel_format.Flags & DdsPixelFormatFourCC) {
+    switch (pixel_format.FourCC) {
+      case MakeFourCC('D', 'X', 'T', '1'):
+        return DXGI_FORMAT_BC1_UNORM;
+      case MakeFourCC('D', 'X', 'T', '2'):
+      case MakeFourCC('D', 'X', 'T', '3'):
+        return DXGI_FORMAT_BC2_UNORM;
+      case MakeFourCC('D', 'X', 'T', '4'):
+      case MakeFourCC('D', 'X', 'T', '5'):
+        return DXGI_FORMAT_BC3_UNORM;
+      case MakeFourCC('A', 'T', 'I', '1'):
+      case MakeFourCC('B', 'C', '4', 'U'):
+        return DXGI_FORMAT_BC4_UNORM;
+      case MakeFourCC('B', 'C', '4', 'S'):
+        return DXGI_FORMAT_BC4_SNORM;
+      case MakeFourCC('A', 'T', 'I', '2'):
+      case MakeFourCC('B', 'C', '5', 'U'):
+        return DXGI_FORMAT_BC5_UNORM;
+      case MakeFourCC('B', 'C', '5', 'S'):
+        return DXGI_FORMAT_BC5_SNORM;
+      case 113:  // D3DFMT_A16B16G16R16F
+        return DXGI_FORMAT_R16G16B16A16_FLOAT;
+      case 116:  // D3DFMT_A32B32G32R32F
+        return DXGI_FORMAT_R32G32B32A32_FLOAT;
+      default:
+        return DXGI_FORMAT_UNKNOWN;
+    }
+  }
+
+  if ((pixel_format.Flags & DdsPixelFormatRgb) && pixel_format.RgbBitCount == 32) {
+    if (pixel_format.RBitMask == 0x000000FF && pixel_format.GBitMask == 0x0000FF00 && pixel_format.BBitMask == 0x00FF0000) {
+      return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    if (pixel_format.RBitMask == 0x00FF0000 && pixel_format.GBitMask == 0x0000FF00 && pixel_format.BBitMask == 0x000000FF) {
+      return DXGI_FORMAT_B8G8R8A8_UNORM;
+    }
+  }
+
+  if ((pixel_format.Flags & DdsPixelFormatLuminance) && pixel_format.RgbBitCount == 8) {
+    return DXGI_FORMAT_R8_UNORM;
+  }
+
+  return DXGI_FORMAT_UNKNOWN;
+}
+
+DXGI_FORMAT GetKtx2Format(uint32_t vk_format) {
+  switch (vk_format) {
+    case 9:  // VK_FORMAT_R8_UNORM
+      return DXGI_FORMAT_R8_UNORM;
+    case 16:  // VK_FORMAT_R8G8_UNORM
+      return DXGI_FORMAT_R8G8_UNORM;
+    case 37:  // VK_FORMAT_R8G8B8A8_UNORM
+      return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case 43:  // VK_FORMAT_R8G8B8A8_SRGB
+      return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    case 44:  // VK_FORMAT_B8G8R8A8_UNORM
+      return DXGI_FORMAT_B8G8R8A8_UNORM;
+    case 50:  // VK_FORMAT_B8G8R8A8_SRGB
+      return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+    case 97:  // VK_FORMAT_R16G16B16A16_SFLOAT
+      return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    case 109:  // VK_FORMAT_R32G32B32A32_SFLOAT
+      return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    case 131:  // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+    case 133:  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+      return DXGI_FORMAT_BC1_UNORM;
+    case 132:  // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+    case 134:  // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+      return DXGI_FORMAT_BC1_UNORM_SRGB;
+    case 135:  // VK_FORMAT_BC2_UNORM_BLOCK
+      return DXGI_FORMAT_BC2_UNORM;
+    case 137:  // VK_FORMAT_BC3_UNORM_BLOCK
+      return DXGI_FORMAT_BC3_UNORM;
+    case 138:  // VK_FORMAT_BC3_SRGB_BLOCK
+      return DXGI_FORMAT_BC3_UNORM_SRGB;
+    case 139:  // VK_FORMAT_BC4_UNORM_BLOCK
+      return DXGI_FORMAT_BC4_UNORM;
+    case 141:  // VK_FORMAT_BC5_UNORM_BLOCK
+      return DXGI_FORMAT_BC5_UNORM;
+    case 143:  // VK_FORMAT_BC6H_UFLOAT_BLOCK
+      return DXGI_FORMAT_BC6H_UF16;
+    case 145:  // VK_FORMAT_BC7_UNORM_BLOCK
+      return DXGI_FORMAT_BC7_UNORM;
+    case 146:  // VK_FORMAT_BC7_SRGB_BLOCK
+      return DXGI_FORMAT_BC7_UNORM_SRGB;
+    default:
+      return DXGI_FORMAT_UNKNOWN;
+  }
+}
+
+// DDS stores every array slice with its full mip chain, which is the D3D subresource order
+bool ParseDds(const uint8_t* data, size_t size, TextureContainer* container) {
+  if (size < sizeof(uint32_t) + sizeof(DdsHeader)) {
+    return false;
+  }
+
+  DdsHeader header;
+  std::memcpy(&header, data + sizeof(uint32_t), sizeof(DdsHeader));
+  if (header.Size != sizeof(DdsHeader) || header.Width == 0 || header.Height == 0) {
+    return false;
+  }
+
+  size_t offset = sizeof(uint32_t) + sizeof(DdsHeader);
+  uint32_t array_size = 1;
+  bool is_cube = false;
+  DXGI_FORMAT format;
+
+  bool has_dx10_header = (header.PixelFormat.Flags & DdsPixelFormatFourCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0');
+  if (has_dx10_header) {
+    if (size < offset + sizeof(DdsHeaderDx10)) {
+      return false;
+    }
+
+    DdsHeaderDx10 header_dx10;
+    std::memcpy(&header_dx10, data + offset, sizeof(DdsHeaderDx10));
+    offset += sizeof(DdsHeaderDx10);
+
+    if (header_dx10.ResourceDimension != DdsResourceDimensionTexture2D) {
+      return false;
+    }
+
+    format = header_dx10.Format;
+    array_size = std::max(1u, header_dx10.ArraySize);
+    is_cube = (header_dx10.MiscFlag & DdsResourceMiscTextureCube) != 0;
+  } else {
+    if (header.Caps2 & DdsCaps2Volume) {
+      return false;
+    }
+
+    if (header.Caps2 & DdsCaps2Cubemap) {
+      if ((header.Caps2 & DdsCaps2CubemapAllFaces) != DdsCaps2CubemapAllFaces) {
+        return false;
+      }
+      is_cube = true;
+    }
+
+    format = GetLegacyDdsFormat(header.PixelFormat);
+  }
+
+  if (is_cube) {
+    array_size *= 6;
+  }
+
+  TextureContainer result;
+  result.Type = GetTextureType(is_cube, array_size);
+  result.Format = format;
+  result.Width = header.Width;
+  result.Height = header.Height;
+  result.MipLevels = std::max(1u, header.MipMapCount);
+  result.ArraySize = array_size;
+
+  for (uint32_t slice = 0; slice < array_size; ++slice) {
+    auto width = result.Width;
+    auto height = result.Height;
+
+    for (uint32_t mip = 0; mip < result.MipLevels; ++mip) {
+      UINT row_pitch;
+      UINT slice_pitch;
+      if (!GetSurfaceInfo(format, width, height, &row_pitch, &slice_pitch) || offset + slice_pitch > size) {
+        return false;
+      }
+
+      result.Subresources.push_back({ data + offset, row_pitch, slice_pitch });
+      offset += slice_pitch;
+
+      width = std::max(1u, width / 2);
+      height = std::max(1u, height / 2);
+    }
+  }
+
+  *container = std::move(result);
+  return true;
+}
+
+// KTX2 stores all layers and faces of a mip level together, so the subresources are gathered per level
+bool ParseKtx2(const uint8_t* data, size_t size, TextureContainer* container) {
+  if (size < sizeof(Ktx2Header)) {
+    return false;
+  }
+
+  Ktx2Header header;
+  std::memcpy(&header, data, sizeof(Ktx2Header));
+
+  bool is_supported = header.SupercompressionScheme == 0 && header.PixelDepth <= 1 && header.PixelWidth > 0 && header.PixelHeight > 0
+                   && (header.FaceCount == 1 || header.FaceCount == 6);
+  if (!is_supported) {
+    return false;
+  }
+
+  TextureContainer result;
+  result.Format = GetKtx2Format(header.VkFormat);
+  result.Width = header.PixelWidth;
+  result.Height = header.PixelHeight;
+  result.MipLevels = std::max(1u, header.LevelCount);
+  result.ArraySize = std::max(1u, header.LayerCount) * header.FaceCount;
+  result.Type = GetTextureType(header.FaceCount == 6, result.ArraySize);
+  result.Subresources.resize(static_cast<size_t>(result.MipLevels) * result.ArraySize);
+
+  if (size < sizeof(Ktx2Header) + sizeof(Ktx2Level) * result.MipLevels) {
+    return false;
+  }
+
+  for (uint32_t mip = 0; mip < result.MipLevels; ++mip) {
+    Ktx2Level level;
+    std::memcpy(&level, data + sizeof(Ktx2Header) + sizeof(Ktx2Level) * mip, sizeof(Ktx2Level));
+
+    auto width = std::max(1u, result.Width >> mip);
+    auto height = std::max(1u, result.Height >> mip);
+
+    UINT row_pitch;
+    UINT slice_pitch;
+    if (!GetSurfaceInfo(result.Format, width, height, &row_pitch, &slice_pitch)) {
+      return false;
+    }
+
+    if (level.ByteLength < static_cast<uint64_t>(slice_pitch) * result.ArraySize || level.ByteOffset + level.ByteLength > size) {
+      return false;
+    }
+
+    for (uint32_t slice = 0; slice < result.ArraySize; ++slice) {
+      auto image = data + level.ByteOffset + static_cast<size_t>(slice) * slice_pitch;
+      result.Subresources[mip + slice * result.MipLevels] = { image, row_pitch, slice_pitch };
+    }
+  }
+
+  *container = std::move(result);
+  return true;
+}
+
+bool IsTextureContainer(const filesystem::path& path) {
+  auto extension = path.extension().string();
+  std::transform(std::begin(extension), std::end(extension), std::begin(extension), [](char c) {
+    return static_cast<char>(::tolower(c));
+  });
+  return extension == ".dds" || extension == ".ktx2";
+}
+
+bool ParseTextureContainer(const uint8_t* data, size_t size, TextureContainer* container) {
+  if (size >= sizeof(uint32_t)) {
+    uint32_t magic;
+    std::memcpy(&magic, data, sizeof(uint32_t));
+    if (magic == DdsMagic) {
+      return ParseDds(data, size, container);
+    }
+  }
+
+  if (size >= sizeof(Ktx2Identifier) && std::memcmp(data, Ktx2Identifier, sizeof(Ktx2Identifier)) == 0) {
+    return ParseKtx2(data, size, container);
+  }
+
+  return false;
+}
+
+}  // namespace Loaders
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "core/filesystem.h"
+#include "rendering/texture.h"
+
+namespace Loaders {
+
+// Layout of a DDS or KTX2 file - the subresources point into the file data, which has to outlive them
+struct TextureContainer {
+  Rendering::Texture::Type Type = Rendering::Texture::Type::UNKNOWN;
+  DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  uint32_t MipLevels = 0;
+  uint32_t ArraySize = 0;  // Counts every cube face
+  std::vector<D3D11_SUBRESOURCE_DATA> Subresources = {};
+};
+
+bool IsTextureContainer(const filesystem::path& path);
+
+// Detects the container from its magic number, volume textures and supercompressed KTX2 files are not supported
+bool ParseTextureContainer(const uint8_t* data, size_t size, TextureContainer* container);
+
+}  // namespace Loaders
@@ -1,5 +1,15 @@
 #include "texture_loader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <thread>
 #include <unordered_map>
 
 #pragma warning(push)
@@ -15,9 +25,20 @@
 
 #include <dxfw/dxfw.h>
 
+#include "core/asset_file.h"
 #include "core/json_helpers.h"
 #include "core/filesystem.h"
+#include "core/hash.h"
+#include "core/read_batch.h"
+#include "rendering/block_compression.h"
+#include "rendering/dxgi_format_helper.h"
+#include "rendering/mip_generation.h"
+#include "rendering/pixel_conversion.h"
 #include "rendering/texture.h"
+#include "rendering/texture_atlas.h"
+#include "rendering/texture_residency.h"
+#include "loaders/compressed_texture_cache.h"
+#include "loaders/texture_container.h"
 
 using namespace Rendering;
 
@@ -35,8 +56,7 @@ DXGI_FORMAT StbiComponentsToDxgiFormat(int image_components) {
       return DXGI_FORMAT_R8_UNORM;
     case 2:
       return DXGI_FORMAT_R8G8_UNORM;
-    case 3:
-      return DXGI_FORMAT_UNKNOWN;
+    case 3:  // Expanded to RGBA after decoding
     case 4:
       return DXGI_FORMAT_R8G8B8A8_UNORM;
     default:
@@ -44,52 +64,629 @@ DXGI_FORMAT StbiComponentsToDxgiFormat(int image_components) {
   }
 }
 
-bool ReadWithStbi(const std::string& path, const filesystem::path& base_path,
+struct DecodeStatistics {
+  uint8_t SourceComponents = 0;
+  size_t Bytes = 0;
+  double Milliseconds = 0.0;
+};
+
+// Three channel images are widened to RGBA inside the buffer stb_image decoded into, D3D11 has no 24 bit formats
+bool ReadWithStbi(const filesystem::path& full_path, const std::vector<uint8_t>& source,
                   std::vector<std::unique_ptr<unsigned char, TextureDeleter>>* textures,
-                  std::vector<Rendering::Texture::ImageData>* data) {
-  auto full_path = base_path / path;
+                  std::vector<Rendering::Texture::ImageData>* data, DecodeStatistics* statistics) {
+  auto decode_start = std::chrono::high_resolution_clock::now();
 
   int current_image_width;
   int current_image_height;
   int current_image_components;
-  auto image = stbi_load(full_path.generic_string().c_str(), &current_image_width, &current_image_height, &current_image_components, STBI_default);
-  textures->emplace_back(image);
+  auto image = stbi_load_from_memory(source.data(), static_cast<int>(source.size()), &current_image_width, &current_image_height, &current_image_components, STBI_default);
+  if (image == nullptr) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error decoding %S: %S", full_path.string().c_str(), stbi_failure_reason());
+    return false;
+  }
 
   auto dxgi_format = StbiComponentsToDxgiFormat(current_image_components);
   if (dxgi_format == DXGI_FORMAT_UNKNOWN) {
+    textures->emplace_back(image);
     DXFW_TRACE(__FILE__, __LINE__, false, "Unsupported number of components from STBI: %d", current_image_components);
     return false;
   }
 
-  data->emplace_back(current_image_width, current_image_height, static_cast<uint8_t>(current_image_components), dxgi_format, image);
+  auto pixel_count = static_cast<size_t>(current_image_width) * current_image_height;
+  auto image_components = static_cast<uint8_t>(current_image_components);
+  if (image_components == 3) {
+    auto expanded = static_cast<unsigned char*>(STBI_REALLOC(image, pixel_count * 4));
+    if (expanded == nullptr) {
+      textures->emplace_back(image);
+      DXFW_TRACE(__FILE__, __LINE__, false, "Out of memory expanding %S to RGBA", full_path.string().c_str());
+      return false;
+    }
+
+    image = expanded;
+    image_components = 4;
+    Rendering::PixelConversion::ExpandRgbToRgba(image, pixel_count);
+  }
+
+  textures->emplace_back(image);
+
+  std::chrono::duration<double, std::milli> decode_time = std::chrono::high_resolution_clock::now() - decode_start;
+  if (statistics->SourceComponents == 0) {
+    statistics->SourceComponents = static_cast<uint8_t>(current_image_components);
+  }
+  statistics->Bytes += pixel_count * image_components;
+  statistics->Milliseconds += decode_time.count();
+
+  data->emplace_back(current_image_width, current_image_height, image_components, dxgi_format, image);
+
+  return true;
+}
+
+struct LoadedTexture {
+  std::string Name;
+  size_t Hash;
+  std::vector<Rendering::Texture::ImageData> Data;
+  std::vector<std::unique_ptr<unsigned char, TextureDeleter>> Images;  // Own the Data of source images
+  std::vector<Rendering::MipGeneration::Level> GeneratedLevels;  // Own the Data of generated mip levels
+  std::vector<CompressedTextureLevel> CompressedLevels;  // Owns the Data of block compressed textures
+  DecodeStatistics Decode;
+};
+
+struct TextureOptions {
+  std::string Compression = "none";
+  std::string ColorSpace = "auto";  // "srgb", "linear" or "auto", which treats three and four channel images as srgb
+  bool GenerateMips = true;
+};
+
+// Mip generation options change the encoded levels, so they are part of the compressed texture key
+std::string GetCacheSettings(const TextureOptions& options) {
+  return options.Compression + (options.GenerateMips ? "|mips|" + options.ColorSpace : "");
+}
+
+// "auto" picks the format from the number of source channels
+bool CompressionToDxgiFormat(const std::string& compression, uint8_t components, DXGI_FORMAT* format) {
+  if (compression == "bc1") {
+    *format = DXGI_FORMAT_BC1_UNORM;
+    return true;
+  }
+  if (compression == "bc3") {
+    *format = DXGI_FORMAT_BC3_UNORM;
+    return true;
+  }
+  if (compression == "bc4") {
+    *format = DXGI_FORMAT_BC4_UNORM;
+    return true;
+  }
+  if (compression == "bc5") {
+    *format = DXGI_FORMAT_BC5_UNORM;
+    return true;
+  }
+  if (compression == "auto") {
+    switch (components) {
+      case 1:
+        *format = DXGI_FORMAT_BC4_UNORM;
+        return true;
+      case 2:
+        *format = DXGI_FORMAT_BC5_UNORM;
+        return true;
+      case 3:
+        *format = DXGI_FORMAT_BC1_UNORM;
+        return true;
+      case 4:
+        *format = DXGI_FORMAT_BC3_UNORM;
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+bool EncodeTexture(const std::string& name, const std::string& compression, uint8_t source_components,
+                   const std::vector<Rendering::Texture::ImageData>& source_data, CompressedTexture* compressed) {
+  if (!CompressionToDxgiFormat(compression, source_components, &compressed->Format)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unsupported compression %S for texture %S", compression.c_str(), name.c_str());
+    return false;
+  }
+
+  if (source_data[0].Width % 4 != 0 || source_data[0].Height % 4 != 0) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Texture %S needs a size that is a multiple of 4 to be block compressed", name.c_str());
+    return false;
+  }
+
+  auto encode_start = std::chrono::high_resolution_clock::now();
+
+  for (const auto& source_level : source_data) {
+    CompressedTextureLevel level;
+    level.Width = source_level.Width;
+    level.Height = source_level.Height;
+    if (!Rendering::BlockCompression::Encode(source_level, compressed->Format, &level.Data)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error block compressing texture %S", name.c_str());
+      return false;
+    }
+    compressed->Levels.emplace_back(std::move(level));
+  }
+
+  std::chrono::duration<double, std::milli> encode_time = std::chrono::high_resolution_clock::now() - encode_start;
+  auto psnr = Rendering::BlockCompression::ComputePsnr(source_data[0], compressed->Format, compressed->Levels[0].Data);
+  DXFW_TRACE(__FILE__, __LINE__, false, "Block compressed texture %S in %.2f ms, PSNR %.2f dB", name.c_str(), encode_time.count(), psnr);
+
+  return true;
+}
+
+// A single source image gets its full mip chain generated, hand authored levels are used as they are
+bool GenerateMips(const std::string& name, const TextureOptions& options, LoadedTexture* loaded_texture,
+                  std::vector<Rendering::Texture::ImageData>* source_data) {
+  if (!options.GenerateMips || source_data->size() != 1) {
+    return true;
+  }
+
+  const auto& image = source_data->front();
+  bool srgb = options.ColorSpace == "srgb" || (options.ColorSpace == "auto" && image.Components >= 3);
+
+  if (!Rendering::MipGeneration::Generate(image, srgb, &loaded_texture->GeneratedLevels)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error generating mip levels for texture %S", name.c_str());
+    return false;
+  }
+
+  for (const auto& level : loaded_texture->GeneratedLevels) {
+    source_data->emplace_back(level.Width, level.Height, image.Components, image.Format, level.Data.data());
+  }
 
   return true;
 }
 
-Rendering::Texture::Handle ReadSingleTexture(size_t name_hash, const std::string& path, const filesystem::path& base_path, ID3D11Device* device) {
-  std::vector<std::unique_ptr<unsigned char, TextureDeleter>> textures;
-  std::vector<Rendering::Texture::ImageData> data = {};
+struct TextureRequest {
+  std::string Name;
+  std::vector<std::string> Filenames;
+  TextureOptions Options;
+};
+
+// Source files of a texture, read by a ReadBatch ahead of decoding
+struct TextureSources {
+  std::vector<filesystem::path> Paths;
+  std::vector<std::vector<uint8_t>> Files;
+  std::vector<size_t> Reads;
+  bool Queued = false;
+};
+
+void QueueTextureSources(const TextureRequest& request, const filesystem::path& base_path, Core::ReadBatch* batch, TextureSources* sources) {
+  for (const auto& filename : request.Filenames) {
+    auto path = base_path / filename;
 
-  auto read_ok = ReadWithStbi(path, base_path, &textures, &data);
-  if (!read_ok) {
-    return {};
+    size_t size;
+    if (!Core::GetAssetFileSize(path, &size)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error opening %S", path.string().c_str());
+      return;
+    }
+
+    sources->Paths.emplace_back(std::move(path));
+    sources->Files.emplace_back(size);
+  }
+
+  // Buffers are only handed out once all of them are allocated
+  for (size_t i = 0; i < sources->Files.size(); ++i) {
+    sources->Reads.emplace_back(batch->Add(sources->Paths[i], sources->Files[i].data(), sources->Files[i].size()));
   }
 
-  return Rendering::Texture::Create(name_hash, data, device);
+  sources->Queued = true;
 }
 
-Rendering::Texture::Handle ReadMipmapTexture(size_t name_hash, const nlohmann::json::array_t& path_array, const filesystem::path& base_path, ID3D11Device* device) {
-  std::vector<std::unique_ptr<unsigned char, TextureDeleter>> textures;
-  std::vector<Rendering::Texture::ImageData> data = {};
+bool WaitTextureSources(Core::ReadBatch* batch, const TextureSources& sources) {
+  if (!sources.Queued) {
+    return false;
+  }
+
+  for (size_t i = 0; i < sources.Reads.size(); ++i) {
+    if (!batch->Wait(sources.Reads[i])) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading %S", sources.Paths[i].string().c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Block compressed textures come from the content keyed cache when possible, anything that can't be
+// compressed falls back to the uncompressed images
+bool ReadTexture(const std::string& name, const TextureSources& sources, const TextureOptions& options,
+                 const filesystem::path& base_path, LoadedTexture* loaded_texture) {
+  const auto& compression = options.Compression;
+  bool compress = (compression != "none");
+
+  auto cache_path = base_path / "texture_cache";
+  size_t key = compress ? GetCompressedTextureKey(sources.Files, GetCacheSettings(options)) : 0;
+
+  CompressedTexture compressed;
+  bool compressed_ok = compress && ReadCompressedTexture(GetCompressedTexturePath(key, cache_path), key, &compressed);
+
+  if (!compressed_ok) {
+    std::vector<Rendering::Texture::ImageData> source_data;
+    for (size_t i = 0; i < sources.Files.size(); ++i) {
+      if (!ReadWithStbi(sources.Paths[i], sources.Files[i], &loaded_texture->Images, &source_data, &loaded_texture->Decode)) {
+        return false;
+      }
+    }
+
+    if (source_data.empty() || !GenerateMips(name, options, loaded_texture, &source_data)) {
+      return false;
+    }
+
+    compressed_ok = compress && EncodeTexture(name, compression, loaded_texture->Decode.SourceComponents, source_data, &compressed);
+    if (!compressed_ok) {
+      loaded_texture->Data = std::move(source_data);
+      return true;
+    }
 
-  for (const auto& path : path_array) {
-    auto read_ok = ReadWithStbi(path, base_path, &textures, &data);
-    if (!read_ok) {
-      return {};
+    if (!WriteCompressedTexture(GetCompressedTexturePath(key, cache_path), key, compressed)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error writing compressed texture cache for %S", name.c_str());
     }
   }
 
-  return Rendering::Texture::Create(name_hash, data, device);
+  auto components = static_cast<uint8_t>(Rendering::DxgiFormatToComponentsAndType(compressed.Format).first);
+  loaded_texture->CompressedLevels = std::move(compressed.Levels);
+  for (const auto& level : loaded_texture->CompressedLevels) {
+    loaded_texture->Data.emplace_back(level.Width, level.Height, components, compressed.Format, level.Data.data());
+  }
+
+  return true;
+}
+
+const uint32_t AtlasMaxTextureSize = 256;
+const uint32_t AtlasMaxSize = 2048;
+const uint32_t AtlasPadding = 1;  // In the smallest atlas mip level, larger levels scale it up
+const uint32_t AtlasMaxMipLevels = 4;
+
+void CreateSingleTexture(const LoadedTexture& loaded_texture, ID3D11Device* device, std::vector<TextureIdentifier>* textures) {
+  TextureIdentifier identifier;
+  identifier.Hash = loaded_texture.Hash;
+  identifier.Texture = Rendering::Texture::Create(loaded_texture.Hash, loaded_texture.Data, device);
+
+  if (!identifier.Texture.IsValid()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error creating texture %S", loaded_texture.Name.c_str());
+    return;
+  }
+
+  textures->emplace_back(std::move(identifier));
+}
+
+// DDS and KTX2 files already hold the final layout, the subresources are handed to D3D straight from the file contents
+void CreateContainerTexture(const std::string& name, const filesystem::path& path, ID3D11Device* device, std::vector<TextureIdentifier>* textures) {
+  Core::AssetFile file;
+  if (!file.Open(path)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error opening texture file %S", path.string().c_str());
+    return;
+  }
+
+  TextureContainer container;
+  if (!ParseTextureContainer(file.GetData(), file.GetSize(), &container)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unsupported texture container %S", path.string().c_str());
+    return;
+  }
+
+  TextureIdentifier identifier;
+  identifier.Hash = std::hash<std::string>()(name);
+  identifier.Texture = Rendering::Texture::Create(identifier.Hash, container.Type, container.Format, container.Width, container.Height,
+                                                  container.MipLevels, container.ArraySize, container.Subresources, device);
+
+  if (!identifier.Texture.IsValid()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error creating texture %S", name.c_str());
+    return;
+  }
+
+  textures->emplace_back(std::move(identifier));
+}
+
+// Textures with the same size, format and mip count become slices of a single texture array
+void PackTextureArrays(const std::vector<LoadedTexture>& loaded_textures, ID3D11Device* device,
+                       std::vector<TextureIdentifier>* textures, std::vector<size_t>* remaining) {
+  std::map<std::tuple<uint32_t, uint32_t, DXGI_FORMAT, size_t>, std::vector<size_t>> groups;
+  for (size_t i = 0; i < loaded_textures.size(); ++i) {
+    const auto& top_level = loaded_textures[i].Data[0];
+    groups[std::make_tuple(top_level.Width, top_level.Height, top_level.Format, loaded_textures[i].Data.size())].push_back(i);
+  }
+
+  for (const auto& group : groups) {
+    const auto& members = group.second;
+    if (members.size() < 2) {
+      remaining->insert(std::end(*remaining), std::begin(members), std::end(members));
+      continue;
+    }
+
+    size_t array_hash = 0;
+    std::vector<std::vector<Rendering::Texture::ImageData>> slices;
+    for (auto member : members) {
+      hash_combine(array_hash, loaded_textures[member].Hash);
+      slices.push_back(loaded_textures[member].Data);
+    }
+
+    auto array_texture = Rendering::Texture::CreateArray(array_hash, slices, device);
+    if (!array_texture.IsValid()) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating a texture array of %llu textures", members.size());
+      remaining->insert(std::end(*remaining), std::begin(members), std::end(members));
+      continue;
+    }
+
+    for (size_t layer = 0; layer < members.size(); ++layer) {
+      TextureIdentifier identifier;
+      identifier.Hash = loaded_textures[members[layer]].Hash;
+      identifier.Texture = array_texture;
+      identifier.Layer = static_cast<uint32_t>(layer);
+      textures->emplace_back(std::move(identifier));
+    }
+  }
+}
+
+// Levels an atlas entry keeps, 0 when its mips can't be kept - the top size has to be a multiple of 2^(levels - 1)
+// and every kept level half the size of the one above, so each level covers its rect in the atlas exactly
+uint32_t GetAtlasMipLevels(const std::vector<Rendering::Texture::ImageData>& data) {
+  auto levels = std::min(static_cast<uint32_t>(data.size()), AtlasMaxMipLevels);
+  auto alignment = 1u << (levels - 1);
+  if (data[0].Width % alignment != 0 || data[0].Height % alignment != 0) {
+    return 0;
+  }
+
+  for (uint32_t level = 1; level < levels; ++level) {
+    if (data[level].Width != data[0].Width >> level || data[level].Height != data[0].Height >> level) {
+      return 0;
+    }
+  }
+
+  return levels;
+}
+
+// Small uncompressed textures that are left over are bin packed into an atlas per format and mip count. Entries keep
+// up to AtlasMaxMipLevels levels, their border is scaled so it is still a texel wide in the smallest one.
+void PackTextureAtlases(const std::vector<LoadedTexture>& loaded_textures, const std::vector<size_t>& candidates, ID3D11Device* device,
+                        std::vector<TextureIdentifier>* textures, std::vector<size_t>* remaining) {
+  std::map<std::pair<DXGI_FORMAT, uint32_t>, std::vector<size_t>> groups;
+  for (auto candidate : candidates) {
+    const auto& data = loaded_textures[candidate].Data;
+    bool is_small = data[0].Width <= AtlasMaxTextureSize && data[0].Height <= AtlasMaxTextureSize;
+    auto mip_levels = GetAtlasMipLevels(data);
+    if (is_small && mip_levels > 0 && !Rendering::BlockCompression::IsBlockCompressed(data[0].Format)) {
+      groups[std::make_pair(data[0].Format, mip_levels)].push_back(candidate);
+    } else {
+      remaining->push_back(candidate);
+    }
+  }
+
+  for (const auto& group : groups) {
+    const auto& members = group.second;
+    auto format = group.first.first;
+    auto mip_levels = group.first.second;
+    auto padding = AtlasPadding << (mip_levels - 1);
+
+    std::vector<Rendering::Texture::ImageData> images;
+    size_t atlas_hash = 0;
+    for (auto member : members) {
+      images.push_back(loaded_textures[member].Data[0]);
+      hash_combine(atlas_hash, loaded_textures[member].Hash);
+    }
+
+    std::vector<Rendering::TextureAtlas::Rect> rects;
+    uint32_t atlas_width;
+    uint32_t atlas_height;
+    if (members.size() < 2 || !Rendering::TextureAtlas::Pack(images, padding, AtlasMaxSize, &rects, &atlas_width, &atlas_height)) {
+      remaining->insert(std::end(*remaining), std::begin(members), std::end(members));
+      continue;
+    }
+
+    auto components = images[0].Components;
+    std::vector<std::vector<unsigned char>> atlas_level_data(mip_levels);
+    std::vector<Rendering::Texture::ImageData> atlas_levels;
+    for (uint32_t level = 0; level < mip_levels; ++level) {
+      auto level_width = atlas_width >> level;
+      auto level_height = atlas_height >> level;
+      atlas_level_data[level].resize(static_cast<size_t>(level_width) * level_height * components, 0);
+
+      for (size_t i = 0; i < members.size(); ++i) {
+        const auto& level_image = loaded_textures[members[i]].Data[level];
+        auto level_rect = Rendering::TextureAtlas::GetLevelRect(rects[i], level);
+        Rendering::TextureAtlas::Blit(level_image, level_rect, padding >> level, level_width, atlas_level_data[level].data());
+      }
+
+      atlas_levels.emplace_back(level_width, level_height, components, format, atlas_level_data[level].data());
+    }
+
+    auto atlas_texture = Rendering::Texture::Create(atlas_hash, atlas_levels, device);
+    if (!atlas_texture.IsValid()) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating a texture atlas of %llu textures", static_cast<uint64_t>(members.size()));
+      remaining->insert(std::end(*remaining), std::begin(members), std::end(members));
+      continue;
+    }
+
+    for (size_t i = 0; i < members.size(); ++i) {
+      TextureIdentifier identifier;
+      identifier.Hash = loaded_textures[members[i]].Hash;
+      identifier.Texture = atlas_texture;
+      identifier.UvScaleOffset = Rendering::TextureAtlas::GetUvScaleOffset(rects[i], atlas_width, atlas_height);
+      textures->emplace_back(std::move(identifier));
+    }
+  }
+}
+
+void PackTextures(const std::vector<LoadedTexture>& loaded_textures, ID3D11Device* device, std::vector<TextureIdentifier>* textures) {
+  std::vector<size_t> array_leftovers;
+  PackTextureArrays(loaded_textures, device, textures, &array_leftovers);
+
+  std::vector<size_t> atlas_leftovers;
+  PackTextureAtlases(loaded_textures, array_leftovers, device, textures, &atlas_leftovers);
+
+  for (auto leftover : atlas_leftovers) {
+    CreateSingleTexture(loaded_textures[leftover], device, textures);
+  }
+}
+
+// Decoding, mip generation and compression are independent per texture, so textures are spread over all cores
+void ReadTextures(const std::vector<TextureRequest>& requests, const filesystem::path& base_path, std::vector<LoadedTexture>* loaded_textures) {
+  if (requests.empty()) {
+    return;
+  }
+
+  std::vector<LoadedTexture> results(requests.size());
+  std::vector<uint8_t> results_ok(requests.size(), 0);
+
+  auto read_start = std::chrono::high_resolution_clock::now();
+  auto worker_count = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), static_cast<uint32_t>(requests.size()));
+
+  // Every source file is requested up front, workers decode a texture as soon as its files have landed. The batch is
+  // declared after the buffers so it finishes with them first.
+  std::vector<TextureSources> sources(requests.size());
+  Core::ReadBatch batch;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    QueueTextureSources(requests[i], base_path, &batch, &sources[i]);
+  }
+  batch.Submit();
+
+  auto run_worker = [&](uint32_t worker_index) {
+    for (size_t i = worker_index; i < requests.size(); i += worker_count) {
+      results[i].Name = requests[i].Name;
+      results[i].Hash = std::hash<std::string>()(requests[i].Name);
+      results_ok[i] = WaitTextureSources(&batch, sources[i]) && ReadTexture(requests[i].Name, sources[i], requests[i].Options, base_path, &results[i]);
+
+      // Decoded, the files are no longer needed while the other textures load
+      std::vector<std::vector<uint8_t>>().swap(sources[i].Files);
+    }
+  };
+
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
+
+  run_worker(0);
+
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  std::chrono::duration<double, std::milli> wall_time = std::chrono::high_resolution_clock::now() - read_start;
+  size_t decoded_bytes = 0;
+  double decode_milliseconds = 0.0;
+  for (const auto& result : results) {
+    decoded_bytes += result.Decode.Bytes;
+    decode_milliseconds += result.Decode.Milliseconds;
+  }
+
+  // Per thread throughput is what sizes the loading pool, the wall time shows how well the textures spread
+  if (decode_milliseconds > 0.0) {
+    auto megabytes = static_cast<double>(decoded_bytes) / (1024.0 * 1024.0);
+    DXFW_TRACE(__FILE__, __LINE__, false, "Decoded %.2f MB of texels in %.2f ms of %u threads, %.2f MB/s per thread, %.2f ms wall time",
+               megabytes, decode_milliseconds, worker_count, megabytes / (decode_milliseconds / 1000.0), wall_time.count());
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (!results_ok[i] || results[i].Data.empty()) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading texture %S", requests[i].Name.c_str());
+      continue;
+    }
+
+    loaded_textures->emplace_back(std::move(results[i]));
+  }
+}
+
+struct StreamingTexture {
+  Rendering::Texture::Handle Handle;
+  LoadedTexture Texture;
+};
+
+std::mutex g_streaming_mutex_;
+std::vector<StreamingTexture> g_decoded_textures_;  // Filled by the streaming worker
+std::future<void> g_streaming_worker_;
+std::atomic<bool> g_stop_streaming_ { false };
+std::chrono::high_resolution_clock::time_point g_streaming_start_;
+
+void StartTextureStreaming(std::vector<TextureRequest> requests, std::vector<Rendering::Texture::Handle> handles, const filesystem::path& base_path) {
+  StopTextureStreaming();
+
+  g_stop_streaming_ = false;
+  g_streaming_start_ = std::chrono::high_resolution_clock::now();
+
+  // One texture at a time - block compression already spreads a single texture over all cores. The files of the next
+  // texture are read while the current one decodes.
+  g_streaming_worker_ = std::async(std::launch::async, [requests = std::move(requests), handles = std::move(handles), base_path]() {
+    TextureSources next_sources;
+    std::unique_ptr<Core::ReadBatch> next_batch;
+
+    auto queue_next = [&](size_t index) {
+      next_sources = TextureSources();
+      next_batch = std::make_unique<Core::ReadBatch>();
+      if (index < requests.size()) {
+        QueueTextureSources(requests[index], base_path, next_batch.get(), &next_sources);
+        next_batch->Submit();
+      }
+    };
+
+    queue_next(0);
+
+    for (size_t i = 0; i < requests.size() && !g_stop_streaming_; ++i) {
+      auto sources = std::move(next_sources);
+      auto batch = std::move(next_batch);
+      queue_next(i + 1);
+
+      StreamingTexture streaming_texture;
+      streaming_texture.Handle = handles[i];
+      streaming_texture.Texture.Name = requests[i].Name;
+      streaming_texture.Texture.Hash = std::hash<std::string>()(requests[i].Name);
+
+      bool read_ok = WaitTextureSources(batch.get(), sources) && ReadTexture(requests[i].Name, sources, requests[i].Options, base_path, &streaming_texture.Texture);
+      if (!read_ok || streaming_texture.Texture.Data.empty()) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Error streaming texture %S", requests[i].Name.c_str());
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock(g_streaming_mutex_);
+      g_decoded_textures_.emplace_back(std::move(streaming_texture));
+    }
+  });
+}
+
+void UpdateTextureStreaming(ID3D11Device* device, ID3D11DeviceContext* context) {
+  if (!g_streaming_worker_.valid()) {
+    return;
+  }
+
+  std::vector<StreamingTexture> decoded_textures;
+  {
+    std::lock_guard<std::mutex> lock(g_streaming_mutex_);
+    std::swap(decoded_textures, g_decoded_textures_);
+  }
+
+  // The residency manager keeps the decoded levels as its backing store and uploads them as draws ask for them
+  for (auto& decoded_texture : decoded_textures) {
+    auto owner = std::make_shared<LoadedTexture>(std::move(decoded_texture.Texture));
+    if (!Rendering::TextureResidency::Register(decoded_texture.Handle, owner->Data, owner, device, context)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error uploading streamed texture %S", owner->Name.c_str());
+    }
+  }
+
+  bool worker_done = g_streaming_worker_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  if (worker_done) {
+    std::lock_guard<std::mutex> lock(g_streaming_mutex_);
+    if (g_decoded_textures_.empty()) {
+      g_streaming_worker_.get();
+      std::chrono::duration<double, std::milli> streaming_time = std::chrono::high_resolution_clock::now() - g_streaming_start_;
+      DXFW_TRACE(__FILE__, __LINE__, false, "Texture streaming finished decoding after %.2f ms", streaming_time.count());
+    }
+  }
+}
+
+void StopTextureStreaming() {
+  g_stop_streaming_ = true;
+  if (g_streaming_worker_.valid()) {
+    g_streaming_worker_.get();
+  }
+
+  g_decoded_textures_.clear();
+}
+
+TextureIndex BuildTextureIndex(const std::vector<TextureIdentifier>& textures) {
+  TextureIndex index;
+  index.reserve(textures.size());
+  for (const auto& texture : textures) {
+    index.emplace(texture.Hash, &texture);
+  }
+  return index;
 }
 
 bool ReadTexturesFromJson(const nlohmann::json& json_textures, const filesystem::path& base_path, ID3D11Device* device, std::vector<TextureIdentifier>* textures) {
@@ -100,6 +697,14 @@ bool ReadTexturesFromJson(const nlohmann::json& json_textures, const filesystem:
     return false;
   }
 
+  bool pack = false;
+  Core::ReadBool(json_textures.value("pack", nlohmann::json(false)), &pack);
+
+  bool streaming = false;
+  Core::ReadBool(json_textures.value("streaming", nlohmann::json(false)), &streaming);
+
+  std::vector<TextureRequest> requests;
+
   for (const auto& json_texture : json_textures_array) {
     if (!json_texture.is_object()) {
       DXFW_TRACE(__FILE__, __LINE__, false, "Invalid textures entry %S", json_texture.dump().c_str());
@@ -118,21 +723,83 @@ bool ReadTexturesFromJson(const nlohmann::json& json_textures, const filesystem:
       continue;
     }
 
-    TextureIdentifier identifier;
-    identifier.Hash = std::hash<std::string>()(*json_texture_name_it);
+    if (json_texture_path_it->is_string()) {
+      filesystem::path container_path = base_path / json_texture_path_it->get<std::string>();
+      if (IsTextureContainer(container_path)) {
+        CreateContainerTexture(*json_texture_name_it, container_path, device, textures);
+        continue;
+      }
+    }
+
+    TextureRequest request;
+    request.Name = *json_texture_name_it;
 
     if (json_texture_path_it->is_string()) {
-      identifier.Texture = ReadSingleTexture(identifier.Hash, *json_texture_path_it, base_path, device);
-    } else {  // Array
-      identifier.Texture = ReadMipmapTexture(identifier.Hash, *json_texture_path_it, base_path, device);
+      request.Filenames.push_back(*json_texture_path_it);
+    } else {  // Array of mip levels
+      for (const auto& path : *json_texture_path_it) {
+        request.Filenames.push_back(path);
+      }
     }
 
-    if (!identifier.Texture.IsValid()) {
-      DXFW_TRACE(__FILE__, __LINE__, false, "Error creating texture %S", json_texture_name_it->dump().c_str());
-      continue;
+    request.Options.Compression = json_texture.value("compression", "none");
+    request.Options.ColorSpace = json_texture.value("color_space", "auto");
+    Core::ReadBool(json_texture.value("generate_mips", nlohmann::json(true)), &request.Options.GenerateMips);
+
+    requests.emplace_back(std::move(request));
+  }
+
+  if (streaming) {
+    if (pack) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Streamed textures are not packed", nullptr);
     }
 
-    textures->emplace_back(std::move(identifier));
+    std::vector<TextureRequest> streamed_requests;
+    std::vector<Rendering::Texture::Handle> handles;
+    for (auto& request : requests) {
+      if (request.Filenames.empty()) {
+        continue;
+      }
+
+      // Only the image header is read here, the placeholder needs the channel count of the final texture
+      int width;
+      int height;
+      int components;
+      Core::AssetFile first_file;
+      bool header_ok = first_file.Open(base_path / request.Filenames[0])
+                    && stbi_info_from_memory(first_file.GetData(), static_cast<int>(first_file.GetSize()), &width, &height, &components);
+      if (!header_ok) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Error reading image header of texture %S", request.Name.c_str());
+        continue;
+      }
+
+      TextureIdentifier identifier;
+      identifier.Hash = std::hash<std::string>()(request.Name);
+      identifier.Texture = Rendering::Texture::CreatePlaceholder(identifier.Hash, StbiComponentsToDxgiFormat(components), device);
+
+      if (!identifier.Texture.IsValid()) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Error creating placeholder for texture %S", request.Name.c_str());
+        continue;
+      }
+
+      handles.push_back(identifier.Texture);
+      streamed_requests.emplace_back(std::move(request));
+      textures->emplace_back(std::move(identifier));
+    }
+
+    StartTextureStreaming(std::move(streamed_requests), std::move(handles), base_path);
+    return true;
+  }
+
+  std::vector<LoadedTexture> loaded_textures;
+  ReadTextures(requests, base_path, &loaded_textures);
+
+  if (pack) {
+    PackTextures(loaded_textures, device, textures);
+  } else {
+    for (const auto& loaded_texture : loaded_textures) {
+      CreateSingleTexture(loaded_texture, device, textures);
+    }
   }
 
   return true;
@@ -1,22 +1,43 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #pragma warning(push)
 #pragma warning(disable: 4706)
 #include <nlohmann/json.hpp>
 #pragma warning(pop)
 
+#include <DirectXMath.h>
+
 #include "core/filesystem.h"
 #include "rendering/texture.h"
 
 namespace Loaders {
 
+// Packed textures share their Texture handle - Layer picks the array slice and UvScaleOffset the atlas region
 struct TextureIdentifier {
   size_t Hash;
   Rendering::Texture::Handle Texture;
+  uint32_t Layer = 0;
+  DirectX::XMFLOAT4 UvScaleOffset = { 1.0f, 1.0f, 0.0f, 0.0f };
 };
 
+// Texture identifiers by name hash, built once per load so material lookups don't scan the whole list. The first
+// identifier wins when names repeat.
+using TextureIndex = std::unordered_map<size_t, const TextureIdentifier*>;
+
+TextureIndex BuildTextureIndex(const std::vector<TextureIdentifier>& textures);
+
 bool ReadTexturesFromFile(const filesystem::path& textures_path, const filesystem::path& base_path, ID3D11Device* device, std::vector<TextureIdentifier>* textures);
 
 bool ReadTexturesFromJson(const nlohmann::json& json_textures, const filesystem::path& base_path, ID3D11Device* device, std::vector<TextureIdentifier>* textures);
 
+// Texture files with "streaming" set hand out placeholder textures right away and decode on a background thread.
+// Call once per frame - hands the decoded textures to the residency manager, which uploads their levels on demand.
+void UpdateTextureStreaming(ID3D11Device* device, ID3D11DeviceContext* context);
+
+// Waits for the background thread, textures that haven't arrived keep showing their placeholder
+void StopTextureStreaming();
+
 }  // namespace Loaders
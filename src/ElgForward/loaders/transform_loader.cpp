@@ -10,8 +10,6 @@
 #include <dxfw/dxfw.h>
 
 #include "core/json_helpers.h"
-#include "rendering/constant_buffer.h"
-#include "rendering/typed_constant_buffer.h"
 #include "rendering/transform.h"
 #include "rendering/transform_and_inverse_transpose.h"
 
@@ -19,67 +17,91 @@ using namespace Rendering;
 
 namespace Loaders {
 
-bool ReadTransform(const std::string& parent_name, const nlohmann::json& json_transform, ID3D11Device* device, Rendering::Transform::Transform* transform) {
-  // Translation
-  DirectX::XMMATRIX translation = DirectX::XMMatrixIdentity();
-  DirectX::XMMATRIX translation_inverse = DirectX::XMMatrixIdentity();
+bool ReadTransformDescription(const nlohmann::json& json_transform, TransformDescription* description) {
+  if (!json_transform.is_object()) {
+    return false;
+  }
 
   const auto& json_translation = json_transform["translation"];
+  description->HasTranslation = Core::ReadFloat3(json_translation, description->Translation);
+  if (!description->HasTranslation) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable translation %S", json_translation.dump().c_str());
+  }
 
-  float translation_values[3];
-  if (Core::ReadFloat3(json_translation, translation_values)) {
-    translation = DirectX::XMMatrixTranslation(translation_values[0], translation_values[1], translation_values[2]);
-    translation_inverse = DirectX::XMMatrixTranslation(-translation_values[0], -translation_values[1], -translation_values[2]);
+  const auto& json_rotation = json_transform["rotation"];
+  if (Core::ReadFloat3(json_rotation, description->Rotation)) {
+    description->RotationSize = 3;
+  } else if (Core::ReadFloat4(json_rotation, description->Rotation)) {
+    description->RotationSize = 4;
   } else {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable translation %S", json_translation.dump().c_str());
+    description->RotationSize = 0;
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable rotation %S", json_rotation.dump().c_str());
+  }
+
+  const auto& json_scale = json_transform["scale"];
+  description->HasScale = Core::ReadFloat3(json_scale, description->Scale);
+  if (!description->HasScale) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable scaling %S", json_scale.dump().c_str());
+  }
+
+  return true;
+}
+
+Rendering::Transform::TransformAndInverseTranspose ComputeTransform(const TransformDescription& description) {
+  // Translation
+  DirectX::XMMATRIX translation = DirectX::XMMatrixIdentity();
+  DirectX::XMMATRIX translation_inverse = DirectX::XMMatrixIdentity();
+
+  if (description.HasTranslation) {
+    const auto* values = description.Translation;
+    translation = DirectX::XMMatrixTranslation(values[0], values[1], values[2]);
+    translation_inverse = DirectX::XMMatrixTranslation(-values[0], -values[1], -values[2]);
   }
 
   // Rotation
   DirectX::XMMATRIX rotation = DirectX::XMMatrixIdentity();
 
-  const auto& json_rotation = json_transform["rotation"];
-
-  float rotation_values[4];
-  if (Core::ReadFloat3(json_rotation, rotation_values)) {
+  const auto* rotation_values = description.Rotation;
+  if (description.RotationSize == 3) {
     rotation = DirectX::XMMatrixRotationRollPitchYaw(rotation_values[0], rotation_values[1], rotation_values[2]);
-  } else if (Core::ReadFloat4(json_rotation, rotation_values)) {
+  } else if (description.RotationSize == 4) {
     auto axis = DirectX::XMVectorSet(rotation_values[0], rotation_values[1], rotation_values[2], 0.0f);
     rotation = DirectX::XMMatrixRotationAxis(axis, DirectX::XMConvertToRadians(rotation_values[3]));
-  } else {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable rotation %S", json_rotation.dump().c_str());
   }
 
   // Scaling
   DirectX::XMMATRIX scaling = DirectX::XMMatrixIdentity();
   DirectX::XMMATRIX scaling_inverse = DirectX::XMMatrixIdentity();
 
-  const auto& json_scale = json_transform["scale"];
-
-  float scale_values[3];
-  if (Core::ReadFloat3(json_scale, scale_values)) {
-    scaling = DirectX::XMMatrixScaling(scale_values[0], scale_values[1], scale_values[2]);
-    scaling_inverse = DirectX::XMMatrixScaling(1.0f / scale_values[0], 1.0f / scale_values[1], 1.0f / scale_values[2]);
-  } else {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid drawable scaling %S", json_scale.dump().c_str());
+  if (description.HasScale) {
+    const auto* values = description.Scale;
+    scaling = DirectX::XMMatrixScaling(values[0], values[1], values[2]);
+    scaling_inverse = DirectX::XMMatrixScaling(1.0f / values[0], 1.0f / values[1], 1.0f / values[2]);
   }
 
   // Transform
-  Rendering::Transform::TransformAndInverseTranspose transform_data;
+  Rendering::Transform::TransformAndInverseTranspose matrices;
+  matrices.Matrix = scaling * rotation * translation;
+  matrices.MatrixInverseTranspose = scaling_inverse * rotation * DirectX::XMMatrixTranspose(translation_inverse);
+  return matrices;
+}
 
-  transform_data.Matrix = scaling * rotation * translation;
-  transform_data.MatrixInverseTranspose = scaling_inverse * rotation * DirectX::XMMatrixTranspose(translation_inverse);
+bool CreateTransform(const Rendering::Transform::TransformAndInverseTranspose& matrices, Rendering::Transform::Transform* transform) {
+  *transform = Rendering::Transform::Create(matrices);
+  return transform->IsValid();
+}
 
-  // Constant buffer
-  std::string cpu_name = parent_name + " transform";
-  std::string gpu_name = "transform";
-  auto transform_constant_buffer = Rendering::ConstantBuffer::Create(cpu_name, gpu_name, &transform_data, device);
-  if (!transform_constant_buffer.IsValid()) {
+bool CreateTransform(const TransformDescription& description, Rendering::Transform::Transform* transform) {
+  return CreateTransform(ComputeTransform(description), transform);
+}
+
+bool ReadTransform(const nlohmann::json& json_transform, Rendering::Transform::Transform* transform) {
+  TransformDescription description;
+  if (!ReadTransformDescription(json_transform, &description)) {
     return false;
   }
 
-  transform->TransformConstantBuffer = static_cast<Rendering::ConstantBuffer::Handle>(transform_constant_buffer);
-
-  return true;
+  return CreateTransform(description, transform);
 }
 
 }  // namespace Loaders
@@ -7,9 +7,29 @@
 
 #include "core/filesystem.h"
 #include "rendering/transform.h"
+#include "rendering/transform_and_inverse_transpose.h"
 
 namespace Loaders {
 
-bool ReadTransform(const std::string& parent_name, const nlohmann::json& json_transform, ID3D11Device* device, Rendering::Transform::Transform* transform);
+// Transform values as written in scene files, a missing value leaves that part of the transform as identity
+struct TransformDescription {
+  float Translation[3];
+  bool HasTranslation = false;
+  float Rotation[4];
+  uint32_t RotationSize = 0;  // 3 for roll, pitch and yaw or 4 for an axis and an angle in degrees
+  float Scale[3];
+  bool HasScale = false;
+};
+
+bool ReadTransformDescription(const nlohmann::json& json_transform, TransformDescription* description);
+
+Rendering::Transform::TransformAndInverseTranspose ComputeTransform(const TransformDescription& description);
+
+// Adds the matrices to the object transform table, so any number of drawables can have their own transform
+bool CreateTransform(const Rendering::Transform::TransformAndInverseTranspose& matrices, Rendering::Transform::Transform* transform);
+
+bool CreateTransform(const TransformDescription& description, Rendering::Transform::Transform* transform);
+
+bool ReadTransform(const nlohmann::json& json_transform, Rendering::Transform::Transform* transform);
 
 }  // namespace Loaders
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -9,27 +11,36 @@
 #include <dxgi.h>
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <D3Dcompiler.h>
 #include <wrl.h>
 #endif
 
 #include "core/assert.h"
 #include "core/filesystem.h"
+#include "core/pack_archive.h"
+#include "core/read_batch.h"
 #include "dxfw/dxfw_wrapper.h"
 #include "dxfw/dxfw_helpers.h"
 #include "rendering/constant_buffer.h"
 #include "rendering/lens/perspective_lens.h"
 #include "rendering/cameras/trackball_camera.h"
 #include "rendering/lights/directional_light.h"
+#include "rendering/lights/light_clustering.h"
+#include "rendering/lights/light_culling.h"
 #include "rendering/lights/point_light.h"
 #include "rendering/lights/spot_light.h"
 #include "rendering/materials/basic.h"
 #include "rendering/mesh.h"
 #include "rendering/vertex_layout.h"
 #include "rendering/drawable.h"
+#include "rendering/per_object.h"
 #include "rendering/screen.h"
+#include "rendering/texture_residency.h"
 #include "shaders/registers.h"
+#include "loaders/scene_compiler.h"
 #include "loaders/scene_loader.h"
+#include "loaders/texture_loader.h"
 #include "directx_state.h"
 #include "scene.h"
 
@@ -168,32 +179,6 @@ bool InitializeRenderTarget(DirectXState* state, uint32_t width, uint32_t height
   return true;
 }
 
-bool InitalizeDepthStencilState(DirectXState* state) {
-  // Depth/stencil state settings
-  D3D11_DEPTH_STENCIL_DESC desc;
-  ZeroMemory(&desc, sizeof(desc));
-
-  desc.DepthEnable = true;
-  desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-  desc.DepthFunc = D3D11_COMPARISON_LESS;
-
-  desc.StencilEnable = false;
-  desc.StencilReadMask = 0xFF;
-  desc.StencilWriteMask = 0xFF;
-
-  // Create depth/stencil state
-  auto depth_stencil_state_result = state->device->CreateDepthStencilState(&desc, state->depth_stencil_state.GetAddressOf());
-  if (FAILED(depth_stencil_state_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, depth_stencil_state_result);
-    return false;
-  }
-
-  // Set the state
-  state->device_context->OMSetDepthStencilState(state->depth_stencil_state.Get(), 1);
-
-  return true;
-}
-
 bool InitializeSamplers(DirectXState* state) {
   // Linear sampler
   D3D11_SAMPLER_DESC linear_sampler_desc;
@@ -240,12 +225,6 @@ bool InitializeDirect3d11(DirectXState* state) {
     return false;
   }
 
-  // Create the depth/stencil state
-  bool depth_stencil_ok = InitalizeDepthStencilState(state);
-  if (!depth_stencil_ok) {
-    return false;
-  }
-
   // Create samplers
   bool samplers_ok = InitializeSamplers(state);
   if (!samplers_ok) {
@@ -288,6 +267,14 @@ bool InitializeDirect3d11(DirectXState* state) {
   return true;
 }
 
+const uint32_t ClusterTileCountX = 16;
+const uint32_t ClusterTileCountY = 8;
+const uint32_t ClusterSliceCount = 24;
+const uint32_t MaxLightsPerCluster = 32;
+const size_t MaxGpuLights = 1000;
+const size_t MaxVisibleDrawables = 65536;
+const size_t TextureBudgetBytes = 256 * 1024 * 1024;
+
 bool InitializeScene(DirectXState* state, Scene* scene) {
   scene->PerFrameConstantBuffer = ConstantBuffer::Create<PerFrame>("PerFrameConstants", nullptr, state->device.Get());
   if (!scene->PerFrameConstantBuffer.IsValid()) {
@@ -299,62 +286,103 @@ bool InitializeScene(DirectXState* state, Scene* scene) {
     return false;
   }
 
-  scene->DirectionalLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::DirectionalLight>("DirectionalLights", 1000, nullptr, 0, state->device.Get());
+  scene->DirectionalLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::DirectionalLight>("DirectionalLights", MaxGpuLights, nullptr, 0, state->device.Get());
   if (!scene->DirectionalLightsStructuredBuffer.IsValid()) {
     return false;
   }
 
-  scene->SpotLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::SpotLight>("SpotLights", 1000, nullptr, 0, state->device.Get());
+  scene->SpotLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::GpuSpotLight>("SpotLights", MaxGpuLights, nullptr, 0, state->device.Get());
   if (!scene->SpotLightsStructuredBuffer.IsValid()) {
     return false;
   }
 
-  scene->PointLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::PointLight>("PointLights", 1000, nullptr, 0, state->device.Get());
+  scene->PointLightsStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::GpuPointLight>("PointLights", MaxGpuLights, nullptr, 0, state->device.Get());
   if (!scene->PointLightsStructuredBuffer.IsValid()) {
     return false;
   }
 
+  auto cluster_count = ClusterTileCountX * ClusterTileCountY * ClusterSliceCount;
+  scene->ClustersStructuredBuffer = StructuredBuffer::Create<Rendering::Lights::Cluster>("Clusters", cluster_count, nullptr, 0, state->device.Get());
+  if (!scene->ClustersStructuredBuffer.IsValid()) {
+    return false;
+  }
+
+  scene->ClusterLightIndicesStructuredBuffer = StructuredBuffer::Create<uint32_t>("ClusterLightIndices", cluster_count * MaxLightsPerCluster, nullptr, 0, state->device.Get());
+  if (!scene->ClusterLightIndicesStructuredBuffer.IsValid()) {
+    return false;
+  }
+  scene->LightClusterBuilder.SetMaxLightsPerCluster(MaxLightsPerCluster);
+
+  scene->PerDrawConstantBuffer = ConstantBuffer::Create<PerDraw>("PerDrawConstants", nullptr, state->device.Get());
+  if (!scene->PerDrawConstantBuffer.IsValid()) {
+    return false;
+  }
+
+  scene->ObjectsStructuredBuffer = StructuredBuffer::Create<PerObject>("Objects", MaxVisibleDrawables, nullptr, 0, state->device.Get());
+  if (!scene->ObjectsStructuredBuffer.IsValid()) {
+    return false;
+  }
+
+  // Filled by the material loader, which looks the buffer up by name
+  scene->BasicMaterialsStructuredBuffer = StructuredBuffer::Create<Rendering::Materials::GpuBasic>(Rendering::Materials::BasicMaterialTableName, Rendering::Materials::MaxBasicMaterials, nullptr, 0, state->device.Get());
+  if (!scene->BasicMaterialsStructuredBuffer.IsValid()) {
+    return false;
+  }
+
   return true;
 }
 
-void SetConstantBuffers(const Drawable& drawable, Scene* scene, DirectXState* state) {
+void SetFrameConstantBuffers(Scene* scene, DirectXState* state) {
   ID3D11Buffer* constant_buffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = { nullptr };
   constant_buffers[PER_FRAME_CONSTANT_BUFFER_REGISTER] = ConstantBuffer::GetGpuBuffer(scene->PerFrameConstantBuffer).Get();
   constant_buffers[PER_CAMERA_CONSTANT_BUFFER_REGISTER] = ConstantBuffer::GetGpuBuffer(scene->PerCameraConstantBuffer).Get();
-  constant_buffers[PER_OBJECT_CONSTANT_BUFFER_REGISTER] = drawable.GetTransformConstantBuffer();
-  constant_buffers[PER_MATERIAL_CONSTANT_BUFFER_REGISTER] = drawable.GetMaterialConstantBuffer();
+  constant_buffers[PER_DRAW_CONSTANT_BUFFER_REGISTER] = ConstantBuffer::GetGpuBuffer(scene->PerDrawConstantBuffer).Get();
   state->device_context->VSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, constant_buffers);
   state->device_context->PSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, constant_buffers);
+}
 
-  bool send_transforms_ok = drawable.SendTransformConstantBufferToGpu(state->device_context.Get());
-  if (!send_transforms_ok) {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Error sending the transform constant buffer data to GPU");
-  }
+// Transforms, lights and material indices are in the object structured buffer, a draw only selects its entry
+void SetObjectIndex(uint32_t object_index, Scene* scene, DirectXState* state) {
+  auto per_draw = ConstantBuffer::GetCpuBuffer(scene->PerDrawConstantBuffer);
+  per_draw->ObjectIndex = object_index;
 
-  bool send_material_ok = drawable.SendMaterialConstantBufferToGpu(state->device_context.Get());
-  if (!send_material_ok) {
-    DXFW_TRACE(__FILE__, __LINE__, false, "Error sending the transform constant buffer data to GPU");
+  bool send_per_draw_ok = ConstantBuffer::SendToGpu(scene->PerDrawConstantBuffer, state->device_context.Get());
+  if (!send_per_draw_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error sending the per draw constant buffer data to GPU");
   }
 }
 
-void SetShaderResources(const Drawable& drawable, Scene* scene, DirectXState* state) {
+// Material constants are uploaded when the material is created, so switching materials only rebinds the buffer
+void SetMaterialConstantBuffer(const Drawable& drawable, DirectXState* state) {
+  auto material_buffer = ConstantBuffer::GetGpuBuffer(drawable.MaterialConstantBuffer);
+  state->device_context->VSSetConstantBuffers(PER_MATERIAL_CONSTANT_BUFFER_REGISTER, 1, material_buffer.GetAddressOf());
+  state->device_context->PSSetConstantBuffers(PER_MATERIAL_CONSTANT_BUFFER_REGISTER, 1, material_buffer.GetAddressOf());
+}
+
+void SetFrameShaderResources(Scene* scene, DirectXState* state) {
   // Vertex shader
-  Core::ComArray<ID3D11ShaderResourceView, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> vs_shader_resources = {};
-  vs_shader_resources.Set(POINT_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->PointLightsStructuredBuffer).Get());
-  vs_shader_resources.Set(SPOT_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->SpotLightsStructuredBuffer).Get());
-  vs_shader_resources.Set(DIRECTIONAL_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->DirectionalLightsStructuredBuffer).Get());
-  
-  drawable.BuildVertexShaderResourceView(&vs_shader_resources);
-  state->device_context->VSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, &vs_shader_resources.Get(0));
+  ID3D11ShaderResourceView* vs_shader_resources[OBJECT_BUFFER_REGISTER + 1] = { nullptr };
+  vs_shader_resources[POINT_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->PointLightsStructuredBuffer).Get();
+  vs_shader_resources[SPOT_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->SpotLightsStructuredBuffer).Get();
+  vs_shader_resources[DIRECTIONAL_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->DirectionalLightsStructuredBuffer).Get();
+  vs_shader_resources[OBJECT_BUFFER_REGISTER] = GetShaderResourceView(scene->ObjectsStructuredBuffer).Get();
+  state->device_context->VSSetShaderResources(0, OBJECT_BUFFER_REGISTER + 1, vs_shader_resources);
 
   // Pixel shader
-  Core::ComArray<ID3D11ShaderResourceView, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> ps_shader_resources = {};
-  ps_shader_resources.Set(POINT_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->PointLightsStructuredBuffer).Get());
-  ps_shader_resources.Set(SPOT_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->SpotLightsStructuredBuffer).Get());
-  ps_shader_resources.Set(DIRECTIONAL_LIGHT_BUFFER_REGISTER, GetShaderResourceView(scene->DirectionalLightsStructuredBuffer).Get());
+  ID3D11ShaderResourceView* ps_shader_resources[OBJECT_BUFFER_REGISTER + 1] = { nullptr };
+  ps_shader_resources[POINT_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->PointLightsStructuredBuffer).Get();
+  ps_shader_resources[SPOT_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->SpotLightsStructuredBuffer).Get();
+  ps_shader_resources[DIRECTIONAL_LIGHT_BUFFER_REGISTER] = GetShaderResourceView(scene->DirectionalLightsStructuredBuffer).Get();
+  ps_shader_resources[CLUSTER_BUFFER_REGISTER] = GetShaderResourceView(scene->ClustersStructuredBuffer).Get();
+  ps_shader_resources[CLUSTER_LIGHT_INDEX_BUFFER_REGISTER] = GetShaderResourceView(scene->ClusterLightIndicesStructuredBuffer).Get();
+  ps_shader_resources[MATERIAL_BUFFER_REGISTER] = GetShaderResourceView(scene->BasicMaterialsStructuredBuffer).Get();
+  ps_shader_resources[OBJECT_BUFFER_REGISTER] = GetShaderResourceView(scene->ObjectsStructuredBuffer).Get();
+  state->device_context->PSSetShaderResources(0, OBJECT_BUFFER_REGISTER + 1, ps_shader_resources);
+}
 
-  drawable.BuildPixelShaderResourceView(&ps_shader_resources);
-  state->device_context->PSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, &ps_shader_resources.Get(0));
+void SetShaderResources(const Drawable& drawable, DirectXState* state) {
+  BindingSet::BindVertexShaderResources(drawable.VertexShaderBindingSet, state->device_context.Get());
+  BindingSet::BindPixelShaderResources(drawable.PixelShaderBindingSet, state->device_context.Get());
 }
 
 void Render(Scene* scene, DirectXState* state) {
@@ -363,64 +391,184 @@ void Render(Scene* scene, DirectXState* state) {
   
   state->device_context->ClearDepthStencilView(state->depth_stencil_view.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
-  for (auto& drawable : scene->Drawables) {
-    state->device_context->VSSetShader(drawable.GetVertexShader(), 0, 0);
-    state->device_context->PSSetShader(drawable.GetPixelShader(), 0, 0);
+  SetFrameConstantBuffers(scene, state);
+  SetFrameShaderResources(scene, state);
+
+  PipelineState::Handle bound_pipeline_state = {};
+  ConstantBuffer::Handle bound_material_constant_buffer = {};
+  // Only the drawables that passed culling in Update are drawn, their entries in the object buffer are in the same order
+  for (uint32_t object_index = 0; object_index < scene->VisibleDrawables.size(); ++object_index) {
+    auto& drawable = scene->Drawables[scene->VisibleDrawables[object_index]];
+    if (!bound_pipeline_state.IsValid() || bound_pipeline_state.CompactForm() != drawable.PipelineState.CompactForm()) {
+      PipelineState::Bind(drawable.PipelineState, state->device_context.Get());
+      bound_pipeline_state = drawable.PipelineState;
+    }
 
-    SetConstantBuffers(drawable, scene, state);
-    SetShaderResources(drawable, scene, state);
+    // Drawables using the material table fetch their parameters by index and have no material constant buffer
+    bool material_changed = !bound_material_constant_buffer.IsValid() || bound_material_constant_buffer.CompactForm() != drawable.MaterialConstantBuffer.CompactForm();
+    if (drawable.MaterialConstantBuffer.IsValid() && material_changed) {
+      SetMaterialConstantBuffer(drawable, state);
+      bound_material_constant_buffer = drawable.MaterialConstantBuffer;
+    }
 
-    state->device_context->IASetVertexBuffers(0,
-                                              D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT,
-                                              drawable.GetVertexBuffers(),
-                                              drawable.GetVertexBufferStrides(),
-                                              drawable.GetVertexBufferOffsets());
+    SetObjectIndex(object_index, scene, state);
+    SetShaderResources(drawable, state);
 
-    state->device_context->IASetIndexBuffer(drawable.GetIndexBuffer(), drawable.GetIndexBufferFormat(), 0);
-    state->device_context->IASetPrimitiveTopology(drawable.GetPrimitiveTopology());
+    Geometry::Bind(drawable.Geometry, state->device_context.Get());
 
-    state->device_context->IASetInputLayout(drawable.GetVertexLayout());
+    state->device_context->DrawIndexed(Geometry::GetIndexCount(drawable.Geometry), 0, 0);
+  }
+}
 
-    state->device_context->DrawIndexed(drawable.GetIndexCount(), 0, 0);
+void BuildGpuIndices(const std::vector<uint32_t>& source_indices, size_t visible_count, std::vector<uint32_t>* gpu_indices) {
+  gpu_indices->assign(source_indices.size(), Lights::InvalidGpuLightIndex);
+  for (size_t i = 0; i < visible_count; ++i) {
+    (*gpu_indices)[source_indices[i]] = static_cast<uint32_t>(i);
   }
 }
 
+void UpdateLightClusterBuffers(size_t visible_point_lights, size_t visible_spot_lights, Scene* scene, DirectXState* state) {
+  // Spheres are built from the unpacked lights so the cluster bounds keep full precision
+  auto& point_light_spheres = scene->PointLightSpheres;
+  point_light_spheres.clear();
+  for (size_t i = 0; i < visible_point_lights; ++i) {
+    point_light_spheres.emplace_back(Lights::GetBoundingSphere(scene->PointLights[scene->PointLightSourceIndices[i]]));
+  }
+
+  auto& spot_light_spheres = scene->SpotLightSpheres;
+  spot_light_spheres.clear();
+  for (size_t i = 0; i < visible_spot_lights; ++i) {
+    spot_light_spheres.emplace_back(Lights::GetBoundingSphere(scene->SpotLights[scene->SpotLightSourceIndices[i]]));
+  }
+
+  scene->LightClusterBuilder.Build(scene->LightClusterGrid, point_light_spheres.data(), point_light_spheres.size(),
+                                   spot_light_spheres.data(), spot_light_spheres.size());
+
+  const auto& clusters = scene->LightClusterBuilder.GetClusters();
+  const auto& light_indices = scene->LightClusterBuilder.GetLightIndices();
+
+  auto dropped_cluster_lights = scene->LightClusterBuilder.GetDroppedLightCount();
+  if (dropped_cluster_lights != scene->DroppedClusterLights && dropped_cluster_lights > 0) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "%llu light cluster entries exceed %u lights per cluster, they are skipped",
+               static_cast<uint64_t>(dropped_cluster_lights), MaxLightsPerCluster);
+  }
+  scene->DroppedClusterLights = dropped_cluster_lights;
+
+  // Every cluster is capped, so the lists of a full grid fit. Should they not, the clusters are uploaded empty,
+  // last frame's clusters would point into light buffers that have since been rewritten.
+  auto cluster_count = std::min(clusters.size(), GetMaxSize(scene->ClustersStructuredBuffer));
+  if (cluster_count == clusters.size() && light_indices.size() <= GetMaxSize(scene->ClusterLightIndicesStructuredBuffer)) {
+    std::copy(std::begin(clusters), std::end(clusters), GetCpuBuffer(scene->ClustersStructuredBuffer));
+    std::copy(std::begin(light_indices), std::end(light_indices), GetCpuBuffer(scene->ClusterLightIndicesStructuredBuffer));
+    SetCurrentSize(scene->ClusterLightIndicesStructuredBuffer, light_indices.size());
+  } else {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Light clusters exceed the cluster buffer sizes, they are left empty", "");
+    std::fill_n(GetCpuBuffer(scene->ClustersStructuredBuffer), cluster_count, Lights::Cluster());
+    SetCurrentSize(scene->ClusterLightIndicesStructuredBuffer, 0);
+  }
+  SetCurrentSize(scene->ClustersStructuredBuffer, cluster_count);
+
+  bool clusters_update_ok = SendToGpu(scene->ClustersStructuredBuffer, state->device_context.Get());
+  if (!clusters_update_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error updating light cluster buffer", "");
+  }
+
+  bool indices_update_ok = SendToGpu(scene->ClusterLightIndicesStructuredBuffer, state->device_context.Get());
+  if (!indices_update_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error updating light cluster index buffer", "");
+  }
+}
+
+void TraceDroppedLights(const char* light_type, size_t dropped_count, size_t max_count, size_t* last_dropped_count) {
+  if (dropped_count != *last_dropped_count && dropped_count > 0) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "%llu visible %s lights don't fit the light buffer of %llu, they are skipped",
+               static_cast<uint64_t>(dropped_count), light_type, static_cast<uint64_t>(max_count));
+  }
+  *last_dropped_count = dropped_count;
+}
+
 void UpdateFrameBuffers(Scene* scene, DirectXState* state) {
+  auto frustum = Lights::BuildViewSpaceFrustum(scene->Lens.GetProjectionMatrix());
+
   // Point lights
-  for(auto& point_light : scene->PointLightsStructuredBuffer) {
+  for (auto& point_light : scene->PointLights) {
     point_light.Update(scene->Camera.GetViewMatrix());
   }
-  
+
+  scene->PointLightSourceIndices.resize(scene->PointLights.size());
+  size_t dropped_point_lights;
+  auto visible_point_lights = Lights::CullPointLights(frustum, scene->PointLights.data(), scene->PointLights.size(),
+                                                      GetMaxSize(scene->PointLightsStructuredBuffer),
+                                                      GetCpuBuffer(scene->PointLightsStructuredBuffer), &scene->VisibleLights,
+                                                      scene->PointLightSourceIndices.data(), &dropped_point_lights);
+  TraceDroppedLights("point", dropped_point_lights, GetMaxSize(scene->PointLightsStructuredBuffer), &scene->DroppedPointLights);
+  SetCurrentSize(scene->PointLightsStructuredBuffer, visible_point_lights);
+  BuildGpuIndices(scene->PointLightSourceIndices, visible_point_lights, &scene->PointLightGpuIndices);
+
   bool point_update_ok = SendToGpu(scene->PointLightsStructuredBuffer, state->device_context.Get());
   if (!point_update_ok) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Error updating point light buffer", "");
   }
 
   // Spot lights
-  for (auto& spot_light : scene->SpotLightsStructuredBuffer) {
+  for (auto& spot_light : scene->SpotLights) {
     spot_light.Update(scene->Camera.GetViewMatrix());
   }
 
+  scene->SpotLightSourceIndices.resize(scene->SpotLights.size());
+  size_t dropped_spot_lights;
+  auto visible_spot_lights = Lights::CullSpotLights(frustum, scene->SpotLights.data(), scene->SpotLights.size(),
+                                                    GetMaxSize(scene->SpotLightsStructuredBuffer),
+                                                    GetCpuBuffer(scene->SpotLightsStructuredBuffer), &scene->VisibleLights,
+                                                    scene->SpotLightSourceIndices.data(), &dropped_spot_lights);
+  TraceDroppedLights("spot", dropped_spot_lights, GetMaxSize(scene->SpotLightsStructuredBuffer), &scene->DroppedSpotLights);
+  SetCurrentSize(scene->SpotLightsStructuredBuffer, visible_spot_lights);
+  BuildGpuIndices(scene->SpotLightSourceIndices, visible_spot_lights, &scene->SpotLightGpuIndices);
+
   bool spot_update_ok = SendToGpu(scene->SpotLightsStructuredBuffer, state->device_context.Get());
   if (!spot_update_ok) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Error updating spot light buffer", "");
   }
 
   // Directional lights
-  for (auto& directional_light : scene->DirectionalLightsStructuredBuffer) {
+  for (auto& directional_light : scene->DirectionalLights) {
     directional_light.Update(scene->Camera.GetViewMatrix());
   }
 
+  size_t dropped_directional_lights;
+  auto enabled_directional_lights = Lights::CullDirectionalLights(scene->DirectionalLights.data(), scene->DirectionalLights.size(),
+                                                                  GetMaxSize(scene->DirectionalLightsStructuredBuffer),
+                                                                  GetCpuBuffer(scene->DirectionalLightsStructuredBuffer),
+                                                                  &dropped_directional_lights);
+  TraceDroppedLights("directional", dropped_directional_lights, GetMaxSize(scene->DirectionalLightsStructuredBuffer),
+                     &scene->DroppedDirectionalLights);
+  SetCurrentSize(scene->DirectionalLightsStructuredBuffer, enabled_directional_lights);
+
   bool dir_update_ok = SendToGpu(scene->DirectionalLightsStructuredBuffer, state->device_context.Get());
   if (!dir_update_ok) {
     DXFW_TRACE(__FILE__, __LINE__, false, "Error updating directional light buffer", "");
   }
 
+  // Light clusters
+  UpdateLightClusterBuffers(visible_point_lights, visible_spot_lights, scene, state);
+
+  // Per object light lookup
+  scene->LightSpatialHash.Update(scene->PointLights, scene->SpotLights);
+
   // Light data buffer
   auto buffer = ConstantBuffer::GetCpuBuffer(scene->PerFrameConstantBuffer);
-  buffer->PointLightCount = static_cast<int>(GetCurrentSize(scene->PointLightsStructuredBuffer));
-  buffer->SpotLightCount = static_cast<int>(GetCurrentSize(scene->SpotLightsStructuredBuffer));
-  buffer->DirectionalLightCount = static_cast<int>(GetCurrentSize(scene->DirectionalLightsStructuredBuffer));
+  buffer->PointLightCount = static_cast<int>(visible_point_lights);
+  buffer->SpotLightCount = static_cast<int>(visible_spot_lights);
+  buffer->DirectionalLightCount = static_cast<int>(enabled_directional_lights);
+
+  const auto& grid = scene->LightClusterGrid;
+  buffer->ClusterCountX = grid.TileCountX;
+  buffer->ClusterCountY = grid.TileCountY;
+  buffer->ClusterCountZ = grid.SliceCount;
+  buffer->ClusterSliceScale = grid.GetSliceScale();
+  buffer->ClusterSliceBias = grid.GetSliceBias();
+  buffer->ClusterTileWidth = state->viewport.Width / static_cast<float>(grid.TileCountX);
+  buffer->ClusterTileHeight = state->viewport.Height / static_cast<float>(grid.TileCountY);
 
   bool update_ok = SendToGpu(scene->PerFrameConstantBuffer, state->device_context.Get());
   if (!update_ok) {
@@ -440,8 +588,35 @@ void UpdateCameraBuffers(Scene* scene, DirectXState* state) {
   }
 }
 
-void UpdateDrawableBuffers(Drawable* /* drawable */, Scene* /* scene */, DirectXState* /* state */) {
-  // Put update here
+// Projected diameter of the bounding sphere in pixels, the whole viewport once the camera is inside it
+float GetScreenSize(const DirectX::BoundingSphere& view_space_bounds, Scene* scene, DirectXState* state) {
+  auto depth = view_space_bounds.Center.z;
+  if (depth <= view_space_bounds.Radius) {
+    return state->viewport.Height;
+  }
+
+  DirectX::XMFLOAT4X4 projection;
+  DirectX::XMStoreFloat4x4(&projection, scene->Lens.GetProjectionMatrix());
+  return view_space_bounds.Radius * projection._22 / depth * state->viewport.Height;
+}
+
+// Returns false for drawables outside the frustum, object is only written for visible ones
+bool UpdateDrawableBuffers(Drawable* drawable, const DirectX::BoundingFrustum& frustum, Scene* scene, DirectXState* state, PerObject* object) {
+  DirectX::BoundingSphere view_space_bounds;
+  drawable->BoundingSphere.Transform(view_space_bounds, scene->Camera.GetViewMatrix());
+  if (!frustum.Intersects(view_space_bounds)) {
+    return false;
+  }
+
+  auto screen_size = GetScreenSize(view_space_bounds, scene, state);
+  TextureResidency::Touch(drawable->VertexShaderBindingSet, screen_size);
+  TextureResidency::Touch(drawable->PixelShaderBindingSet, screen_size);
+
+  object->Transform = Transform::Get(drawable->Transform);
+  object->MaterialIndex = drawable->MaterialIndex;
+
+  scene->LightSpatialHash.Query(drawable->BoundingSphere, scene->PointLightGpuIndices, scene->SpotLightGpuIndices, &object->Lights);
+  return true;
 }
 
 void Update(Scene* scene, DirectXState* state) {
@@ -456,15 +631,60 @@ void Update(Scene* scene, DirectXState* state) {
   scene->Lens.UpdateMatrices(aspect_ratio, &frustum_width, &frustum_height);
   scene->Camera.UpdateMatrices(frustum_width, frustum_height);
 
+  scene->LightClusterGrid = Lights::BuildClusterGrid(ClusterTileCountX, ClusterTileCountY, ClusterSliceCount,
+                                                     scene->Lens.GetNearPlane(), scene->Lens.GetFarPlane(),
+                                                     frustum_width, frustum_height);
+
   UpdateFrameBuffers(scene, state);
   UpdateCameraBuffers(scene, state);
 
-  for (auto& drawable : scene->Drawables) {
-    UpdateDrawableBuffers(&drawable, scene, state);
+  auto frustum = Lights::BuildViewSpaceFrustum(scene->Lens.GetProjectionMatrix());
+  auto objects = GetCpuBuffer(scene->ObjectsStructuredBuffer);
+  auto max_objects = GetMaxSize(scene->ObjectsStructuredBuffer);
+  size_t dropped_drawables = 0;
+
+  scene->VisibleDrawables.clear();
+  for (size_t i = 0; i < scene->Drawables.size(); ++i) {
+    if (scene->VisibleDrawables.size() == max_objects) {
+      PerObject unused;
+      dropped_drawables += UpdateDrawableBuffers(&scene->Drawables[i], frustum, scene, state, &unused) ? 1 : 0;
+    } else if (UpdateDrawableBuffers(&scene->Drawables[i], frustum, scene, state, &objects[scene->VisibleDrawables.size()])) {
+      scene->VisibleDrawables.push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  if (dropped_drawables != scene->DroppedDrawables && dropped_drawables > 0) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "%llu visible drawables don't fit the object buffer of %llu, they are skipped",
+               static_cast<uint64_t>(dropped_drawables), static_cast<uint64_t>(max_objects));
+  }
+  scene->DroppedDrawables = dropped_drawables;
+
+  SetCurrentSize(scene->ObjectsStructuredBuffer, scene->VisibleDrawables.size());
+  bool send_objects_ok = SendToGpu(scene->ObjectsStructuredBuffer, state->device_context.Get());
+  if (!send_objects_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error updating object buffer", "");
+  }
+}
+
+// A compiled scene next to the JSON file, loose or packed, is loaded instead as long as its sources haven't changed
+bool LoadScene(const filesystem::path& scene_path, const filesystem::path& base_path, DirectXState* state, Scene* scene) {
+  auto compiled_scene_path = filesystem::path(scene_path).replace_extension(".scene");
+
+  size_t compiled_scene_size;
+  bool has_compiled_scene = Core::GetAssetFileSize(compiled_scene_path, &compiled_scene_size);
+  if (has_compiled_scene && Loaders::LoadCompiledScene(compiled_scene_path, base_path, state, scene)) {
+    return true;
   }
+
+  return Loaders::LoadScene(scene_path, base_path, state, scene);
 }
 
-int main(int /* argc */, char** /* argv */) {
+int main(int argc, char** argv) {
+  // ElgForward --compile-scene <scene.json> <output.scene> writes a binary scene and exits
+  if (argc == 4 && std::string(argv[1]) == "--compile-scene") {
+    return Loaders::CompileScene(argv[2], GetBasePath(), argv[3]) ? 0 : -1;
+  }
+
   Dxfw::DxfwGuard dxfw_guard;
   if (!dxfw_guard.IsInitialized()) {
     return -1;
@@ -472,19 +692,40 @@ int main(int /* argc */, char** /* argv */) {
 
   auto base_path = GetBasePath();
 
+  // ElgPack <bin> <bin>/assets.pack <bin>/assets bundles the assets, files missing from it are still read from disk
+  auto pack_path = base_path / "assets.pack";
+  if (filesystem::exists(pack_path) && !Core::MountPackArchive(pack_path, base_path)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid asset pack %s", pack_path.string().c_str());
+  }
+
   DirectXState state;
   bool direct3d11_ok = InitializeDirect3d11(&state);
   if (!direct3d11_ok) {
     return -1;
   }
 
+  TextureResidency::SetBudget(TextureBudgetBytes);
+
   Scene scene;
   InitializeScene(&state, &scene);
-  Loaders::LoadScene(base_path / "assets/scenes/cube.json", base_path, &state, &scene);
+  LoadScene(base_path / "assets/scenes/cube.json", base_path, &state, &scene);
+
+  bool send_materials_ok = SendToGpu(scene.BasicMaterialsStructuredBuffer, state.device_context.Get());
+  if (!send_materials_ok) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error updating basic material buffer", "");
+  }
+
+  const auto& vertex_layout_statistics = VertexLayout::GetStatistics();
+  DXFW_TRACE(__FILE__, __LINE__, false, "Vertex layouts: %u requests, %u cache hits, %u interned semantics",
+             vertex_layout_statistics.Requests, vertex_layout_statistics.Hits, vertex_layout_statistics.InternedSemantics);
 
   while (!Dxfw::ShouldWindowClose(state.window.get())) {
+    Loaders::UpdateTextureStreaming(state.device.Get(), state.device_context.Get());
+
     Update(&scene, &state);
 
+    TextureResidency::Update(state.device.Get(), state.device_context.Get());
+
     Render(&scene, &state);
 
     state.swap_chain->Present(0, 0);
@@ -492,6 +733,13 @@ int main(int /* argc */, char** /* argv */) {
     Dxfw::PollOsEvents();
   }
 
+  Loaders::StopTextureStreaming();
+
+  const auto& residency_counters = TextureResidency::GetCounters();
+  DXFW_TRACE(__FILE__, __LINE__, false, "Textures: %llu of %llu bytes resident, %llu level requests, %llu evictions",
+             static_cast<uint64_t>(residency_counters.ResidentBytes), static_cast<uint64_t>(residency_counters.BudgetBytes),
+             residency_counters.Requests, residency_counters.Evictions);
+
   state.device_context->ClearState();
 
   return 0;
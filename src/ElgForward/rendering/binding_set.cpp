@@ -0,0 +1,107 @@
+#include "binding_set.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <d3d11.h>
+#include <wrl.h>
+
+#include "core/hash.h"
+#include "core/resource_array.h"
+#include "core/handle_cache.h"
+
+namespace Rendering {
+namespace BindingSet {
+
+struct BindingRange {
+  uint32_t FirstSlot;
+  uint32_t Count;
+  uint32_t ViewOffset;
+};
+
+struct BindingSetData {
+  std::vector<ID3D11ShaderResourceView*> Key;
+  std::vector<BindingRange> Ranges;
+  std::vector<ID3D11ShaderResourceView*> Views;
+  std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> References;
+};
+
+Core::ResourceArray<Handle, BindingSetData, 255> g_storage_;
+Core::HandleCache<std::vector<ID3D11ShaderResourceView*>, Handle> g_cache_;
+std::vector<Handle> g_handles_;
+
+std::vector<ID3D11ShaderResourceView*> TrimTrailingNulls(const std::vector<ID3D11ShaderResourceView*>& views) {
+  auto last = views.size();
+  while (last > 0 && views[last - 1] == nullptr) {
+    --last;
+  }
+  return std::vector<ID3D11ShaderResourceView*>(std::begin(views), std::begin(views) + last);
+}
+
+Handle Create(const std::vector<ID3D11ShaderResourceView*>& views) {
+  auto key = TrimTrailingNulls(views);
+
+  auto cached_handle = g_cache_.Get(key);
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  BindingSetData data;
+  data.Key = key;
+  for (size_t slot = 0; slot < key.size(); ++slot) {
+    if (key[slot] == nullptr) {
+      continue;
+    }
+
+    bool extends_range = !data.Ranges.empty() && data.Ranges.back().FirstSlot + data.Ranges.back().Count == slot;
+    if (!extends_range) {
+      data.Ranges.push_back({ static_cast<uint32_t>(slot), 0, static_cast<uint32_t>(data.Views.size()) });
+    }
+
+    data.Ranges.back().Count += 1;
+    data.Views.push_back(key[slot]);
+    data.References.emplace_back(key[slot]);
+  }
+
+  auto new_handle = g_storage_.Add(std::move(data));
+  g_cache_.Set(key, new_handle);
+  g_handles_.push_back(new_handle);
+  return new_handle;
+}
+
+void BindVertexShaderResources(Handle handle, ID3D11DeviceContext* context) {
+  const auto& data = g_storage_.Get(handle);
+  for (const auto& range : data.Ranges) {
+    context->VSSetShaderResources(range.FirstSlot, range.Count, &data.Views[range.ViewOffset]);
+  }
+}
+
+void BindPixelShaderResources(Handle handle, ID3D11DeviceContext* context) {
+  const auto& data = g_storage_.Get(handle);
+  for (const auto& range : data.Ranges) {
+    context->PSSetShaderResources(range.FirstSlot, range.Count, &data.Views[range.ViewOffset]);
+  }
+}
+
+void ReplaceView(ID3D11ShaderResourceView* old_view, ID3D11ShaderResourceView* new_view) {
+  for (auto handle : g_handles_) {
+    auto& data = g_storage_.Get(handle);
+    if (std::find(std::begin(data.Views), std::end(data.Views), old_view) == std::end(data.Views)) {
+      continue;
+    }
+
+    // The cache is keyed by view pointers, so the set moves to its new key
+    g_cache_.Remove(data.Key);
+    std::replace(std::begin(data.Key), std::end(data.Key), old_view, new_view);
+    std::replace(std::begin(data.Views), std::end(data.Views), old_view, new_view);
+    for (auto& reference : data.References) {
+      if (reference.Get() == old_view) {
+        reference = new_view;
+      }
+    }
+    g_cache_.Set(data.Key, handle);
+  }
+}
+
+}  // namespace BindingSet
+}  // namespace Rendering
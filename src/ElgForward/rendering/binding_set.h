@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+#include <d3d11.h>
+
+#include "core/handle.h"
+
+namespace Rendering {
+namespace BindingSet {
+
+struct BindingSetTag {};
+
+using Handle = Core::Handle<8, 24, BindingSetTag>;
+
+// Immutable set of shader resource views indexed by slot. Null slots are skipped and the remaining views
+// are stored as contiguous slot ranges. Identical sets share a single handle.
+Handle Create(const std::vector<ID3D11ShaderResourceView*>& views);
+
+// Binding does not touch the reference counts - the set keeps its views alive
+void BindVertexShaderResources(Handle handle, ID3D11DeviceContext* context);
+
+void BindPixelShaderResources(Handle handle, ID3D11DeviceContext* context);
+
+// Points every set holding old_view at new_view instead, handles stay the same. Used when a texture swaps its view.
+void ReplaceView(ID3D11ShaderResourceView* old_view, ID3D11ShaderResourceView* new_view);
+
+}  // namespace BindingSet
+}  // namespace Rendering
@@ -0,0 +1,394 @@
+#include "rendering/block_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <thread>
+
+#include <emmintrin.h>
+
+namespace Rendering {
+namespace BlockCompression {
+
+bool IsBlockCompressed(DXGI_FORMAT format) {
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC5_UNORM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint32_t GetBlockSize(DXGI_FORMAT format) {
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC4_UNORM:
+      return 8;
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC5_UNORM:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+uint32_t GetBlockCount(uint32_t size) {
+  return std::max(1u, (size + 3) / 4);
+}
+
+size_t GetRowPitch(DXGI_FORMAT format, uint32_t width) {
+  return static_cast<size_t>(GetBlockCount(width)) * GetBlockSize(format);
+}
+
+size_t GetEncodedSize(DXGI_FORMAT format, uint32_t width, uint32_t height) {
+  return GetRowPitch(format, width) * GetBlockCount(height);
+}
+
+// Gathers a 4x4 block as RGBA - channels missing from the source are zero and alpha defaults to opaque
+void LoadBlock(const Texture::ImageData& image, uint32_t block_x, uint32_t block_y, uint8_t rgba[64]) {
+  for (uint32_t y = 0; y < 4; ++y) {
+    auto source_y = std::min(block_y * 4 + y, image.Height - 1);
+    for (uint32_t x = 0; x < 4; ++x) {
+      auto source_x = std::min(block_x * 4 + x, image.Width - 1);
+      auto source = image.Data + (static_cast<size_t>(source_y) * image.Width + source_x) * image.Components;
+      auto destination = rgba + (y * 4 + x) * 4;
+      destination[0] = source[0];
+      destination[1] = image.Components > 1 ? source[1] : 0;
+      destination[2] = image.Components > 2 ? source[2] : 0;
+      destination[3] = image.Components > 3 ? source[3] : 255;
+    }
+  }
+}
+
+uint16_t To565(const uint8_t* color) {
+  return static_cast<uint16_t>(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+}
+
+void From565(uint16_t value, int16_t* color) {
+  auto r = (value >> 11) & 31;
+  auto g = (value >> 5) & 63;
+  auto b = value & 31;
+  color[0] = static_cast<int16_t>((r << 3) | (r >> 2));
+  color[1] = static_cast<int16_t>((g << 2) | (g >> 4));
+  color[2] = static_cast<int16_t>((b << 3) | (b >> 2));
+}
+
+// Bounding box endpoints inset by 1/16 of the range, pixels are projected on the endpoint axis with SSE2
+void EncodeColorBlock(const uint8_t rgba[64], uint8_t* output) {
+  __m128i rows[4];
+  for (int i = 0; i < 4; ++i) {
+    rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 16));
+  }
+
+  auto block_min = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+  auto block_max = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+  block_min = _mm_min_epu8(block_min, _mm_srli_si128(block_min, 8));
+  block_min = _mm_min_epu8(block_min, _mm_srli_si128(block_min, 4));
+  block_max = _mm_max_epu8(block_max, _mm_srli_si128(block_max, 8));
+  block_max = _mm_max_epu8(block_max, _mm_srli_si128(block_max, 4));
+
+  uint8_t min_color[4];
+  uint8_t max_color[4];
+  auto min_packed = _mm_cvtsi128_si32(block_min);
+  auto max_packed = _mm_cvtsi128_si32(block_max);
+  std::memcpy(min_color, &min_packed, 4);
+  std::memcpy(max_color, &max_packed, 4);
+
+  for (int c = 0; c < 3; ++c) {
+    auto inset = (max_color[c] - min_color[c]) >> 4;
+    min_color[c] = static_cast<uint8_t>(min_color[c] + inset);
+    max_color[c] = static_cast<uint8_t>(max_color[c] - inset);
+  }
+
+  // The max endpoint is never smaller in any 565 field, so color0 >= color1 and the block stays in four color mode
+  auto color0 = To565(max_color);
+  auto color1 = To565(min_color);
+  uint32_t indices = 0;
+
+  if (color0 != color1) {
+    int16_t c0[3];
+    int16_t c1[3];
+    From565(color0, c0);
+    From565(color1, c1);
+
+    int16_t d[3] = { static_cast<int16_t>(c0[0] - c1[0]), static_cast<int16_t>(c0[1] - c1[1]), static_cast<int16_t>(c0[2] - c1[2]) };
+    int32_t denominator = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+    auto direction = _mm_setr_epi16(d[0], d[1], d[2], 0, d[0], d[1], d[2], 0);
+    auto base = _mm_setr_epi16(c1[0], c1[1], c1[2], 0, c1[0], c1[1], c1[2], 0);
+    auto zero = _mm_setzero_si128();
+
+    // Level 0 is color1 and level 3 is color0
+    const uint32_t level_to_index[4] = { 1, 3, 2, 0 };
+
+    for (int row = 0; row < 4; ++row) {
+      auto low = _mm_sub_epi16(_mm_unpacklo_epi8(rows[row], zero), base);
+      auto high = _mm_sub_epi16(_mm_unpackhi_epi8(rows[row], zero), base);
+      auto low_dot = _mm_madd_epi16(low, direction);
+      auto high_dot = _mm_madd_epi16(high, direction);
+      low_dot = _mm_add_epi32(low_dot, _mm_srli_epi64(low_dot, 32));
+      high_dot = _mm_add_epi32(high_dot, _mm_srli_epi64(high_dot, 32));
+      auto dots = _mm_unpacklo_epi64(_mm_shuffle_epi32(low_dot, _MM_SHUFFLE(3, 1, 2, 0)),
+                                     _mm_shuffle_epi32(high_dot, _MM_SHUFFLE(3, 1, 2, 0)));
+
+      int32_t dot_values[4];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dot_values), dots);
+
+      for (int i = 0; i < 4; ++i) {
+        auto dot = std::min(std::max(dot_values[i], 0), denominator);
+        auto level = (3 * dot + denominator / 2) / denominator;
+        indices |= level_to_index[level] << (2 * (row * 4 + i));
+      }
+    }
+  }
+
+  output[0] = static_cast<uint8_t>(color0 & 0xFF);
+  output[1] = static_cast<uint8_t>(color0 >> 8);
+  output[2] = static_cast<uint8_t>(color1 & 0xFF);
+  output[3] = static_cast<uint8_t>(color1 >> 8);
+  std::memcpy(output + 4, &indices, 4);
+}
+
+// Eight value mode with the block minimum and maximum as endpoints
+void EncodeChannelBlock(const uint8_t rgba[64], uint32_t channel, uint8_t* output) {
+  uint8_t values[16];
+  for (int i = 0; i < 16; ++i) {
+    values[i] = rgba[i * 4 + channel];
+  }
+
+  auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+  auto block_min = _mm_min_epu8(v, _mm_srli_si128(v, 8));
+  auto block_max = _mm_max_epu8(v, _mm_srli_si128(v, 8));
+  block_min = _mm_min_epu8(block_min, _mm_srli_si128(block_min, 4));
+  block_max = _mm_max_epu8(block_max, _mm_srli_si128(block_max, 4));
+  block_min = _mm_min_epu8(block_min, _mm_srli_si128(block_min, 2));
+  block_max = _mm_max_epu8(block_max, _mm_srli_si128(block_max, 2));
+  block_min = _mm_min_epu8(block_min, _mm_srli_si128(block_min, 1));
+  block_max = _mm_max_epu8(block_max, _mm_srli_si128(block_max, 1));
+
+  auto min_value = static_cast<uint32_t>(_mm_cvtsi128_si32(block_min) & 0xFF);
+  auto max_value = static_cast<uint32_t>(_mm_cvtsi128_si32(block_max) & 0xFF);
+
+  output[0] = static_cast<uint8_t>(max_value);
+  output[1] = static_cast<uint8_t>(min_value);
+
+  uint64_t indices = 0;
+  if (max_value != min_value) {
+    auto range = max_value - min_value;
+    for (int i = 0; i < 16; ++i) {
+      auto level = ((values[i] - min_value) * 7 + range / 2) / range;
+      uint64_t index = (level == 7) ? 0 : ((level == 0) ? 1 : 8 - level);
+      indices |= index << (3 * i);
+    }
+  }
+
+  for (int i = 0; i < 6; ++i) {
+    output[2 + i] = static_cast<uint8_t>((indices >> (8 * i)) & 0xFF);
+  }
+}
+
+void EncodeBlock(DXGI_FORMAT format, const uint8_t rgba[64], uint8_t* output) {
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+      EncodeColorBlock(rgba, output);
+      break;
+    case DXGI_FORMAT_BC3_UNORM:
+      EncodeChannelBlock(rgba, 3, output);
+      EncodeColorBlock(rgba, output + 8);
+      break;
+    case DXGI_FORMAT_BC4_UNORM:
+      EncodeChannelBlock(rgba, 0, output);
+      break;
+    case DXGI_FORMAT_BC5_UNORM:
+      EncodeChannelBlock(rgba, 0, output);
+      EncodeChannelBlock(rgba, 1, output + 8);
+      break;
+    default:
+      break;
+  }
+}
+
+bool Encode(const Texture::ImageData& image, DXGI_FORMAT format, std::vector<uint8_t>* output) {
+  if (!IsBlockCompressed(format) || image.Data == nullptr || image.Width == 0 || image.Height == 0) {
+    return false;
+  }
+
+  bool needs_color = (format == DXGI_FORMAT_BC1_UNORM || format == DXGI_FORMAT_BC3_UNORM);
+  if ((needs_color && image.Components < 4) || (format == DXGI_FORMAT_BC5_UNORM && image.Components < 2)) {
+    return false;
+  }
+
+  auto blocks_x = GetBlockCount(image.Width);
+  auto blocks_y = GetBlockCount(image.Height);
+  auto block_size = GetBlockSize(format);
+  output->resize(GetEncodedSize(format, image.Width, image.Height));
+
+  auto worker_count = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), blocks_y);
+  auto rows_per_worker = (blocks_y + worker_count - 1) / worker_count;
+
+  auto run_worker = [&](uint32_t worker_index) {
+    auto row_begin = std::min(worker_index * rows_per_worker, blocks_y);
+    auto row_end = std::min(row_begin + rows_per_worker, blocks_y);
+
+    uint8_t rgba[64];
+    for (auto block_y = row_begin; block_y < row_end; ++block_y) {
+      for (uint32_t block_x = 0; block_x < blocks_x; ++block_x) {
+        LoadBlock(image, block_x, block_y, rgba);
+        EncodeBlock(format, rgba, output->data() + (static_cast<size_t>(block_y) * blocks_x + block_x) * block_size);
+      }
+    }
+  };
+
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
+
+  run_worker(0);
+
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  return true;
+}
+
+void DecodeColorBlock(const uint8_t* block, uint8_t rgba[64]) {
+  uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+  uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+  uint32_t indices;
+  std::memcpy(&indices, block + 4, 4);
+
+  int16_t palette[4][3];
+  From565(color0, palette[0]);
+  From565(color1, palette[1]);
+  for (int c = 0; c < 3; ++c) {
+    if (color0 > color1) {
+      palette[2][c] = static_cast<int16_t>((2 * palette[0][c] + palette[1][c]) / 3);
+      palette[3][c] = static_cast<int16_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+    } else {
+      palette[2][c] = static_cast<int16_t>((palette[0][c] + palette[1][c]) / 2);
+      palette[3][c] = 0;
+    }
+  }
+
+  for (int i = 0; i < 16; ++i) {
+    auto index = (indices >> (2 * i)) & 3;
+    for (int c = 0; c < 3; ++c) {
+      rgba[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+    }
+  }
+}
+
+void DecodeChannelBlock(const uint8_t* block, uint32_t channel, uint8_t rgba[64]) {
+  uint32_t palette[8];
+  palette[0] = block[0];
+  palette[1] = block[1];
+  if (palette[0] > palette[1]) {
+    for (uint32_t i = 2; i < 8; ++i) {
+      palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+    }
+  } else {
+    for (uint32_t i = 2; i < 6; ++i) {
+      palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  uint64_t indices = 0;
+  for (int i = 0; i < 6; ++i) {
+    indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+  }
+
+  for (int i = 0; i < 16; ++i) {
+    rgba[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+  }
+}
+
+double ComputePsnr(const Texture::ImageData& image, DXGI_FORMAT format, const std::vector<uint8_t>& encoded) {
+  if (encoded.size() != GetEncodedSize(format, image.Width, image.Height)) {
+    return 0.0;
+  }
+
+  uint32_t channel_begin = 0;
+  uint32_t channel_end = 0;
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+      channel_end = 3;
+      break;
+    case DXGI_FORMAT_BC3_UNORM:
+      channel_end = 4;
+      break;
+    case DXGI_FORMAT_BC4_UNORM:
+      channel_end = 1;
+      break;
+    case DXGI_FORMAT_BC5_UNORM:
+      channel_end = 2;
+      break;
+    default:
+      return 0.0;
+  }
+
+  auto blocks_x = GetBlockCount(image.Width);
+  auto blocks_y = GetBlockCount(image.Height);
+  auto block_size = GetBlockSize(format);
+
+  double squared_error = 0.0;
+  size_t sample_count = 0;
+
+  for (uint32_t block_y = 0; block_y < blocks_y; ++block_y) {
+    for (uint32_t block_x = 0; block_x < blocks_x; ++block_x) {
+      const uint8_t* block = encoded.data() + (static_cast<size_t>(block_y) * blocks_x + block_x) * block_size;
+
+      uint8_t source[64];
+      uint8_t decoded[64] = {};
+      LoadBlock(image, block_x, block_y, source);
+
+      switch (format) {
+        case DXGI_FORMAT_BC1_UNORM:
+          DecodeColorBlock(block, decoded);
+          break;
+        case DXGI_FORMAT_BC3_UNORM:
+          DecodeChannelBlock(block, 3, decoded);
+          DecodeColorBlock(block + 8, decoded);
+          break;
+        case DXGI_FORMAT_BC4_UNORM:
+          DecodeChannelBlock(block, 0, decoded);
+          break;
+        case DXGI_FORMAT_BC5_UNORM:
+          DecodeChannelBlock(block, 0, decoded);
+          DecodeChannelBlock(block + 8, 1, decoded);
+          break;
+        default:
+          break;
+      }
+
+      // Edge blocks only count the pixels inside the image
+      for (uint32_t y = 0; y < 4 && block_y * 4 + y < image.Height; ++y) {
+        for (uint32_t x = 0; x < 4 && block_x * 4 + x < image.Width; ++x) {
+          for (auto c = channel_begin; c < channel_end; ++c) {
+            double difference = static_cast<double>(source[(y * 4 + x) * 4 + c]) - decoded[(y * 4 + x) * 4 + c];
+            squared_error += difference * difference;
+            ++sample_count;
+          }
+        }
+      }
+    }
+  }
+
+  if (squared_error == 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  auto mean_squared_error = squared_error / sample_count;
+  return 10.0 * std::log10(255.0 * 255.0 / mean_squared_error);
+}
+
+}  // namespace BlockCompression
+}  // namespace Rendering
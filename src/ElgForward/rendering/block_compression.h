@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "rendering/texture.h"
+
+namespace Rendering {
+namespace BlockCompression {
+
+bool IsBlockCompressed(DXGI_FORMAT format);
+
+// Bytes per 4x4 block
+uint32_t GetBlockSize(DXGI_FORMAT format);
+
+size_t GetRowPitch(DXGI_FORMAT format, uint32_t width);
+
+size_t GetEncodedSize(DXGI_FORMAT format, uint32_t width, uint32_t height);
+
+// Encodes an 8 bit per channel image on all cores. BC1 and BC3 need four channels, BC4 reads the first channel
+// and BC5 the first two. Edge blocks of images that are not a multiple of four repeat the last row and column.
+bool Encode(const Texture::ImageData& image, DXGI_FORMAT format, std::vector<uint8_t>* output);
+
+// Peak signal to noise ratio of the encoded image against the source, over the channels the format stores
+double ComputePsnr(const Texture::ImageData& image, DXGI_FORMAT format, const std::vector<uint8_t>& encoded);
+
+}  // namespace BlockCompression
+}  // namespace Rendering
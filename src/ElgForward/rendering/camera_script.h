@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "core/asset_file.h"
 #include "core/filesystem.h"
 #include "core/chaiscript_helpers.h"
 #include "rendering/lens/perspective_lens.h"
@@ -32,8 +33,15 @@ class CameraScript {
 
        m_script_.add_global(chaiscript::var(std::ref(*lens)), "lens");
 
-       // Load
-       m_script_.use(path.string());
+       // Load, the script may come from a mounted pack archive
+       Core::AssetFile file;
+       if (!file.Open(path)) {
+         DXFW_TRACE(__FILE__, __LINE__, false, "Script not found: %S", path.string().c_str());
+         return false;
+       }
+
+       std::string source(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+       m_script_.eval(source, chaiscript::Exception_Handler(), path.string());
 
        // Setup update
        m_update_fun_ = m_script_.eval<std::function<void(float)>>("update");
@@ -1,117 +1,106 @@
 #include "rendering/drawable.h"
 
 #include "core/hash.h"
-#include "rendering/dxgi_format_helper.h"
+#include "rendering/shader_input_layout.h"
+#include "rendering/texture_residency.h"
 
 namespace Rendering {
 
-int32_t GetVertexBufferIndex(VertexDataChannel channel, const Mesh::Mesh& mesh) {
-  auto it = std::find(std::begin(mesh.VertexDataChannels), std::end(mesh.VertexDataChannels), channel);
-  if (it != std::end(mesh.VertexDataChannels)) {
-    int32_t index = static_cast<int32_t>(std::distance(std::begin(mesh.VertexDataChannels), it));
-    return index;
+template<typename C>
+std::vector<ID3D11ShaderResourceView*> GetShaderResourceViews(const C& textures) {
+  std::vector<ID3D11ShaderResourceView*> views(textures.size(), nullptr);
+  for (size_t i = 0; i < textures.size(); ++i) {
+    if (textures[i].IsValid()) {
+      views[i] = Texture::GetShaderResourceView(textures[i]).Get();
+    }
   }
-  return -1;
+  return views;
 }
 
-bool IsVertexBufferFormatCompatible(uint32_t component_count, D3D_REGISTER_COMPONENT_TYPE component_type, DXGI_FORMAT mesh_channel_format) {
-  auto components_and_format = DxgiFormatToComponentsAndType(mesh_channel_format);
-
-  if (components_and_format.second == D3D_REGISTER_COMPONENT_UNKNOWN) {
-    return false;
-  }
-
-  if (component_count != components_and_format.first || component_type != components_and_format.second) {
-    return false;
+template<typename C>
+std::vector<Texture::Handle> GetValidTextures(const C& textures) {
+  std::vector<Texture::Handle> valid_textures;
+  for (const auto& texture : textures) {
+    if (texture.IsValid()) {
+      valid_textures.push_back(texture);
+    }
   }
-
-  return true;
+  return valid_textures;
 }
 
-bool CreateDrawable(size_t drawable_name_hash, const Mesh::Mesh& mesh, size_t material_name_hash,
+bool CreateDrawable(const Mesh::Mesh& mesh, size_t material_name_hash,
                     const Material::Material& material, const Transform::Transform& transform,
                     ID3D11Device* device, Drawable* drawable) {
   auto vertex_shader_ptr = Rendering::VertexShader::Retreive(material.VertexShader);
-  auto pixel_shader_ptr = Rendering::PixelShader::Retreive(material.PixelShader);
 
   std::vector<D3D11_INPUT_ELEMENT_DESC> input_layout_desc;
-
-  uint32_t slot_index = 0;
-  for (const auto& input_desc : vertex_shader_ptr->ReflectionData.Inputs) {
-    auto input_index = GetVertexBufferIndex(input_desc.Channel, mesh);
-
-    if (input_index == -1) {
-      return false;
-    }
-
-    bool is_compatible = IsVertexBufferFormatCompatible(input_desc.ComponentCount, input_desc.ComponentType, mesh.VertexBufferFormats[input_index]);
-    if (!is_compatible) {
-      return false;
-    }
-
-    drawable->SetVertexBuffer(slot_index, mesh.VertexBuffers[input_index], mesh.VertexBufferStrides[input_index]);
-
-    input_layout_desc.emplace_back();
-    auto& input_layout_desc_entry = input_layout_desc.back();
-
-    input_layout_desc_entry.SemanticName = input_desc.SemanticName.c_str();
-    input_layout_desc_entry.SemanticIndex = input_desc.SemanticIndex;
-    input_layout_desc_entry.Format = mesh.VertexBufferFormats[input_index];
-    input_layout_desc_entry.InputSlot = slot_index;
-    input_layout_desc_entry.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-    input_layout_desc_entry.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-    input_layout_desc_entry.InstanceDataStepRate = 0;
-
-    ++slot_index;
+  std::vector<uint32_t> mesh_buffer_indices;
+  if (!ShaderReflection::BuildInputLayout(vertex_shader_ptr->ReflectionData, mesh.VertexDataChannels, mesh.VertexBufferFormats,
+                                          &input_layout_desc, &mesh_buffer_indices)) {
+    return false;
   }
 
-  bool vertex_layout_ok = drawable->SetVertexLayout(input_layout_desc, vertex_shader_ptr->Buffer.Get(), device);
-  if (!vertex_layout_ok) {
-    return false;
+  std::vector<VertexBuffer::Handle> vertex_buffers;
+  std::vector<uint32_t> vertex_buffer_strides;
+  for (auto mesh_buffer_index : mesh_buffer_indices) {
+    vertex_buffers.push_back(mesh.VertexBuffers[mesh_buffer_index]);
+    vertex_buffer_strides.push_back(mesh.VertexBufferStrides[mesh_buffer_index]);
   }
 
-  bool index_data_ok = drawable->SetIndexData(mesh.IndexBuffer, mesh.IndexBufferFormat, mesh.IndexCount, mesh.PrimitiveTopology);
-  if (!index_data_ok) {
+  PipelineState::Description pipeline_state_description;
+  pipeline_state_description.VertexShader = material.VertexShader;
+  pipeline_state_description.PixelShader = material.PixelShader;
+  pipeline_state_description.VertexLayout = VertexLayout::Create(input_layout_desc, vertex_shader_ptr->Buffer.Get(), device);
+  pipeline_state_description.PrimitiveTopology = mesh.PrimitiveTopology;
+  pipeline_state_description.RasterizerState = material.RasterizerState;
+  pipeline_state_description.BlendState = material.BlendState;
+  pipeline_state_description.DepthStencilState = material.DepthStencilState;
+  if (!pipeline_state_description.VertexLayout.IsValid()) {
     return false;
   }
 
-  bool vs_ok = drawable->SetVertexShader(vertex_shader_ptr->Shader);
-  if (!vs_ok) {
+  drawable->PipelineState = PipelineState::Create(pipeline_state_description, device);
+  if (!drawable->PipelineState.IsValid()) {
     return false;
   }
 
-  bool ps_ok = drawable->SetPixelShader(pixel_shader_ptr->Shader);
-  if (!ps_ok) {
+  drawable->Geometry = Geometry::Create(vertex_buffers, vertex_buffer_strides, mesh.IndexBuffer, mesh.IndexBufferFormat,
+                                        mesh.IndexCount);
+  if (!drawable->Geometry.IsValid()) {
     return false;
   }
 
-  auto cpu_name_hash = drawable_name_hash;
-  hash_combine(cpu_name_hash, material_name_hash);
-  auto gpu_name_hash = std::hash<std::string>()("");
+  // One constant buffer per material instance, shared by all drawables using it - the GPU copy is filled on creation
+  if (material.TableIndex == Material::NoTableIndex) {
+    drawable->MaterialConstantBuffer = ConstantBuffer::Create(material_name_hash, material.TypeHash, material.Data.GetSize(), material.Data.GetAlign(), material.Data.GetBuffer(), device);
+    if (!drawable->MaterialConstantBuffer.IsValid()) {
+      return false;
+    }
+  }
 
-  auto handle = ConstantBuffer::Create(cpu_name_hash, gpu_name_hash, material.TypeHash, material.Data.GetSize(), material.Data.GetAlign(), material.Data.GetBuffer(), device);
-  bool material_consntant_buffer_ok = drawable->SetMaterialConstantBuffer(handle);
-  if (!material_consntant_buffer_ok) {
+  drawable->Transform = transform;
+  if (!drawable->Transform.IsValid()) {
     return false;
   }
 
-  bool transform_consntant_buffer_ok = drawable->SetTransformConstantBuffer(transform.TransformConstantBuffer);
-  if (!transform_consntant_buffer_ok) {
-    return false;
+  mesh.Bounds.Transform(drawable->BoundingSphere, Transform::Get(transform).Matrix);
+  if (material.TableIndex != Material::NoTableIndex) {
+    drawable->MaterialIndex = material.TableIndex;
   }
 
-  for (size_t i = 0; i < material.VertexShaderTextures.size(); ++i) {
-    if (material.VertexShaderTextures[i].IsValid()) {
-      drawable->SetVertexShaderResourceView(i, Texture::GetShaderResourceView(material.VertexShaderTextures[i]).Get());
-    }
+  drawable->VertexShaderBindingSet = BindingSet::Create(GetShaderResourceViews(material.VertexShaderTextures));
+  if (!drawable->VertexShaderBindingSet.IsValid()) {
+    return false;
   }
 
-  for (size_t i = 0; i < material.PixelShaderTextures.size(); ++i) {
-    if (material.PixelShaderTextures[i].IsValid()) {
-      drawable->SetPixelShaderResourceView(i, Texture::GetShaderResourceView(material.PixelShaderTextures[i]).Get());
-    }
+  drawable->PixelShaderBindingSet = BindingSet::Create(GetShaderResourceViews(material.PixelShaderTextures));
+  if (!drawable->PixelShaderBindingSet.IsValid()) {
+    return false;
   }
 
+  TextureResidency::RegisterBindingSet(drawable->VertexShaderBindingSet, GetValidTextures(material.VertexShaderTextures));
+  TextureResidency::RegisterBindingSet(drawable->PixelShaderBindingSet, GetValidTextures(material.PixelShaderTextures));
+
   return true;
 }
 
@@ -54,6 +54,11 @@ std::pair<uint32_t, D3D_REGISTER_COMPONENT_TYPE> DxgiFormatToComponentsAndType(D
     { DXGI_FORMAT_R8_SNORM,{ 1, D3D_REGISTER_COMPONENT_FLOAT32 } },
     { DXGI_FORMAT_R8G8_SNORM,{ 2, D3D_REGISTER_COMPONENT_FLOAT32 } },
     { DXGI_FORMAT_R8G8B8A8_SNORM,{ 4, D3D_REGISTER_COMPONENT_FLOAT32 } },
+    { DXGI_FORMAT_BC1_UNORM,{ 4, D3D_REGISTER_COMPONENT_FLOAT32 } },
+    { DXGI_FORMAT_BC3_UNORM,{ 4, D3D_REGISTER_COMPONENT_FLOAT32 } },
+    { DXGI_FORMAT_BC4_UNORM,{ 1, D3D_REGISTER_COMPONENT_FLOAT32 } },
+    { DXGI_FORMAT_BC5_UNORM,{ 2, D3D_REGISTER_COMPONENT_FLOAT32 } },
+    { DXGI_FORMAT_BC7_UNORM,{ 4, D3D_REGISTER_COMPONENT_FLOAT32 } },
   };
 
   auto it = type_map.find(format);
@@ -0,0 +1,119 @@
+#include "geometry.h"
+
+#include <vector>
+
+#include <d3d11.h>
+#include <wrl.h>
+
+#include "core/hash.h"
+#include "core/resource_array.h"
+#include "core/handle_cache.h"
+
+namespace Rendering {
+namespace Geometry {
+
+struct GeometryData {
+  std::vector<ID3D11Buffer*> VertexBuffers;
+  std::vector<uint32_t> VertexBufferStrides;
+  std::vector<uint32_t> VertexBufferOffsets;
+  std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> VertexBufferReferences;
+  Microsoft::WRL::ComPtr<ID3D11Buffer> IndexBuffer;
+  DXGI_FORMAT IndexBufferFormat;
+  uint32_t IndexCount;
+};
+
+// Geometry is cached by the buffers themselves, the hash only picks the bucket
+struct GeometryKey {
+  std::vector<VertexBuffer::Handle::StorageType> VertexBuffers = {};
+  std::vector<uint32_t> VertexBufferStrides = {};
+  IndexBuffer::Handle::StorageType IndexBuffer = 0;
+  DXGI_FORMAT IndexBufferFormat = DXGI_FORMAT_UNKNOWN;
+  uint32_t IndexCount = 0;
+  size_t Hash = 0;
+};
+
+inline bool operator==(const GeometryKey& lhs, const GeometryKey& rhs) {
+  return lhs.Hash == rhs.Hash
+    && lhs.VertexBuffers == rhs.VertexBuffers
+    && lhs.VertexBufferStrides == rhs.VertexBufferStrides
+    && lhs.IndexBuffer == rhs.IndexBuffer
+    && lhs.IndexBufferFormat == rhs.IndexBufferFormat
+    && lhs.IndexCount == rhs.IndexCount;
+}
+
+}  // namespace Geometry
+}  // namespace Rendering
+
+namespace std {
+
+template<>
+struct hash<Rendering::Geometry::GeometryKey> {
+  size_t operator()(const Rendering::Geometry::GeometryKey& key) const {
+    return key.Hash;
+  }
+};
+
+}  // std
+
+namespace Rendering {
+namespace Geometry {
+
+Core::ResourceArray<Handle, GeometryData, 255> g_storage_;
+Core::HandleCache<GeometryKey, Handle> g_cache_;
+
+Handle Create(const std::vector<VertexBuffer::Handle>& vertex_buffers, const std::vector<uint32_t>& vertex_buffer_strides,
+              IndexBuffer::Handle index_buffer, DXGI_FORMAT index_buffer_format, uint32_t index_count) {
+  GeometryKey key;
+  for (auto vertex_buffer : vertex_buffers) {
+    key.VertexBuffers.push_back(vertex_buffer.CompactForm());
+  }
+  key.VertexBufferStrides = vertex_buffer_strides;
+  key.IndexBuffer = index_buffer.CompactForm();
+  key.IndexBufferFormat = index_buffer_format;
+  key.IndexCount = index_count;
+
+  hash_range(key.Hash, std::begin(key.VertexBuffers), std::end(key.VertexBuffers));
+  hash_range(key.Hash, std::begin(key.VertexBufferStrides), std::end(key.VertexBufferStrides));
+  hash_combine(key.Hash, key.IndexBuffer);
+  hash_combine(key.Hash, key.IndexBufferFormat);
+  hash_combine(key.Hash, key.IndexCount);
+
+  auto cached_handle = g_cache_.Get(key);
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  GeometryData data;
+  for (size_t i = 0; i < vertex_buffers.size(); ++i) {
+    auto buffer = VertexBuffer::Retreive(vertex_buffers[i]);
+    data.VertexBuffers.push_back(buffer.Get());
+    data.VertexBufferStrides.push_back(vertex_buffer_strides[i]);
+    data.VertexBufferOffsets.push_back(0);
+    data.VertexBufferReferences.emplace_back(std::move(buffer));
+  }
+  data.IndexBuffer = IndexBuffer::Retreive(index_buffer);
+  data.IndexBufferFormat = index_buffer_format;
+  data.IndexCount = index_count;
+
+  auto new_handle = g_storage_.Add(std::move(data));
+  g_cache_.Set(key, new_handle);
+  return new_handle;
+}
+
+void Bind(Handle handle, ID3D11DeviceContext* context) {
+  const auto& data = g_storage_.Get(handle);
+
+  if (!data.VertexBuffers.empty()) {
+    context->IASetVertexBuffers(0, static_cast<UINT>(data.VertexBuffers.size()), &data.VertexBuffers[0],
+                                &data.VertexBufferStrides[0], &data.VertexBufferOffsets[0]);
+  }
+
+  context->IASetIndexBuffer(data.IndexBuffer.Get(), data.IndexBufferFormat, 0);
+}
+
+uint32_t GetIndexCount(Handle handle) {
+  return g_storage_.Get(handle).IndexCount;
+}
+
+}  // namespace Geometry
+}  // namespace Rendering
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+#include <d3d11.h>
+
+#include "core/handle.h"
+#include "rendering/vertex_buffer.h"
+#include "rendering/index_buffer.h"
+
+namespace Rendering {
+namespace Geometry {
+
+struct GeometryTag {};
+
+using Handle = Core::Handle<8, 24, GeometryTag>;
+
+// Input assembler buffers of a drawable - vertex buffers bound to consecutive slots starting at 0 plus the
+// index buffer. The primitive topology is part of the pipeline state. Identical geometry shares a single handle.
+Handle Create(const std::vector<VertexBuffer::Handle>& vertex_buffers, const std::vector<uint32_t>& vertex_buffer_strides,
+              IndexBuffer::Handle index_buffer, DXGI_FORMAT index_buffer_format, uint32_t index_count);
+
+void Bind(Handle handle, ID3D11DeviceContext* context);
+
+uint32_t GetIndexCount(Handle handle);
+
+}  // namespace Geometry
+}  // namespace Rendering
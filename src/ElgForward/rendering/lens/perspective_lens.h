@@ -47,6 +47,14 @@ public:
     return m_zoom_factor_;
   }
 
+  float GetNearPlane() const {
+    return m_near_;
+  }
+
+  float GetFarPlane() const {
+    return m_far_;
+  }
+
   void UpdateMatrices(float aspect_ratio) {
     float frustum_width;
     float frustum_height;
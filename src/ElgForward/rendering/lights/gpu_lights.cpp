@@ -0,0 +1,48 @@
+#include "gpu_lights.h"
+
+#include <cmath>
+
+#include <DirectXPackedVector.h>
+
+namespace Rendering {
+namespace Lights {
+
+uint32_t PackColor(DirectX::FXMVECTOR color, float intensity) {
+  // R11G11B10 has no sign bit - clamp so negative colors do not wrap to huge values
+  auto scaled = DirectX::XMVectorMax(DirectX::XMVectorScale(color, intensity), DirectX::XMVectorZero());
+
+  DirectX::PackedVector::XMFLOAT3PK packed;
+  DirectX::PackedVector::XMStoreFloat3PK(&packed, scaled);
+  return packed.v;
+}
+
+GpuPointLight Pack(const PointLight& light) {
+  GpuPointLight result;
+  DirectX::XMStoreFloat3(&result.PositionViewSpace, light.PositionViewSpace);
+  result.Range = light.Range;
+  result.DiffuseColor = PackColor(light.DiffuseColor, light.Intensity);
+  result.SpecularColor = PackColor(light.SpecularColor, light.Intensity);
+  return result;
+}
+
+GpuSpotLight Pack(const SpotLight& light) {
+  GpuSpotLight result;
+  DirectX::XMStoreFloat3(&result.PositionViewSpace, light.PositionViewSpace);
+  result.Range = light.Range;
+
+  auto direction = DirectX::XMVector3Normalize(light.DirectionViewSpace);
+  auto direction_and_cos_angle = DirectX::XMVectorSetW(direction, std::cos(light.SpotlightAngle));
+  DirectX::PackedVector::XMHALF4 packed_direction;
+  DirectX::PackedVector::XMStoreHalf4(&packed_direction, direction_and_cos_angle);
+  result.DirectionAndCosAngle[0] = packed_direction.x;
+  result.DirectionAndCosAngle[1] = packed_direction.y;
+  result.DirectionAndCosAngle[2] = packed_direction.z;
+  result.DirectionAndCosAngle[3] = packed_direction.w;
+
+  result.DiffuseColor = PackColor(light.DiffuseColor, light.Intensity);
+  result.SpecularColor = PackColor(light.SpecularColor, light.Intensity);
+  return result;
+}
+
+}  // namespace Lights
+}  // namespace Rendering
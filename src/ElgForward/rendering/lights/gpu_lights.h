@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <DirectXMath.h>
+
+#include "core/memory_helpers.h"
+#include "rendering/lights/point_light.h"
+#include "rendering/lights/spot_light.h"
+#include "shaders/light_layout.h"
+
+namespace Rendering {
+namespace Lights {
+
+// Packed view space lights uploaded to the structured buffers. Colors are R11G11B10 floats with the
+// intensity folded in, the spot direction and cosine of the spotlight angle are halfs.
+struct GpuPointLight {
+  DirectX::XMFLOAT3 PositionViewSpace;
+  float Range;
+  uint32_t DiffuseColor;
+  uint32_t SpecularColor;
+  PAD(8);
+};
+
+struct GpuSpotLight {
+  DirectX::XMFLOAT3 PositionViewSpace;
+  float Range;
+  uint16_t DirectionAndCosAngle[4];
+  uint32_t DiffuseColor;
+  uint32_t SpecularColor;
+};
+
+static_assert(sizeof(GpuPointLight) == GPU_POINT_LIGHT_SIZE, "GpuPointLight size must match shaders/lights.h");
+static_assert(offsetof(GpuPointLight, PositionViewSpace) == GPU_POINT_LIGHT_POSITION_OFFSET, "GpuPointLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuPointLight, Range) == GPU_POINT_LIGHT_RANGE_OFFSET, "GpuPointLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuPointLight, DiffuseColor) == GPU_POINT_LIGHT_DIFFUSE_COLOR_OFFSET, "GpuPointLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuPointLight, SpecularColor) == GPU_POINT_LIGHT_SPECULAR_COLOR_OFFSET, "GpuPointLight layout must match shaders/lights.h");
+
+static_assert(sizeof(GpuSpotLight) == GPU_SPOT_LIGHT_SIZE, "GpuSpotLight size must match shaders/lights.h");
+static_assert(offsetof(GpuSpotLight, PositionViewSpace) == GPU_SPOT_LIGHT_POSITION_OFFSET, "GpuSpotLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuSpotLight, Range) == GPU_SPOT_LIGHT_RANGE_OFFSET, "GpuSpotLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuSpotLight, DirectionAndCosAngle) == GPU_SPOT_LIGHT_DIRECTION_OFFSET, "GpuSpotLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuSpotLight, DiffuseColor) == GPU_SPOT_LIGHT_DIFFUSE_COLOR_OFFSET, "GpuSpotLight layout must match shaders/lights.h");
+static_assert(offsetof(GpuSpotLight, SpecularColor) == GPU_SPOT_LIGHT_SPECULAR_COLOR_OFFSET, "GpuSpotLight layout must match shaders/lights.h");
+
+// Lights are expected to be updated to view space beforehand
+GpuPointLight Pack(const PointLight& light);
+
+GpuSpotLight Pack(const SpotLight& light);
+
+}  // namespace Lights
+}  // namespace Rendering
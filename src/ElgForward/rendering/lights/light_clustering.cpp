@@ -0,0 +1,253 @@
+#include "light_clustering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace Rendering {
+namespace Lights {
+
+constexpr static const uint32_t SpotLightIndexFlag = 0x80000000u;
+
+float ClusterGrid::GetSliceDepth(uint32_t slice) const {
+  return NearPlane * std::pow(FarPlane / NearPlane, static_cast<float>(slice) / static_cast<float>(SliceCount));
+}
+
+float ClusterGrid::GetSliceScale() const {
+  return static_cast<float>(SliceCount) / std::log(FarPlane / NearPlane);
+}
+
+float ClusterGrid::GetSliceBias() const {
+  return -GetSliceScale() * std::log(NearPlane);
+}
+
+ClusterGrid BuildClusterGrid(uint32_t tile_count_x, uint32_t tile_count_y, uint32_t slice_count,
+                             float near_plane, float far_plane, float frustum_width, float frustum_height) {
+  ClusterGrid grid;
+  grid.TileCountX = tile_count_x;
+  grid.TileCountY = tile_count_y;
+  grid.SliceCount = slice_count;
+  grid.NearPlane = near_plane;
+  grid.FarPlane = far_plane;
+  grid.TanHalfWidth = 0.5f * frustum_width / near_plane;
+  grid.TanHalfHeight = 0.5f * frustum_height / near_plane;
+  return grid;
+}
+
+uint32_t ClampToTileCount(float value, uint32_t tile_count) {
+  if (value <= 0.0f) {
+    return 0;
+  }
+
+  auto max_value = static_cast<float>(tile_count);
+  if (value >= max_value) {
+    return tile_count;
+  }
+
+  return static_cast<uint32_t>(value);
+}
+
+// Conservative range of tiles along one axis covered by [lo, hi] within the depth range [z_lo, z_hi]
+void GetTileRange(float lo, float hi, float z_lo, float z_hi, float tan_half, uint32_t tile_count, uint32_t* begin, uint32_t* end) {
+  auto slope_lo = lo / (lo >= 0.0f ? z_hi : z_lo);
+  auto slope_hi = hi / (hi >= 0.0f ? z_lo : z_hi);
+
+  auto tiles_per_slope = static_cast<float>(tile_count) / (2.0f * tan_half);
+  *begin = ClampToTileCount(std::floor((slope_lo + tan_half) * tiles_per_slope), tile_count);
+  *end = ClampToTileCount(std::ceil((slope_hi + tan_half) * tiles_per_slope), tile_count);
+}
+
+uint32_t GetSliceIndex(const ClusterGrid& grid, float z) {
+  auto slice = std::floor(std::log(z) * grid.GetSliceScale() + grid.GetSliceBias());
+  return std::min(ClampToTileCount(slice, grid.SliceCount), grid.SliceCount - 1);
+}
+
+void GatherLight(const ClusterGrid& grid, uint32_t slice_begin, uint32_t slice_end,
+                 const DirectX::BoundingSphere& sphere, uint32_t light_index, std::vector<uint32_t>* entries) {
+  auto z_min = std::max(sphere.Center.z - sphere.Radius, grid.NearPlane);
+  auto z_max = std::min(sphere.Center.z + sphere.Radius, grid.FarPlane);
+  if (z_min > z_max) {
+    return;
+  }
+
+  auto first_slice = std::max(GetSliceIndex(grid, z_min), slice_begin);
+  auto last_slice = std::min(GetSliceIndex(grid, z_max) + 1, slice_end);
+
+  auto center = DirectX::XMLoadFloat3(&sphere.Center);
+  auto radius_squared = DirectX::XMVectorReplicate(sphere.Radius * sphere.Radius);
+
+  auto tan_half_width = grid.TanHalfWidth;
+  auto tan_half_height = grid.TanHalfHeight;
+  auto tile_slope_x = 2.0f * tan_half_width / static_cast<float>(grid.TileCountX);
+  auto tile_slope_y = 2.0f * tan_half_height / static_cast<float>(grid.TileCountY);
+  auto tiles_per_slice = grid.TileCountX * grid.TileCountY;
+
+  for (auto slice = first_slice; slice < last_slice; ++slice) {
+    auto slice_near = grid.GetSliceDepth(slice);
+    auto slice_far = grid.GetSliceDepth(slice + 1);
+
+    auto z_lo = std::max(slice_near, z_min);
+    auto z_hi = std::min(slice_far, z_max);
+
+    uint32_t x_begin, x_end;
+    GetTileRange(sphere.Center.x - sphere.Radius, sphere.Center.x + sphere.Radius, z_lo, z_hi, tan_half_width, grid.TileCountX, &x_begin, &x_end);
+
+    // Rows are counted from the top of the screen
+    uint32_t y_up_begin, y_up_end;
+    GetTileRange(sphere.Center.y - sphere.Radius, sphere.Center.y + sphere.Radius, z_lo, z_hi, tan_half_height, grid.TileCountY, &y_up_begin, &y_up_end);
+    auto row_begin = grid.TileCountY - y_up_end;
+    auto row_end = grid.TileCountY - y_up_begin;
+
+    auto slice_near_v = DirectX::XMVectorReplicate(slice_near);
+    auto slice_far_v = DirectX::XMVectorReplicate(slice_far);
+
+    for (auto row = row_begin; row < row_end; ++row) {
+      auto slope_top = tan_half_height - tile_slope_y * static_cast<float>(row);
+      auto slope_bottom = slope_top - tile_slope_y;
+
+      for (auto x = x_begin; x < x_end; ++x) {
+        auto slope_left = -tan_half_width + tile_slope_x * static_cast<float>(x);
+        auto slope_right = slope_left + tile_slope_x;
+
+        // Cluster AABB from the tile slopes at the near and far depth of the slice
+        auto slopes_min = DirectX::XMVectorSet(slope_left, slope_bottom, 1.0f, 0.0f);
+        auto slopes_max = DirectX::XMVectorSet(slope_right, slope_top, 1.0f, 0.0f);
+        auto aabb_min = DirectX::XMVectorMin(DirectX::XMVectorMultiply(slopes_min, slice_near_v), DirectX::XMVectorMultiply(slopes_min, slice_far_v));
+        auto aabb_max = DirectX::XMVectorMax(DirectX::XMVectorMultiply(slopes_max, slice_near_v), DirectX::XMVectorMultiply(slopes_max, slice_far_v));
+
+        auto closest = DirectX::XMVectorClamp(center, aabb_min, aabb_max);
+        auto distance_squared = DirectX::XMVector3LengthSq(DirectX::XMVectorSubtract(center, closest));
+
+        if (DirectX::XMVector3LessOrEqual(distance_squared, radius_squared)) {
+          auto local_cluster_index = (slice - slice_begin) * tiles_per_slice + row * grid.TileCountX + x;
+          entries->push_back(local_cluster_index);
+          entries->push_back(light_index);
+        }
+      }
+    }
+  }
+}
+
+void BinSlices(const ClusterGrid& grid, uint32_t slice_begin, uint32_t slice_end,
+               const DirectX::BoundingSphere* point_lights, size_t point_light_count,
+               const DirectX::BoundingSphere* spot_lights, size_t spot_light_count, uint32_t max_lights_per_cluster,
+               std::vector<uint32_t>* entries, std::vector<uint32_t>* light_indices, Cluster* clusters, size_t* dropped_light_count) {
+  entries->clear();
+
+  // Point lights are gathered before spot lights so they end up first in every cluster
+  for (size_t i = 0; i < point_light_count; ++i) {
+    GatherLight(grid, slice_begin, slice_end, point_lights[i], static_cast<uint32_t>(i), entries);
+  }
+
+  for (size_t i = 0; i < spot_light_count; ++i) {
+    GatherLight(grid, slice_begin, slice_end, spot_lights[i], static_cast<uint32_t>(i) | SpotLightIndexFlag, entries);
+  }
+
+  // Counting sort of the entries by cluster
+  auto cluster_count = static_cast<size_t>(slice_end - slice_begin) * grid.TileCountX * grid.TileCountY;
+  std::fill(clusters, clusters + cluster_count, Cluster());
+
+  for (size_t i = 0; i < entries->size(); i += 2) {
+    auto& cluster = clusters[(*entries)[i]];
+    if ((*entries)[i + 1] & SpotLightIndexFlag) {
+      ++cluster.SpotLightCount;
+    } else {
+      ++cluster.PointLightCount;
+    }
+  }
+
+  // Full clusters keep their point lights first, the same order the entries were gathered in
+  uint32_t offset = 0;
+  *dropped_light_count = 0;
+  for (size_t i = 0; i < cluster_count; ++i) {
+    auto& cluster = clusters[i];
+    auto light_count = cluster.PointLightCount + cluster.SpotLightCount;
+    if (light_count > max_lights_per_cluster) {
+      *dropped_light_count += light_count - max_lights_per_cluster;
+      cluster.PointLightCount = std::min(cluster.PointLightCount, max_lights_per_cluster);
+      cluster.SpotLightCount = max_lights_per_cluster - cluster.PointLightCount;
+    }
+
+    cluster.Offset = offset;
+    offset += cluster.PointLightCount + cluster.SpotLightCount;
+  }
+
+  // Padding counts the lights written so far, all point light entries come before the spot light ones
+  light_indices->resize(offset);
+  for (size_t i = 0; i < entries->size(); i += 2) {
+    auto& cluster = clusters[(*entries)[i]];
+    auto is_spot_light = ((*entries)[i + 1] & SpotLightIndexFlag) != 0;
+    auto kept_count = is_spot_light ? cluster.PointLightCount + cluster.SpotLightCount : cluster.PointLightCount;
+    if (cluster.Padding < kept_count) {
+      (*light_indices)[cluster.Offset + cluster.Padding] = (*entries)[i + 1] & ~SpotLightIndexFlag;
+      ++cluster.Padding;
+    }
+  }
+
+  for (size_t i = 0; i < cluster_count; ++i) {
+    clusters[i].Padding = 0;
+  }
+}
+
+LightClusterBuilder::LightClusterBuilder()
+    : LightClusterBuilder(std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+LightClusterBuilder::LightClusterBuilder(size_t worker_count)
+    : m_worker_count_(std::max<size_t>(1, worker_count)),
+      m_worker_data_(m_worker_count_) {
+}
+
+void LightClusterBuilder::Build(const ClusterGrid& grid,
+                                const DirectX::BoundingSphere* point_lights, size_t point_light_count,
+                                const DirectX::BoundingSphere* spot_lights, size_t spot_light_count) {
+  m_clusters_.resize(grid.GetClusterCount());
+
+  auto tiles_per_slice = static_cast<size_t>(grid.TileCountX) * grid.TileCountY;
+  auto worker_count = std::min<size_t>(m_worker_count_, grid.SliceCount);
+  auto slices_per_worker = static_cast<uint32_t>((grid.SliceCount + worker_count - 1) / worker_count);
+
+  auto run_worker = [&](size_t worker_index) {
+    auto slice_begin = std::min(static_cast<uint32_t>(worker_index) * slices_per_worker, grid.SliceCount);
+    auto slice_end = std::min(slice_begin + slices_per_worker, grid.SliceCount);
+    auto& data = m_worker_data_[worker_index];
+    BinSlices(grid, slice_begin, slice_end, point_lights, point_light_count, spot_lights, spot_light_count, m_max_lights_per_cluster_,
+              &data.ClusterEntries, &data.LightIndices, m_clusters_.data() + slice_begin * tiles_per_slice, &data.DroppedLightCount);
+  };
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
+
+  run_worker(0);
+
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  // Merge the per worker index lists
+  m_light_indices_.clear();
+  m_dropped_light_count_ = 0;
+  for (size_t i = 0; i < worker_count; ++i) {
+    auto slice_begin = std::min(static_cast<uint32_t>(i) * slices_per_worker, grid.SliceCount);
+    auto slice_end = std::min(slice_begin + slices_per_worker, grid.SliceCount);
+    auto base_offset = static_cast<uint32_t>(m_light_indices_.size());
+
+    for (auto cluster_index = slice_begin * tiles_per_slice; cluster_index < slice_end * tiles_per_slice; ++cluster_index) {
+      m_clusters_[cluster_index].Offset += base_offset;
+    }
+
+    const auto& worker_indices = m_worker_data_[i].LightIndices;
+    m_light_indices_.insert(std::end(m_light_indices_), std::begin(worker_indices), std::end(worker_indices));
+    m_dropped_light_count_ += m_worker_data_[i].DroppedLightCount;
+  }
+}
+
+}  // namespace Lights
+}  // namespace Rendering
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace Rendering {
+namespace Lights {
+
+// Matches the Cluster struct in shaders/clustered.h
+struct Cluster {
+  uint32_t Offset = 0;
+  uint32_t PointLightCount = 0;
+  uint32_t SpotLightCount = 0;
+  uint32_t Padding = 0;
+};
+
+static_assert(sizeof(Cluster) == 16, "Cluster must match the HLSL layout");
+
+// Froxel grid - screen tiles along X/Y and exponential depth slices along Z
+struct ClusterGrid {
+  uint32_t TileCountX = 1;
+  uint32_t TileCountY = 1;
+  uint32_t SliceCount = 1;
+  float NearPlane = 1.0f;
+  float FarPlane = 2.0f;
+  float TanHalfWidth = 1.0f;  // Half width of the frustum at view space z = 1
+  float TanHalfHeight = 1.0f;  // Half height of the frustum at view space z = 1
+
+  size_t GetClusterCount() const {
+    return static_cast<size_t>(TileCountX) * TileCountY * SliceCount;
+  }
+
+  float GetSliceDepth(uint32_t slice) const;
+
+  // Maps log(z) to a slice index - slice = log(z) * scale + bias
+  float GetSliceScale() const;
+
+  float GetSliceBias() const;
+};
+
+ClusterGrid BuildClusterGrid(uint32_t tile_count_x, uint32_t tile_count_y, uint32_t slice_count,
+                             float near_plane, float far_plane, float frustum_width, float frustum_height);
+
+// Bins view space light bounding spheres into the clusters of a grid. The light index list holds
+// the point light indices of a cluster followed by its spot light indices. The build is split
+// along the depth slices between the workers. The builder does not touch the GPU.
+// A cluster holds at most max_lights_per_cluster lights, point lights are kept before spot lights
+// and lower indices before higher ones, the rest are dropped.
+class LightClusterBuilder {
+ public:
+  LightClusterBuilder();
+  explicit LightClusterBuilder(size_t worker_count);
+  ~LightClusterBuilder() = default;
+
+  LightClusterBuilder(const LightClusterBuilder&) = delete;
+  LightClusterBuilder& operator=(const LightClusterBuilder&) = delete;
+
+  LightClusterBuilder(LightClusterBuilder&&) = default;
+  LightClusterBuilder& operator=(LightClusterBuilder&&) = default;
+
+  void Build(const ClusterGrid& grid,
+             const DirectX::BoundingSphere* point_lights, size_t point_light_count,
+             const DirectX::BoundingSphere* spot_lights, size_t spot_light_count);
+
+  void SetMaxLightsPerCluster(uint32_t max_lights_per_cluster) {
+    m_max_lights_per_cluster_ = max_lights_per_cluster;
+  }
+
+  // Light entries dropped from full clusters by the last build
+  size_t GetDroppedLightCount() const {
+    return m_dropped_light_count_;
+  }
+
+  const std::vector<Cluster>& GetClusters() const {
+    return m_clusters_;
+  }
+
+  const std::vector<uint32_t>& GetLightIndices() const {
+    return m_light_indices_;
+  }
+
+ private:
+  struct WorkerData {
+    std::vector<uint32_t> ClusterEntries = {};  // Pairs of local cluster index and light index
+    std::vector<uint32_t> LightIndices = {};
+    size_t DroppedLightCount = 0;
+  };
+
+  size_t m_worker_count_ = 1;
+  uint32_t m_max_lights_per_cluster_ = UINT32_MAX;
+  size_t m_dropped_light_count_ = 0;
+  std::vector<WorkerData> m_worker_data_ = {};
+
+  std::vector<Cluster> m_clusters_ = {};
+  std::vector<uint32_t> m_light_indices_ = {};
+};
+
+}  // namespace Lights
+}  // namespace Rendering
@@ -0,0 +1,140 @@
+#include "light_culling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace Rendering {
+namespace Lights {
+
+DirectX::BoundingFrustum BuildViewSpaceFrustum(const DirectX::XMMATRIX& projection_matrix) {
+  return DirectX::BoundingFrustum(projection_matrix);
+}
+
+DirectX::BoundingSphere GetBoundingSphere(const PointLight& light) {
+  DirectX::BoundingSphere sphere;
+  DirectX::XMStoreFloat3(&sphere.Center, light.PositionViewSpace);
+  sphere.Radius = light.Range;
+  return sphere;
+}
+
+DirectX::BoundingSphere GetConeBoundingSphere(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, float half_angle, float range) {
+  // Tightest sphere around the cone - see https://bartwronski.com/2017/04/13/cull-that-cone/
+  auto cos_half_angle = std::cos(half_angle);
+  auto normalized_direction = DirectX::XMVector3Normalize(direction);
+
+  float center_distance;
+  DirectX::BoundingSphere sphere;
+  if (half_angle > DirectX::XM_PIDIV4) {
+    center_distance = cos_half_angle * range;
+    sphere.Radius = std::sin(half_angle) * range;
+  } else {
+    center_distance = range / (2.0f * cos_half_angle);
+    sphere.Radius = center_distance;
+  }
+
+  auto center = DirectX::XMVectorMultiplyAdd(normalized_direction, DirectX::XMVectorReplicate(center_distance), position);
+  DirectX::XMStoreFloat3(&sphere.Center, center);
+  return sphere;
+}
+
+DirectX::BoundingSphere GetBoundingSphere(const SpotLight& light) {
+  return GetConeBoundingSphere(light.PositionViewSpace, light.DirectionViewSpace, light.SpotlightAngle, light.Range);
+}
+
+DirectX::BoundingSphere GetWorldSpaceBoundingSphere(const PointLight& light) {
+  DirectX::BoundingSphere sphere;
+  DirectX::XMStoreFloat3(&sphere.Center, light.PositionWorldSpace);
+  sphere.Radius = light.Range;
+  return sphere;
+}
+
+DirectX::BoundingSphere GetWorldSpaceBoundingSphere(const SpotLight& light) {
+  return GetConeBoundingSphere(light.PositionWorldSpace, light.DirectionWorldSpace, light.SpotlightAngle, light.Range);
+}
+
+size_t CullDirectionalLights(const DirectionalLight* input, size_t input_count, size_t max_output_count, DirectionalLight* output,
+                             size_t* dropped_count) {
+  size_t output_count = 0;
+  size_t enabled_count = 0;
+  for (size_t i = 0; i < input_count; ++i) {
+    if (!input[i].Enabled) {
+      continue;
+    }
+
+    if (output_count < max_output_count) {
+      output[output_count++] = input[i];
+    }
+    ++enabled_count;
+  }
+
+  if (dropped_count != nullptr) {
+    *dropped_count = enabled_count - output_count;
+  }
+  return output_count;
+}
+
+template<typename T, typename G>
+size_t CullLights(const DirectX::BoundingFrustum& frustum, const T* input, size_t input_count,
+                  size_t max_output_count, G* output, std::vector<VisibleLight>* visible_lights, uint32_t* source_indices,
+                  size_t* dropped_count) {
+  visible_lights->clear();
+  for (size_t i = 0; i < input_count; ++i) {
+    if (!input[i].Enabled) {
+      continue;
+    }
+
+    auto sphere = GetBoundingSphere(input[i]);
+    if (frustum.Intersects(sphere)) {
+      auto center_distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&sphere.Center)));
+      visible_lights->push_back({ static_cast<uint32_t>(i), std::max(center_distance - sphere.Radius, 0.0f) });
+    }
+  }
+
+  // Over the limit the closest lights are kept, they cover the most of the screen. The kept lights stay in
+  // input order so their GPU indices don't shuffle from frame to frame.
+  size_t dropped = 0;
+  if (visible_lights->size() > max_output_count) {
+    dropped = visible_lights->size() - max_output_count;
+
+    auto kept_end = std::begin(*visible_lights) + max_output_count;
+    std::nth_element(std::begin(*visible_lights), kept_end, std::end(*visible_lights), [](const auto& lhs, const auto& rhs) {
+      return lhs.Distance < rhs.Distance || (lhs.Distance == rhs.Distance && lhs.Index < rhs.Index);
+    });
+    visible_lights->erase(kept_end, std::end(*visible_lights));
+
+    std::sort(std::begin(*visible_lights), std::end(*visible_lights), [](const auto& lhs, const auto& rhs) {
+      return lhs.Index < rhs.Index;
+    });
+  }
+
+  for (size_t i = 0; i < visible_lights->size(); ++i) {
+    if (source_indices != nullptr) {
+      source_indices[i] = (*visible_lights)[i].Index;
+    }
+    output[i] = Pack(input[(*visible_lights)[i].Index]);
+  }
+
+  if (dropped_count != nullptr) {
+    *dropped_count = dropped;
+  }
+  return visible_lights->size();
+}
+
+size_t CullPointLights(const DirectX::BoundingFrustum& frustum, const PointLight* input, size_t input_count,
+                       size_t max_output_count, GpuPointLight* output, std::vector<VisibleLight>* visible_lights,
+                       uint32_t* source_indices, size_t* dropped_count) {
+  return CullLights(frustum, input, input_count, max_output_count, output, visible_lights, source_indices, dropped_count);
+}
+
+size_t CullSpotLights(const DirectX::BoundingFrustum& frustum, const SpotLight* input, size_t input_count,
+                      size_t max_output_count, GpuSpotLight* output, std::vector<VisibleLight>* visible_lights,
+                      uint32_t* source_indices, size_t* dropped_count) {
+  return CullLights(frustum, input, input_count, max_output_count, output, visible_lights, source_indices, dropped_count);
+}
+
+}  // namespace Lights
+}  // namespace Rendering
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "rendering/lights/directional_light.h"
+#include "rendering/lights/gpu_lights.h"
+#include "rendering/lights/point_light.h"
+#include "rendering/lights/spot_light.h"
+
+namespace Rendering {
+namespace Lights {
+
+struct VisibleLight {
+  uint32_t Index;
+  float Distance;  // From the camera to the closest point of the bounds, view space
+};
+
+DirectX::BoundingFrustum BuildViewSpaceFrustum(const DirectX::XMMATRIX& projection_matrix);
+
+DirectX::BoundingSphere GetBoundingSphere(const PointLight& light);
+
+DirectX::BoundingSphere GetBoundingSphere(const SpotLight& light);
+
+DirectX::BoundingSphere GetWorldSpaceBoundingSphere(const PointLight& light);
+
+DirectX::BoundingSphere GetWorldSpaceBoundingSphere(const SpotLight& light);
+
+// Each Cull* function copies the enabled (and for point/spot lights - visible) lights from input into output,
+// packing point and spot lights to their GPU format, and returns the number of lights written. Lights are expected to be updated to view space beforehand.
+// If source_indices is not null the index of each written light in input is stored there. When more lights pass than
+// fit the output the point and spot lights closest to the camera are kept, dropped_count receives how many didn't fit.
+// visible_lights is scratch space, it is cleared on every call and can be reused across frames to avoid allocations.
+size_t CullDirectionalLights(const DirectionalLight* input, size_t input_count, size_t max_output_count, DirectionalLight* output,
+                             size_t* dropped_count = nullptr);
+
+size_t CullPointLights(const DirectX::BoundingFrustum& frustum, const PointLight* input, size_t input_count,
+                       size_t max_output_count, GpuPointLight* output, std::vector<VisibleLight>* visible_lights, uint32_t* source_indices = nullptr,
+                       size_t* dropped_count = nullptr);
+
+size_t CullSpotLights(const DirectX::BoundingFrustum& frustum, const SpotLight* input, size_t input_count,
+                      size_t max_output_count, GpuSpotLight* output, std::vector<VisibleLight>* visible_lights, uint32_t* source_indices = nullptr,
+                      size_t* dropped_count = nullptr);
+
+}  // namespace Lights
+}  // namespace Rendering
@@ -0,0 +1,218 @@
+#include "light_spatial_hash.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "rendering/lights/light_culling.h"
+
+namespace Rendering {
+namespace Lights {
+
+constexpr static const uint32_t SpotLightIdFlag = 0x80000000u;
+
+uint64_t LightSpatialHash::GetCellKey(int32_t x, int32_t y, int32_t z) {
+  const uint64_t mask = (1 << 21) - 1;
+  return ((static_cast<uint64_t>(x) & mask) << 42) | ((static_cast<uint64_t>(y) & mask) << 21) | (static_cast<uint64_t>(z) & mask);
+}
+
+// Cell coordinates wrap at 21 bits in the keys, the range is kept inside that so the float to int casts can't overflow
+constexpr static const float MaxCellCoordinate = static_cast<float>((1 << 20) - 1);
+
+bool LightSpatialHash::GetCellRange(const DirectX::BoundingSphere& sphere, CellRange* range) const {
+  const float center[3] = { sphere.Center.x, sphere.Center.y, sphere.Center.z };
+
+  CellRange result;
+  for (size_t axis = 0; axis < 3; ++axis) {
+    auto min_cell = std::floor((center[axis] - sphere.Radius) / m_cell_size_);
+    auto max_cell = std::floor((center[axis] + sphere.Radius) / m_cell_size_);
+
+    // Written so NaNs fail as well
+    if (!(min_cell >= -MaxCellCoordinate && max_cell <= MaxCellCoordinate)) {
+      return false;
+    }
+
+    result.Min[axis] = static_cast<int32_t>(min_cell);
+    result.Max[axis] = static_cast<int32_t>(max_cell);
+  }
+
+  *range = result;
+  return true;
+}
+
+void LightSpatialHash::Insert(uint32_t light_id, const CellRange& cells) {
+  for (auto x = cells.Min[0]; x <= cells.Max[0]; ++x) {
+    for (auto y = cells.Min[1]; y <= cells.Max[1]; ++y) {
+      for (auto z = cells.Min[2]; z <= cells.Max[2]; ++z) {
+        m_cells_[GetCellKey(x, y, z)].push_back(light_id);
+      }
+    }
+  }
+}
+
+void LightSpatialHash::Remove(uint32_t light_id, const CellRange& cells) {
+  for (auto x = cells.Min[0]; x <= cells.Max[0]; ++x) {
+    for (auto y = cells.Min[1]; y <= cells.Max[1]; ++y) {
+      for (auto z = cells.Min[2]; z <= cells.Max[2]; ++z) {
+        auto it = m_cells_.find(GetCellKey(x, y, z));
+        if (it == std::end(m_cells_)) {
+          continue;
+        }
+
+        auto& cell = it->second;
+        auto light_it = std::find(std::begin(cell), std::end(cell), light_id);
+        if (light_it != std::end(cell)) {
+          *light_it = cell.back();
+          cell.pop_back();
+        }
+
+        if (cell.empty()) {
+          m_cells_.erase(it);
+        }
+      }
+    }
+  }
+}
+
+void LightSpatialHash::UpdateLight(uint32_t light_id, const DirectX::BoundingSphere& bounds, float intensity, bool enabled) {
+  auto& entries = (light_id & SpotLightIdFlag) ? m_spot_lights_ : m_point_lights_;
+  auto& entry = entries[light_id & ~SpotLightIdFlag];
+
+  CellRange cells;
+  bool is_large = false;
+  if (enabled) {
+    is_large = !GetCellRange(bounds, &cells) || cells.GetMaxSpan() > MaxLightCellSpan;
+    if (is_large) {
+      cells = CellRange();
+    }
+  }
+
+  if (!(cells == entry.Cells)) {
+    Remove(light_id, entry.Cells);
+    Insert(light_id, cells);
+    entry.Cells = cells;
+    ++m_reinserted_count_;
+  }
+
+  if (is_large != entry.IsLarge) {
+    if (is_large) {
+      m_large_lights_.push_back(light_id);
+    } else {
+      auto light_it = std::find(std::begin(m_large_lights_), std::end(m_large_lights_), light_id);
+      *light_it = m_large_lights_.back();
+      m_large_lights_.pop_back();
+    }
+    entry.IsLarge = is_large;
+  }
+
+  entry.Bounds = bounds;
+  entry.Intensity = intensity;
+}
+
+void LightSpatialHash::Update(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights) {
+  // Light ids are indices into the input vectors, so if their sizes change everything is rebuilt
+  if (point_lights.size() != m_point_lights_.size() || spot_lights.size() != m_spot_lights_.size()) {
+    m_cells_.clear();
+    m_large_lights_.clear();
+    m_point_lights_.assign(point_lights.size(), LightEntry());
+    m_spot_lights_.assign(spot_lights.size(), LightEntry());
+  }
+
+  m_reinserted_count_ = 0;
+
+  for (size_t i = 0; i < point_lights.size(); ++i) {
+    const auto& light = point_lights[i];
+    UpdateLight(static_cast<uint32_t>(i), GetWorldSpaceBoundingSphere(light), light.Intensity, light.Enabled);
+  }
+
+  for (size_t i = 0; i < spot_lights.size(); ++i) {
+    const auto& light = spot_lights[i];
+    UpdateLight(static_cast<uint32_t>(i) | SpotLightIdFlag, GetWorldSpaceBoundingSphere(light), light.Intensity, light.Enabled);
+  }
+}
+
+void LightSpatialHash::AddCandidate(uint32_t light_id, const DirectX::BoundingSphere& sphere,
+                                    const std::vector<uint32_t>& point_light_gpu_indices, const std::vector<uint32_t>& spot_light_gpu_indices) {
+  auto is_spot_light = (light_id & SpotLightIdFlag) != 0;
+  auto light_index = light_id & ~SpotLightIdFlag;
+  auto& entries = is_spot_light ? m_spot_lights_ : m_point_lights_;
+  auto& entry = entries[light_index];
+
+  // Lights spanning several cells are only considered once per query
+  if (entry.QueryStamp == m_query_stamp_) {
+    return;
+  }
+  entry.QueryStamp = m_query_stamp_;
+
+  // Lights culled from the GPU buffers can't take one of the object's slots
+  const auto& gpu_indices = is_spot_light ? spot_light_gpu_indices : point_light_gpu_indices;
+  if (light_index >= gpu_indices.size() || gpu_indices[light_index] == InvalidGpuLightIndex) {
+    return;
+  }
+
+  auto light_center = DirectX::XMLoadFloat3(&entry.Bounds.Center);
+  auto sphere_center = DirectX::XMLoadFloat3(&sphere.Center);
+  auto center_distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(light_center, sphere_center)));
+  auto distance = std::max(center_distance - sphere.Radius, 0.0f);
+  if (!(distance < entry.Bounds.Radius)) {
+    return;
+  }
+
+  auto falloff = 1.0f - distance / entry.Bounds.Radius;
+  m_candidates_.emplace_back(entry.Intensity * falloff * falloff, gpu_indices[light_index] | (light_id & SpotLightIdFlag));
+}
+
+void LightSpatialHash::Query(const DirectX::BoundingSphere& sphere, const std::vector<uint32_t>& point_light_gpu_indices,
+                             const std::vector<uint32_t>& spot_light_gpu_indices, ObjectLightList* output) {
+  ++m_query_stamp_;
+  m_candidates_.clear();
+
+  // A sphere covering more cells than are occupied walks the occupied cells instead of probing its whole range
+  CellRange cells;
+  if (!GetCellRange(sphere, &cells) || cells.GetCellCount() > m_cells_.size()) {
+    for (const auto& cell : m_cells_) {
+      for (auto light_id : cell.second) {
+        AddCandidate(light_id, sphere, point_light_gpu_indices, spot_light_gpu_indices);
+      }
+    }
+  } else {
+    for (auto x = cells.Min[0]; x <= cells.Max[0]; ++x) {
+      for (auto y = cells.Min[1]; y <= cells.Max[1]; ++y) {
+        for (auto z = cells.Min[2]; z <= cells.Max[2]; ++z) {
+          auto it = m_cells_.find(GetCellKey(x, y, z));
+          if (it == std::end(m_cells_)) {
+            continue;
+          }
+
+          for (auto light_id : it->second) {
+            AddCandidate(light_id, sphere, point_light_gpu_indices, spot_light_gpu_indices);
+          }
+        }
+      }
+    }
+  }
+
+  for (auto light_id : m_large_lights_) {
+    AddCandidate(light_id, sphere, point_light_gpu_indices, spot_light_gpu_indices);
+  }
+
+  auto selected_count = std::min(m_candidates_.size(), MaxObjectLights);
+  std::partial_sort(std::begin(m_candidates_), std::begin(m_candidates_) + selected_count, std::end(m_candidates_),
+                    [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+  output->PointLightCount = 0;
+  output->SpotLightCount = 0;
+  for (size_t i = 0; i < selected_count; ++i) {
+    auto light_id = m_candidates_[i].second;
+    if (light_id & SpotLightIdFlag) {
+      output->SpotLightIndices[output->SpotLightCount++] = light_id & ~SpotLightIdFlag;
+    } else {
+      output->PointLightIndices[output->PointLightCount++] = light_id;
+    }
+  }
+}
+
+}  // namespace Lights
+}  // namespace Rendering
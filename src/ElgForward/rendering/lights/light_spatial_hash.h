@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "core/memory_helpers.h"
+#include "rendering/lights/point_light.h"
+#include "rendering/lights/spot_light.h"
+
+namespace Rendering {
+namespace Lights {
+
+constexpr static const size_t MaxObjectLights = 8;
+
+constexpr static const int32_t MaxLightCellSpan = 8;
+
+// Marks lights without a slot in the GPU light buffers
+constexpr static const uint32_t InvalidGpuLightIndex = static_cast<uint32_t>(-1);
+
+// Matches the light list part of PerObject in shaders/basic.h
+struct ObjectLightList {
+  uint32_t PointLightCount = 0;
+  uint32_t SpotLightCount = 0;
+  PAD(8);
+  uint32_t PointLightIndices[MaxObjectLights] = {};
+  uint32_t SpotLightIndices[MaxObjectLights] = {};
+};
+
+static_assert(sizeof(ObjectLightList) == 16 + 2 * 4 * MaxObjectLights, "ObjectLightList must match the HLSL layout");
+
+// Uniform world space hash grid of point and spot light bounding spheres. Lights are only
+// re-inserted when the set of cells they overlap changes. Lights spanning more than MaxLightCellSpan
+// cells along an axis are kept out of the grid in a list every query tests.
+class LightSpatialHash {
+ public:
+  explicit LightSpatialHash(float cell_size = 4.0f) : m_cell_size_(cell_size) {
+  }
+
+  ~LightSpatialHash() = default;
+
+  LightSpatialHash(const LightSpatialHash&) = delete;
+  LightSpatialHash& operator=(const LightSpatialHash&) = delete;
+
+  LightSpatialHash(LightSpatialHash&&) = default;
+  LightSpatialHash& operator=(LightSpatialHash&&) = default;
+
+  void Update(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights);
+
+  // Selects up to MaxObjectLights lights with the highest attenuated intensity at the sphere among the lights
+  // that have a GPU index. The gpu index vectors map the light vectors passed to Update to the GPU light buffers,
+  // the returned indices are GPU indices.
+  void Query(const DirectX::BoundingSphere& sphere, const std::vector<uint32_t>& point_light_gpu_indices,
+             const std::vector<uint32_t>& spot_light_gpu_indices, ObjectLightList* output);
+
+  size_t GetReinsertedCount() const {
+    return m_reinserted_count_;
+  }
+
+ private:
+  struct CellRange {
+    int32_t Min[3] = { 0, 0, 0 };
+    int32_t Max[3] = { -1, -1, -1 };
+
+    bool IsEmpty() const {
+      return Max[0] < Min[0];
+    }
+
+    int32_t GetMaxSpan() const {
+      return std::max({ Max[0] - Min[0] + 1, Max[1] - Min[1] + 1, Max[2] - Min[2] + 1 });
+    }
+
+    uint64_t GetCellCount() const {
+      if (IsEmpty()) {
+        return 0;
+      }
+      return static_cast<uint64_t>(Max[0] - Min[0] + 1) * static_cast<uint64_t>(Max[1] - Min[1] + 1) * static_cast<uint64_t>(Max[2] - Min[2] + 1);
+    }
+
+    bool operator==(const CellRange& other) const {
+      return Min[0] == other.Min[0] && Min[1] == other.Min[1] && Min[2] == other.Min[2]
+          && Max[0] == other.Max[0] && Max[1] == other.Max[1] && Max[2] == other.Max[2];
+    }
+  };
+
+  struct LightEntry {
+    DirectX::BoundingSphere Bounds = {};
+    float Intensity = 0.0f;
+    CellRange Cells = {};
+    bool IsLarge = false;  // In m_large_lights_ instead of the cells
+    uint32_t QueryStamp = 0;
+  };
+
+  // False when the sphere reaches past the cell coordinates a key can hold or isn't finite
+  bool GetCellRange(const DirectX::BoundingSphere& sphere, CellRange* range) const;
+
+  void UpdateLight(uint32_t light_id, const DirectX::BoundingSphere& bounds, float intensity, bool enabled);
+
+  void Insert(uint32_t light_id, const CellRange& cells);
+
+  void Remove(uint32_t light_id, const CellRange& cells);
+
+  void AddCandidate(uint32_t light_id, const DirectX::BoundingSphere& sphere,
+                    const std::vector<uint32_t>& point_light_gpu_indices, const std::vector<uint32_t>& spot_light_gpu_indices);
+
+  static uint64_t GetCellKey(int32_t x, int32_t y, int32_t z);
+
+  float m_cell_size_;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells_ = {};
+  std::vector<LightEntry> m_point_lights_ = {};
+  std::vector<LightEntry> m_spot_lights_ = {};
+  std::vector<uint32_t> m_large_lights_ = {};
+  std::vector<std::pair<float, uint32_t>> m_candidates_ = {};  // Score and GPU light id
+  uint32_t m_query_stamp_ = 0;
+  size_t m_reinserted_count_ = 0;
+};
+
+}  // namespace Lights
+}  // namespace Rendering
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <d3d11.h>
+
 #include "core/buffer.h"
 #include "rendering/vertex_shader.h"
 #include "rendering/pixel_shader.h"
@@ -8,6 +10,8 @@
 namespace Rendering {
 namespace Material {
 
+const uint32_t NoTableIndex = static_cast<uint32_t>(-1);
+
 struct Material {
   Material() = default;
   ~Material() = default;
@@ -24,8 +28,15 @@ struct Material {
   PixelShader::Handle PixelShader = {};
   std::array<Texture::Handle, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> PixelShaderTextures = {};
 
+  D3D11_RASTERIZER_DESC RasterizerState = CD3D11_RASTERIZER_DESC(CD3D11_DEFAULT());
+  D3D11_BLEND_DESC BlendState = CD3D11_BLEND_DESC(CD3D11_DEFAULT());
+  D3D11_DEPTH_STENCIL_DESC DepthStencilState = CD3D11_DEPTH_STENCIL_DESC(CD3D11_DEFAULT());
+
   Core::Buffer Data = {};
   size_t TypeHash = 0;
+
+  // Index into the material table of the type, materials stored there get no constant buffer
+  uint32_t TableIndex = NoTableIndex;
 };
 
 }  // namespace Material
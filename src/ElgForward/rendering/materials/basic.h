@@ -12,7 +12,36 @@ struct Basic {
   DirectX::XMVECTOR SpecularColor = { 0.0f, 0.0f, 0.0f, 1.0f };
   float SpecularPower = 10.0f;
   bool HasDiffuseTexture = false;
+  uint32_t DiffuseTextureLayer = 0;  // Slice when the diffuse texture is a packed texture array
+  DirectX::XMVECTOR DiffuseTextureUvScaleOffset = { 1.0f, 1.0f, 0.0f, 0.0f };  // Region when it is packed into an atlas
 };
 
+// Element of the basic material table, matches BasicMaterial in shaders/basic_material.h
+struct GpuBasic {
+  DirectX::XMFLOAT4 DiffuseColor;
+  DirectX::XMFLOAT4 SpecularColor;
+  float SpecularPower;
+  uint32_t HasDiffuseTexture;
+  uint32_t DiffuseTextureLayer;
+  PAD(4);
+  DirectX::XMFLOAT4 DiffuseTextureUvScaleOffset;
+};
+
+static_assert(sizeof(GpuBasic) == 64, "GpuBasic must match the HLSL structured buffer stride");
+
+const char* const BasicMaterialTableName = "BasicMaterials";
+const size_t MaxBasicMaterials = 1024;
+
+inline GpuBasic Pack(const Basic& material) {
+  GpuBasic result;
+  DirectX::XMStoreFloat4(&result.DiffuseColor, material.DiffuseColor);
+  DirectX::XMStoreFloat4(&result.SpecularColor, material.SpecularColor);
+  result.SpecularPower = material.SpecularPower;
+  result.HasDiffuseTexture = material.HasDiffuseTexture ? 1 : 0;
+  result.DiffuseTextureLayer = material.DiffuseTextureLayer;
+  DirectX::XMStoreFloat4(&result.DiffuseTextureUvScaleOffset, material.DiffuseTextureUvScaleOffset);
+  return result;
+}
+
 }  // namespace Materials
 }  // namespace Rendering
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include <d3d11.h>
+#include <DirectXCollision.h>
 
 #include "core/filesystem.h"
 #include "vertex_data.h"
@@ -32,6 +33,8 @@ struct Mesh {
   Rendering::IndexBuffer::Handle IndexBuffer = {};
   DXGI_FORMAT IndexBufferFormat = DXGI_FORMAT_UNKNOWN;
   uint32_t IndexCount = 0;
+
+  DirectX::BoundingSphere Bounds = {};
 };
 
 struct MeshTag {};
@@ -0,0 +1,182 @@
+#include "rendering/mip_generation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <emmintrin.h>
+
+namespace Rendering {
+namespace MipGeneration {
+
+const size_t LinearToSrgbTableSize = 4096;
+
+float SrgbToLinear(float value) {
+  return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float value) {
+  return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& GetSrgbToLinearTable() {
+  static const auto table = [] {
+    std::array<float, 256> result;
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] = SrgbToLinear(static_cast<float>(i) / 255.0f);
+    }
+    return result;
+  }();
+  return table;
+}
+
+const std::array<uint8_t, LinearToSrgbTableSize>& GetLinearToSrgbTable() {
+  static const auto table = [] {
+    std::array<uint8_t, LinearToSrgbTableSize> result;
+    for (size_t i = 0; i < result.size(); ++i) {
+      auto value = LinearToSrgb(static_cast<float>(i) / static_cast<float>(LinearToSrgbTableSize - 1));
+      result[i] = static_cast<uint8_t>(std::min(255.0f, value * 255.0f + 0.5f));
+    }
+    return result;
+  }();
+  return table;
+}
+
+uint32_t GetMipCount(uint32_t width, uint32_t height) {
+  uint32_t count = 1;
+  while (width > 1 || height > 1) {
+    width = std::max(1u, width / 2);
+    height = std::max(1u, height / 2);
+    ++count;
+  }
+  return count;
+}
+
+// Broadcasts the last lane of scale to the color lanes, alpha itself is left unscaled
+__m128 GetColorScale(__m128 scale) {
+  const auto alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  auto factor = _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_or_ps(_mm_andnot_ps(alpha_lane, factor), _mm_and_ps(alpha_lane, _mm_set1_ps(1.0f)));
+}
+
+// Expands to linear RGBA - channels missing from the source are zero and alpha defaults to opaque
+void LoadLevel(const Texture::ImageData& image, bool srgb, bool premultiply, std::vector<__m128>* pixels) {
+  const auto& srgb_to_linear = GetSrgbToLinearTable();
+  const auto scale = _mm_set1_ps(1.0f / 255.0f);
+
+  pixels->resize(static_cast<size_t>(image.Width) * image.Height);
+
+  for (size_t i = 0; i < pixels->size(); ++i) {
+    auto source = image.Data + i * image.Components;
+
+    alignas(16) float rgba[4] = { 0.0f, 0.0f, 0.0f, 255.0f };
+    for (uint8_t c = 0; c < image.Components; ++c) {
+      rgba[c] = (srgb && c < 3) ? srgb_to_linear[source[c]] * 255.0f : source[c];
+    }
+
+    auto pixel = _mm_mul_ps(_mm_load_ps(rgba), scale);
+
+    if (premultiply) {
+      pixel = _mm_mul_ps(pixel, GetColorScale(pixel));
+    }
+
+    (*pixels)[i] = pixel;
+  }
+}
+
+void Downsample(const std::vector<__m128>& source, uint32_t source_width, uint32_t source_height,
+                uint32_t width, uint32_t height, std::vector<__m128>* destination) {
+  const auto quarter = _mm_set1_ps(0.25f);
+
+  destination->resize(static_cast<size_t>(width) * height);
+
+  for (uint32_t y = 0; y < height; ++y) {
+    auto row0 = source.data() + static_cast<size_t>(std::min(y * 2, source_height - 1)) * source_width;
+    auto row1 = source.data() + static_cast<size_t>(std::min(y * 2 + 1, source_height - 1)) * source_width;
+    auto output = destination->data() + static_cast<size_t>(y) * width;
+
+    for (uint32_t x = 0; x < width; ++x) {
+      auto x0 = std::min(x * 2, source_width - 1);
+      auto x1 = std::min(x * 2 + 1, source_width - 1);
+      auto sum = _mm_add_ps(_mm_add_ps(row0[x0], row0[x1]), _mm_add_ps(row1[x0], row1[x1]));
+      output[x] = _mm_mul_ps(sum, quarter);
+    }
+  }
+}
+
+void StoreLevel(const std::vector<__m128>& pixels, uint8_t components, bool srgb, bool premultiplied, std::vector<uint8_t>* data) {
+  const auto& linear_to_srgb = GetLinearToSrgbTable();
+  const auto zero = _mm_setzero_ps();
+  const auto one = _mm_set1_ps(1.0f);
+  const auto scale = _mm_set1_ps(255.0f);
+  const auto table_scale = _mm_set1_ps(static_cast<float>(LinearToSrgbTableSize - 1));
+
+  data->resize(pixels.size() * components);
+
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    auto pixel = pixels[i];
+
+    if (premultiplied) {
+      auto alpha = _mm_cvtss_f32(_mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)));
+      if (alpha > 0.0f) {
+        pixel = _mm_mul_ps(pixel, GetColorScale(_mm_set1_ps(1.0f / alpha)));
+      }
+    }
+
+    pixel = _mm_min_ps(_mm_max_ps(pixel, zero), one);
+
+    alignas(16) int32_t unorm[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(unorm), _mm_cvtps_epi32(_mm_mul_ps(pixel, scale)));
+
+    if (srgb) {
+      alignas(16) int32_t indices[4];
+      _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvtps_epi32(_mm_mul_ps(pixel, table_scale)));
+      for (int c = 0; c < std::min<int>(components, 3); ++c) {
+        unorm[c] = linear_to_srgb[indices[c]];
+      }
+    }
+
+    auto destination = data->data() + i * components;
+    for (uint8_t c = 0; c < components; ++c) {
+      destination[c] = static_cast<uint8_t>(unorm[c]);
+    }
+  }
+}
+
+bool Generate(const Texture::ImageData& image, bool srgb, std::vector<Level>* levels) {
+  if (image.Data == nullptr || image.Width == 0 || image.Height == 0 || image.Components == 0 || image.Components > 4) {
+    return false;
+  }
+
+  bool color_srgb = srgb && image.Components >= 3;
+  bool premultiply = image.Components == 4;
+
+  std::vector<__m128> current;
+  std::vector<__m128> next;
+  LoadLevel(image, color_srgb, premultiply, &current);
+
+  auto width = image.Width;
+  auto height = image.Height;
+  auto count = GetMipCount(width, height);
+
+  for (uint32_t i = 1; i < count; ++i) {
+    auto next_width = std::max(1u, width / 2);
+    auto next_height = std::max(1u, height / 2);
+    Downsample(current, width, height, next_width, next_height, &next);
+
+    Level level;
+    level.Width = next_width;
+    level.Height = next_height;
+    StoreLevel(next, image.Components, color_srgb, premultiply, &level.Data);
+    levels->emplace_back(std::move(level));
+
+    std::swap(current, next);
+    width = next_width;
+    height = next_height;
+  }
+
+  return true;
+}
+
+}  // namespace MipGeneration
+}  // namespace Rendering
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rendering/texture.h"
+
+namespace Rendering {
+namespace MipGeneration {
+
+struct Level {
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  std::vector<uint8_t> Data = {};
+};
+
+// Number of levels in a full chain, including the top level
+uint32_t GetMipCount(uint32_t width, uint32_t height);
+
+// Builds every level below an 8 bit per channel image down to 1x1 with a 2x2 box filter. Levels are filtered from
+// the previous level kept in float, so rounding doesn't accumulate down the chain. With srgb set the color channels
+// are averaged in linear space, and four channel images are averaged with premultiplied alpha so transparent texels
+// don't bleed into their neighbours. Odd sizes drop the last row or column of the level above.
+bool Generate(const Texture::ImageData& image, bool srgb, std::vector<Level>* levels);
+
+}  // namespace MipGeneration
+}  // namespace Rendering
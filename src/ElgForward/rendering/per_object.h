@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/memory_helpers.h"
+#include "rendering/transform_and_inverse_transpose.h"
+#include "rendering/lights/light_spatial_hash.h"
+
+namespace Rendering {
+
+// Matches PerObject in shaders/basic.h, the object structured buffer holds one for every drawable drawn in a frame
+struct PerObject {
+  Transform::TransformAndInverseTranspose Transform;
+  Lights::ObjectLightList Lights;
+  uint32_t MaterialIndex = 0;  // Entry in the material table, only read by material table shader permutations
+  PAD(12);
+};
+
+static_assert(sizeof(PerObject) == 224, "PerObject must match the HLSL layout");
+
+// Matches PerDrawConstants in shaders/basic.h
+struct PerDraw {
+  uint32_t ObjectIndex = 0;  // Entry in the object structured buffer
+  PAD(12);
+};
+
+}  // namespace Rendering
@@ -0,0 +1,239 @@
+#include "pipeline_state.h"
+
+#include <d3d11.h>
+#include <wrl.h>
+
+#include <dxfw/dxfw.h>
+
+#include "core/hash.h"
+#include "core/resource_array.h"
+#include "core/handle_cache.h"
+
+namespace Rendering {
+namespace PipelineState {
+
+struct PipelineStateData {
+  Microsoft::WRL::ComPtr<ID3D11VertexShader> VertexShader;
+  Microsoft::WRL::ComPtr<ID3D11PixelShader> PixelShader;
+  Microsoft::WRL::ComPtr<ID3D11InputLayout> VertexLayout;
+  D3D11_PRIMITIVE_TOPOLOGY PrimitiveTopology;
+  Microsoft::WRL::ComPtr<ID3D11RasterizerState> RasterizerState;
+  Microsoft::WRL::ComPtr<ID3D11BlendState> BlendState;
+  Microsoft::WRL::ComPtr<ID3D11DepthStencilState> DepthStencilState;
+};
+
+// Pipelines are cached by the whole description, the hash only picks the bucket
+struct DescriptionKey {
+  Description Value = {};
+  size_t Hash = 0;
+};
+
+template<typename H>
+bool IsSameHandle(H lhs, H rhs) {
+  return lhs.CompactForm() == rhs.CompactForm();
+}
+
+bool IsSameDescription(const D3D11_RASTERIZER_DESC& lhs, const D3D11_RASTERIZER_DESC& rhs) {
+  return lhs.FillMode == rhs.FillMode
+    && lhs.CullMode == rhs.CullMode
+    && lhs.FrontCounterClockwise == rhs.FrontCounterClockwise
+    && lhs.DepthBias == rhs.DepthBias
+    && lhs.DepthBiasClamp == rhs.DepthBiasClamp
+    && lhs.SlopeScaledDepthBias == rhs.SlopeScaledDepthBias
+    && lhs.DepthClipEnable == rhs.DepthClipEnable
+    && lhs.ScissorEnable == rhs.ScissorEnable
+    && lhs.MultisampleEnable == rhs.MultisampleEnable
+    && lhs.AntialiasedLineEnable == rhs.AntialiasedLineEnable;
+}
+
+bool IsSameDescription(const D3D11_RENDER_TARGET_BLEND_DESC& lhs, const D3D11_RENDER_TARGET_BLEND_DESC& rhs) {
+  return lhs.BlendEnable == rhs.BlendEnable
+    && lhs.SrcBlend == rhs.SrcBlend
+    && lhs.DestBlend == rhs.DestBlend
+    && lhs.BlendOp == rhs.BlendOp
+    && lhs.SrcBlendAlpha == rhs.SrcBlendAlpha
+    && lhs.DestBlendAlpha == rhs.DestBlendAlpha
+    && lhs.BlendOpAlpha == rhs.BlendOpAlpha
+    && lhs.RenderTargetWriteMask == rhs.RenderTargetWriteMask;
+}
+
+bool IsSameDescription(const D3D11_BLEND_DESC& lhs, const D3D11_BLEND_DESC& rhs) {
+  if (lhs.AlphaToCoverageEnable != rhs.AlphaToCoverageEnable || lhs.IndependentBlendEnable != rhs.IndependentBlendEnable) {
+    return false;
+  }
+
+  for (size_t i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i) {
+    if (!IsSameDescription(lhs.RenderTarget[i], rhs.RenderTarget[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsSameDescription(const D3D11_DEPTH_STENCILOP_DESC& lhs, const D3D11_DEPTH_STENCILOP_DESC& rhs) {
+  return lhs.StencilFailOp == rhs.StencilFailOp
+    && lhs.StencilDepthFailOp == rhs.StencilDepthFailOp
+    && lhs.StencilPassOp == rhs.StencilPassOp
+    && lhs.StencilFunc == rhs.StencilFunc;
+}
+
+bool IsSameDescription(const D3D11_DEPTH_STENCIL_DESC& lhs, const D3D11_DEPTH_STENCIL_DESC& rhs) {
+  return lhs.DepthEnable == rhs.DepthEnable
+    && lhs.DepthWriteMask == rhs.DepthWriteMask
+    && lhs.DepthFunc == rhs.DepthFunc
+    && lhs.StencilEnable == rhs.StencilEnable
+    && lhs.StencilReadMask == rhs.StencilReadMask
+    && lhs.StencilWriteMask == rhs.StencilWriteMask
+    && IsSameDescription(lhs.FrontFace, rhs.FrontFace)
+    && IsSameDescription(lhs.BackFace, rhs.BackFace);
+}
+
+bool IsSameDescription(const Description& lhs, const Description& rhs) {
+  return IsSameHandle(lhs.VertexShader, rhs.VertexShader)
+    && IsSameHandle(lhs.PixelShader, rhs.PixelShader)
+    && IsSameHandle(lhs.VertexLayout, rhs.VertexLayout)
+    && lhs.PrimitiveTopology == rhs.PrimitiveTopology
+    && IsSameDescription(lhs.RasterizerState, rhs.RasterizerState)
+    && IsSameDescription(lhs.BlendState, rhs.BlendState)
+    && IsSameDescription(lhs.DepthStencilState, rhs.DepthStencilState);
+}
+
+inline bool operator==(const DescriptionKey& lhs, const DescriptionKey& rhs) {
+  return lhs.Hash == rhs.Hash && IsSameDescription(lhs.Value, rhs.Value);
+}
+
+}  // namespace PipelineState
+}  // namespace Rendering
+
+namespace std {
+
+template<>
+struct hash<Rendering::PipelineState::DescriptionKey> {
+  size_t operator()(const Rendering::PipelineState::DescriptionKey& key) const {
+    return key.Hash;
+  }
+};
+
+}  // std
+
+namespace Rendering {
+namespace PipelineState {
+
+Core::ResourceArray<Handle, PipelineStateData, 255> g_storage_;
+Core::HandleCache<DescriptionKey, Handle> g_cache_;
+
+void HashDescription(size_t& seed, const D3D11_RASTERIZER_DESC& description) {
+  hash_combine(seed, static_cast<uint32_t>(description.FillMode));
+  hash_combine(seed, static_cast<uint32_t>(description.CullMode));
+  hash_combine(seed, description.FrontCounterClockwise);
+  hash_combine(seed, description.DepthBias);
+  hash_combine(seed, description.DepthBiasClamp);
+  hash_combine(seed, description.SlopeScaledDepthBias);
+  hash_combine(seed, description.DepthClipEnable);
+  hash_combine(seed, description.ScissorEnable);
+  hash_combine(seed, description.MultisampleEnable);
+  hash_combine(seed, description.AntialiasedLineEnable);
+}
+
+void HashDescription(size_t& seed, const D3D11_BLEND_DESC& description) {
+  hash_combine(seed, description.AlphaToCoverageEnable);
+  hash_combine(seed, description.IndependentBlendEnable);
+  for (const auto& render_target : description.RenderTarget) {
+    hash_combine(seed, render_target.BlendEnable);
+    hash_combine(seed, static_cast<uint32_t>(render_target.SrcBlend));
+    hash_combine(seed, static_cast<uint32_t>(render_target.DestBlend));
+    hash_combine(seed, static_cast<uint32_t>(render_target.BlendOp));
+    hash_combine(seed, static_cast<uint32_t>(render_target.SrcBlendAlpha));
+    hash_combine(seed, static_cast<uint32_t>(render_target.DestBlendAlpha));
+    hash_combine(seed, static_cast<uint32_t>(render_target.BlendOpAlpha));
+    hash_combine(seed, static_cast<uint32_t>(render_target.RenderTargetWriteMask));
+  }
+}
+
+void HashDescription(size_t& seed, const D3D11_DEPTH_STENCILOP_DESC& description) {
+  hash_combine(seed, static_cast<uint32_t>(description.StencilFailOp));
+  hash_combine(seed, static_cast<uint32_t>(description.StencilDepthFailOp));
+  hash_combine(seed, static_cast<uint32_t>(description.StencilPassOp));
+  hash_combine(seed, static_cast<uint32_t>(description.StencilFunc));
+}
+
+void HashDescription(size_t& seed, const D3D11_DEPTH_STENCIL_DESC& description) {
+  hash_combine(seed, description.DepthEnable);
+  hash_combine(seed, static_cast<uint32_t>(description.DepthWriteMask));
+  hash_combine(seed, static_cast<uint32_t>(description.DepthFunc));
+  hash_combine(seed, description.StencilEnable);
+  hash_combine(seed, static_cast<uint32_t>(description.StencilReadMask));
+  hash_combine(seed, static_cast<uint32_t>(description.StencilWriteMask));
+  HashDescription(seed, description.FrontFace);
+  HashDescription(seed, description.BackFace);
+}
+
+size_t HashDescription(const Description& description) {
+  auto vertex_shader = description.VertexShader;
+  auto pixel_shader = description.PixelShader;
+  auto vertex_layout = description.VertexLayout;
+
+  size_t seed = 0;
+  hash_combine(seed, vertex_shader.CompactForm());
+  hash_combine(seed, pixel_shader.CompactForm());
+  hash_combine(seed, vertex_layout.CompactForm());
+  hash_combine(seed, static_cast<uint32_t>(description.PrimitiveTopology));
+  HashDescription(seed, description.RasterizerState);
+  HashDescription(seed, description.BlendState);
+  HashDescription(seed, description.DepthStencilState);
+  return seed;
+}
+
+Handle Create(const Description& description, ID3D11Device* device) {
+  DescriptionKey key;
+  key.Value = description;
+  key.Hash = HashDescription(description);
+
+  auto cached_handle = g_cache_.Get(key);
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  PipelineStateData data;
+  data.VertexShader = VertexShader::Retreive(description.VertexShader)->Shader;
+  data.PixelShader = PixelShader::Retreive(description.PixelShader)->Shader;
+  data.VertexLayout = VertexLayout::Retreive(description.VertexLayout);
+  data.PrimitiveTopology = description.PrimitiveTopology;
+
+  auto rasterizer_state_result = device->CreateRasterizerState(&description.RasterizerState, data.RasterizerState.GetAddressOf());
+  if (FAILED(rasterizer_state_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, rasterizer_state_result);
+    return {};
+  }
+
+  auto blend_state_result = device->CreateBlendState(&description.BlendState, data.BlendState.GetAddressOf());
+  if (FAILED(blend_state_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, blend_state_result);
+    return {};
+  }
+
+  auto depth_stencil_state_result = device->CreateDepthStencilState(&description.DepthStencilState, data.DepthStencilState.GetAddressOf());
+  if (FAILED(depth_stencil_state_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, depth_stencil_state_result);
+    return {};
+  }
+
+  auto new_handle = g_storage_.Add(std::move(data));
+  g_cache_.Set(key, new_handle);
+  return new_handle;
+}
+
+void Bind(Handle handle, ID3D11DeviceContext* context) {
+  const auto& data = g_storage_.Get(handle);
+
+  context->VSSetShader(data.VertexShader.Get(), nullptr, 0);
+  context->PSSetShader(data.PixelShader.Get(), nullptr, 0);
+  context->IASetInputLayout(data.VertexLayout.Get());
+  context->IASetPrimitiveTopology(data.PrimitiveTopology);
+  context->RSSetState(data.RasterizerState.Get());
+  context->OMSetBlendState(data.BlendState.Get(), nullptr, 0xFFFFFFFF);
+  context->OMSetDepthStencilState(data.DepthStencilState.Get(), 0);
+}
+
+}  // namespace PipelineState
+}  // namespace Rendering
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "core/handle.h"
+#include "rendering/vertex_shader.h"
+#include "rendering/pixel_shader.h"
+#include "rendering/vertex_layout.h"
+
+namespace Rendering {
+namespace PipelineState {
+
+struct PipelineStateTag {};
+
+using Handle = Core::Handle<8, 24, PipelineStateTag>;
+
+struct Description {
+  VertexShader::Handle VertexShader = {};
+  PixelShader::Handle PixelShader = {};
+  VertexLayout::Handle VertexLayout = {};
+  D3D11_PRIMITIVE_TOPOLOGY PrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+  D3D11_RASTERIZER_DESC RasterizerState = CD3D11_RASTERIZER_DESC(CD3D11_DEFAULT());
+  D3D11_BLEND_DESC BlendState = CD3D11_BLEND_DESC(CD3D11_DEFAULT());
+  D3D11_DEPTH_STENCIL_DESC DepthStencilState = CD3D11_DEPTH_STENCIL_DESC(CD3D11_DEFAULT());
+};
+
+// Identical descriptions share a single handle
+Handle Create(const Description& description, ID3D11Device* device);
+
+void Bind(Handle handle, ID3D11DeviceContext* context);
+
+}  // namespace PipelineState
+}  // namespace Rendering
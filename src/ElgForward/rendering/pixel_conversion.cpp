@@ -0,0 +1,64 @@
+#include "rendering/pixel_conversion.h"
+
+#include <intrin.h>
+#include <tmmintrin.h>
+
+namespace Rendering {
+namespace PixelConversion {
+
+bool HasSsse3() {
+  static const bool has_ssse3 = [] {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+  }();
+  return has_ssse3;
+}
+
+void ExpandRgbToRgbaScalar(uint8_t* data, size_t pixel_count) {
+  for (size_t i = pixel_count; i-- > 0;) {
+    auto source = data + i * 3;
+    auto destination = data + i * 4;
+    destination[3] = 255;
+    destination[2] = source[2];
+    destination[1] = source[1];
+    destination[0] = source[0];
+  }
+}
+
+// Works from the back so every group of four pixels is read before the wider output reaches it. A 16 byte load
+// from pixel 4 * i covers its 12 RGB bytes, the 4 bytes past them are either later source pixels or buffer tail,
+// and only land in the alpha lanes.
+void ExpandRgbToRgbaSsse3(uint8_t* data, size_t pixel_count) {
+  const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+  size_t group_count = pixel_count / 4;
+  size_t tail_begin = group_count * 4;
+
+  for (size_t i = pixel_count; i-- > tail_begin;) {
+    auto source = data + i * 3;
+    auto destination = data + i * 4;
+    destination[3] = 255;
+    destination[2] = source[2];
+    destination[1] = source[1];
+    destination[0] = source[0];
+  }
+
+  for (size_t i = group_count; i-- > 0;) {
+    auto rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 12));
+    auto rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 16), rgba);
+  }
+}
+
+void ExpandRgbToRgba(uint8_t* data, size_t pixel_count) {
+  if (HasSsse3()) {
+    ExpandRgbToRgbaSsse3(data, pixel_count);
+  } else {
+    ExpandRgbToRgbaScalar(data, pixel_count);
+  }
+}
+
+}  // namespace PixelConversion
+}  // namespace Rendering
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Rendering {
+namespace PixelConversion {
+
+// Expands tightly packed RGB pixels at the start of data to RGBA with opaque alpha, in place. The buffer has to hold
+// pixel_count * 4 bytes. Uses SSSE3 byte shuffles when the CPU has them.
+void ExpandRgbToRgba(uint8_t* data, size_t pixel_count);
+
+}  // namespace PixelConversion
+}  // namespace Rendering
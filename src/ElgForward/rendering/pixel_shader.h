@@ -9,6 +9,7 @@
 #include "core/filesystem.h"
 #include "core/handle.h"
 #include "rendering/shader_reflection.h"
+#include "rendering/shader_permutation.h"
 
 namespace Rendering {
 namespace PixelShader {
@@ -34,6 +35,8 @@ struct ShaderData {
 
 Handle Create(const filesystem::path& path, ID3D11Device* device);
 
+Handle Create(const ShaderPermutation::Permutation& permutation, const filesystem::path& cache_path, ID3D11Device* device);
+
 ShaderData* Retreive(Handle handle);
 
 }  // namespace PixelShader
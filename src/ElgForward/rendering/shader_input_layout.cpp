@@ -0,0 +1,79 @@
+#include "rendering/shader_input_layout.h"
+
+#include <algorithm>
+
+#include "rendering/dxgi_format_helper.h"
+
+namespace Rendering {
+namespace ShaderReflection {
+
+bool IsVertexBufferFormatCompatible(uint32_t component_count, D3D_REGISTER_COMPONENT_TYPE component_type, DXGI_FORMAT mesh_channel_format) {
+  auto components_and_format = DxgiFormatToComponentsAndType(mesh_channel_format);
+
+  if (components_and_format.second == D3D_REGISTER_COMPONENT_UNKNOWN) {
+    return false;
+  }
+
+  if (component_count != components_and_format.first || component_type != components_and_format.second) {
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<InputElementDescription> BuildInputElements(const std::vector<InputDescription>& inputs) {
+  std::vector<InputElementDescription> elements(inputs.size());
+  for (uint32_t i = 0; i < elements.size(); ++i) {
+    elements[i].InputIndex = i;
+    elements[i].InputSlot = i;
+  }
+  return elements;
+}
+
+bool BuildInputLayout(const ReflectionData& data, const std::vector<VertexDataChannel>& mesh_channels,
+                      const std::vector<DXGI_FORMAT>& mesh_formats, std::vector<D3D11_INPUT_ELEMENT_DESC>* input_layout,
+                      std::vector<uint32_t>* mesh_buffer_indices) {
+  input_layout->clear();
+  mesh_buffer_indices->clear();
+
+  for (const auto& element : data.InputElements) {
+    if (element.InputIndex >= data.Inputs.size()) {
+      return false;
+    }
+
+    const auto& input_desc = data.Inputs[element.InputIndex];
+
+    auto channel_it = std::find(std::begin(mesh_channels), std::end(mesh_channels), input_desc.Channel);
+    if (channel_it == std::end(mesh_channels)) {
+      return false;
+    }
+
+    auto mesh_buffer_index = static_cast<uint32_t>(std::distance(std::begin(mesh_channels), channel_it));
+    if (mesh_buffer_index >= mesh_formats.size()) {
+      return false;
+    }
+
+    bool is_compatible = IsVertexBufferFormatCompatible(input_desc.ComponentCount, input_desc.ComponentType, mesh_formats[mesh_buffer_index]);
+    if (!is_compatible) {
+      return false;
+    }
+
+    mesh_buffer_indices->emplace_back(mesh_buffer_index);
+
+    input_layout->emplace_back();
+    auto& input_layout_desc_entry = input_layout->back();
+
+    input_layout_desc_entry.SemanticName = input_desc.SemanticName.c_str();
+    input_layout_desc_entry.SemanticIndex = input_desc.SemanticIndex;
+    input_layout_desc_entry.Format = mesh_formats[mesh_buffer_index];
+    input_layout_desc_entry.InputSlot = element.InputSlot;
+    input_layout_desc_entry.AlignedByteOffset = element.AlignedByteOffset;
+    input_layout_desc_entry.InputSlotClass = element.InputSlotClass;
+    input_layout_desc_entry.InstanceDataStepRate = element.InstanceDataStepRate;
+  }
+
+  return true;
+}
+
+}  // namespace ShaderReflection
+}  // namespace Rendering
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+#include <d3d11.h>
+
+#include "rendering/shader_reflection.h"
+#include "rendering/vertex_data.h"
+
+namespace Rendering {
+namespace ShaderReflection {
+
+// One element per reflected input, each reading from its own vertex buffer slot
+std::vector<InputElementDescription> BuildInputElements(const std::vector<InputDescription>& inputs);
+
+// Fills the layout from the stored input elements and the mesh formats. Fails when the mesh lacks a channel or stores
+// it in a format the shader can't read. Buffer indices name the mesh vertex buffer bound to each slot. The semantic
+// names point into the reflection data, which has to outlive the layout description.
+bool BuildInputLayout(const ReflectionData& data, const std::vector<VertexDataChannel>& mesh_channels,
+                      const std::vector<DXGI_FORMAT>& mesh_formats, std::vector<D3D11_INPUT_ELEMENT_DESC>* input_layout,
+                      std::vector<uint32_t>* mesh_buffer_indices);
+
+}  // namespace ShaderReflection
+}  // namespace Rendering
@@ -0,0 +1,213 @@
+#include "rendering/shader_permutation.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <d3d11.h>
+#include <D3Dcompiler.h>
+#include <wrl.h>
+
+#include <dxfw/dxfw.h>
+
+namespace Rendering {
+namespace ShaderPermutation {
+
+#ifdef _DEBUG
+const UINT CompileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+const UINT CompileFlags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+
+struct HashedFile {
+  filesystem::file_time_type LastWriteTime = {};
+  uintmax_t Size = 0;
+  uint64_t Hash = 0;
+};
+
+struct ListedDirectory {
+  filesystem::file_time_type LastWriteTime = {};
+  std::vector<filesystem::path> Headers = {};
+};
+
+// Every material creates its shaders through a permutation, so the source and header hashes and the header lists are
+// kept until the files change instead of being read again for each key
+std::mutex g_hashed_files_mutex_;
+std::unordered_map<filesystem::path, HashedFile> g_hashed_files_;
+std::unordered_map<filesystem::path, ListedDirectory> g_listed_directories_;
+
+// The keys name files in the shader cache, so they are hashed with FNV-1a instead of std::hash to stay the same
+// across runs, builds and standard libraries
+constexpr static const uint64_t KeyHashSeed = 0xcbf29ce484222325;
+
+void HashBytes(const void* data, size_t size, uint64_t* hash) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    *hash ^= bytes[i];
+    *hash *= 0x100000001b3;
+  }
+}
+
+void HashValue(uint64_t value, uint64_t* hash) {
+  HashBytes(&value, sizeof(value), hash);
+}
+
+// The length goes first so consecutive strings can't run into each other
+void HashString(const std::string& value, uint64_t* hash) {
+  HashValue(value.size(), hash);
+  HashBytes(value.data(), value.size(), hash);
+}
+
+bool GetFileHash(const filesystem::path& path, uint64_t* hash) {
+  std::error_code error;
+  auto last_write_time = filesystem::last_write_time(path, error);
+  if (error) {
+    return false;
+  }
+
+  auto size = filesystem::file_size(path, error);
+  if (error) {
+    return false;
+  }
+
+  auto& hashed_file = g_hashed_files_[path];
+  if (hashed_file.LastWriteTime != last_write_time || hashed_file.Size != size) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      g_hashed_files_.erase(path);
+      return false;
+    }
+
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    hashed_file.LastWriteTime = last_write_time;
+    hashed_file.Size = size;
+    hashed_file.Hash = KeyHashSeed;
+    HashBytes(contents.data(), contents.size(), &hashed_file.Hash);
+  }
+
+  *hash = hashed_file.Hash;
+  return true;
+}
+
+// Adding, removing or renaming a file updates the write time of its directory
+const std::vector<filesystem::path>& GetHeaders(const filesystem::path& directory) {
+  std::error_code error;
+  auto last_write_time = filesystem::last_write_time(directory, error);
+
+  auto& listed_directory = g_listed_directories_[directory];
+  if (error || listed_directory.LastWriteTime != last_write_time || listed_directory.Headers.empty()) {
+    listed_directory.LastWriteTime = last_write_time;
+    listed_directory.Headers.clear();
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+      if (entry.path().extension() == ".h") {
+        listed_directory.Headers.push_back(entry.path());
+      }
+    }
+    std::sort(std::begin(listed_directory.Headers), std::end(listed_directory.Headers));
+  }
+
+  return listed_directory.Headers;
+}
+
+bool GetKey(const Permutation& permutation, size_t* key) {
+  std::lock_guard<std::mutex> lock(g_hashed_files_mutex_);
+
+  uint64_t seed = KeyHashSeed;
+
+  uint64_t source_hash;
+  if (!GetFileHash(permutation.SourcePath, &source_hash)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error reading shader source %S", permutation.SourcePath.string().c_str());
+    return false;
+  }
+  HashValue(source_hash, &seed);
+
+  // Includes are not tracked individually - any header next to the source invalidates the key
+  for (const auto& header : GetHeaders(permutation.SourcePath.parent_path())) {
+    uint64_t header_hash;
+    if (!GetFileHash(header, &header_hash)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error reading shader header %S", header.string().c_str());
+      return false;
+    }
+    HashValue(header_hash, &seed);
+  }
+
+  for (const auto& define : permutation.Defines) {
+    HashString(define.first, &seed);
+    HashString(define.second, &seed);
+  }
+
+  HashString(permutation.EntryPoint, &seed);
+  HashString(permutation.Target, &seed);
+  HashValue(CompileFlags, &seed);
+
+  *key = static_cast<size_t>(seed);
+  return true;
+}
+
+filesystem::path GetCachedFilePath(size_t key, const filesystem::path& cache_path) {
+  std::stringstream filename;
+  filename << std::hex << std::setw(sizeof(size_t) * 2) << std::setfill('0') << key << ".cso";
+  return cache_path / filename.str();
+}
+
+Microsoft::WRL::ComPtr<ID3DBlob> Compile(const Permutation& permutation) {
+  std::vector<D3D_SHADER_MACRO> macros;
+  for (const auto& define : permutation.Defines) {
+    macros.push_back({ define.first.c_str(), define.second.c_str() });
+  }
+  macros.push_back({ nullptr, nullptr });
+
+  Microsoft::WRL::ComPtr<ID3DBlob> bytecode;
+  Microsoft::WRL::ComPtr<ID3DBlob> errors;
+  HRESULT compile_result = D3DCompileFromFile(permutation.SourcePath.c_str(), &macros[0], D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                                              permutation.EntryPoint.c_str(), permutation.Target.c_str(), CompileFlags, 0,
+                                              bytecode.GetAddressOf(), errors.GetAddressOf());
+
+  if (FAILED(compile_result)) {
+    if (errors != nullptr) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error compiling shader %S: %S", permutation.SourcePath.string().c_str(),
+                 static_cast<const char*>(errors->GetBufferPointer()));
+    } else {
+      DXFW_DIRECTX_TRACE(__FILE__, __LINE__, false, compile_result);
+    }
+    return nullptr;
+  }
+
+  return bytecode;
+}
+
+Microsoft::WRL::ComPtr<ID3DBlob> Load(const Permutation& permutation, size_t key, const filesystem::path& cache_path) {
+  auto cached_file_path = GetCachedFilePath(key, cache_path);
+
+  Microsoft::WRL::ComPtr<ID3DBlob> bytecode;
+  if (filesystem::exists(cached_file_path)) {
+    HRESULT load_result = D3DReadFileToBlob(cached_file_path.c_str(), bytecode.GetAddressOf());
+    if (SUCCEEDED(load_result)) {
+      return bytecode;
+    }
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, false, load_result);
+  }
+
+  bytecode = Compile(permutation);
+  if (bytecode == nullptr) {
+    return nullptr;
+  }
+
+  // A failed cache write only costs a recompile next time
+  std::error_code error;
+  filesystem::create_directories(cache_path, error);
+  HRESULT write_result = D3DWriteBlobToFile(bytecode.Get(), cached_file_path.c_str(), TRUE);
+  if (FAILED(write_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, false, write_result);
+  }
+
+  return bytecode;
+}
+
+}  // namespace ShaderPermutation
+}  // namespace Rendering
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <d3d11.h>
+#include <wrl.h>
+
+#include "core/filesystem.h"
+
+namespace Rendering {
+namespace ShaderPermutation {
+
+struct Permutation {
+  filesystem::path SourcePath = {};
+  std::string EntryPoint = "main";
+  std::string Target = "";
+  std::map<std::string, std::string> Defines = {};
+};
+
+// Content based key - covers the source, the headers next to it, the defines, entry point, target and compile flags.
+// File hashes are kept by path and write time, so only files changed since the last key are read again.
+bool GetKey(const Permutation& permutation, size_t* key);
+
+filesystem::path GetCachedFilePath(size_t key, const filesystem::path& cache_path);
+
+// Returns the cached bytecode for the key or compiles the permutation and stores it in the cache directory
+Microsoft::WRL::ComPtr<ID3DBlob> Load(const Permutation& permutation, size_t key, const filesystem::path& cache_path);
+
+}  // namespace ShaderPermutation
+}  // namespace Rendering
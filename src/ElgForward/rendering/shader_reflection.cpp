@@ -8,6 +8,8 @@
 
 #include <sstream>
 
+#include "rendering/shader_input_layout.h"
+
 namespace Rendering {
 namespace ShaderReflection {
 
@@ -69,25 +71,8 @@ bool MapSemanticsToChannel(const char* semantic_name, uint32_t index, const std:
   return false;
 }
 
-bool ReflectInputs(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ReflectionData* output) {
-  if (output == nullptr) {
-    return false;
-  }
-
-  Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
-  HRESULT reflector_creation_result = D3DReflect(blob->GetBufferPointer(), blob->GetBufferSize(), IID_ID3D11ShaderReflection, (void**)reflector.GetAddressOf());
-  if (FAILED(reflector_creation_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, reflector_creation_result);
-    return {};
-  }
-
-  D3D11_SHADER_DESC shader_desc;
-  HRESULT get_desc_result = reflector->GetDesc(&shader_desc);
-  if (FAILED(get_desc_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, get_desc_result);
-    return false;
-  }
-
+bool ReflectInputs(ID3D11ShaderReflection* reflector, const D3D11_SHADER_DESC& shader_desc,
+                   const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ReflectionData* output) {
   D3D11_SIGNATURE_PARAMETER_DESC param_desc;
   for (uint32_t i = 0; i < shader_desc.InputParameters; ++i) {
     reflector->GetInputParameterDesc(i, &param_desc);
@@ -99,7 +84,6 @@ bool ReflectInputs(ID3DBlob* blob, const std::unordered_map<std::string, VertexD
       return false;
     }
 
-    
     output->Inputs.emplace_back(param_desc.SemanticName, param_desc.SemanticIndex, channel, component_count, param_desc.ComponentType);
   }
   
@@ -135,27 +119,9 @@ uint32_t UFlagsToChannels(UINT flags) {
   return 1 + ((flags >> 2) & 0x3);
 }
 
-bool ReflectTextures(ID3DBlob* blob, ReflectionData* output) {
-  if (output == nullptr) {
-    return false;
-  }
-
-  Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
-  HRESULT reflector_creation_result = D3DReflect(blob->GetBufferPointer(), blob->GetBufferSize(), IID_ID3D11ShaderReflection, (void**)reflector.GetAddressOf());
-  if (FAILED(reflector_creation_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, reflector_creation_result);
-    return{};
-  }
-
-  D3D11_SHADER_DESC shader_desc;
-  HRESULT get_desc_result = reflector->GetDesc(&shader_desc);
-  if (FAILED(get_desc_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, get_desc_result);
-    return false;
-  }
-
+bool ReflectTextures(ID3D11ShaderReflection* reflector, const D3D11_SHADER_DESC& shader_desc, ReflectionData* output) {
   D3D11_SHADER_INPUT_BIND_DESC bind_desc;
-  for (uint32_t i = 0; i < shader_desc.ConstantBuffers; ++i) {
+  for (uint32_t i = 0; i < shader_desc.BoundResources; ++i) {
     reflector->GetResourceBindingDesc(i, &bind_desc);
 
     if (bind_desc.Type == D3D_SIT_TEXTURE) {
@@ -177,5 +143,55 @@ bool ReflectTextures(ID3DBlob* blob, ReflectionData* output) {
   return true;
 }
 
+bool CreateReflector(ID3DBlob* blob, Microsoft::WRL::ComPtr<ID3D11ShaderReflection>* reflector, D3D11_SHADER_DESC* shader_desc) {
+  HRESULT reflector_creation_result = D3DReflect(blob->GetBufferPointer(), blob->GetBufferSize(), IID_ID3D11ShaderReflection, (void**)reflector->GetAddressOf());
+  if (FAILED(reflector_creation_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, reflector_creation_result);
+    return false;
+  }
+
+  HRESULT get_desc_result = (*reflector)->GetDesc(shader_desc);
+  if (FAILED(get_desc_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, get_desc_result);
+    return false;
+  }
+
+  return true;
+}
+
+bool ReflectVertexShader(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ReflectionData* output) {
+  if (output == nullptr) {
+    return false;
+  }
+
+  Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
+  D3D11_SHADER_DESC shader_desc;
+  if (!CreateReflector(blob, &reflector, &shader_desc)) {
+    return false;
+  }
+
+  if (!ReflectInputs(reflector.Get(), shader_desc, custom_channel_map, output)) {
+    return false;
+  }
+
+  output->InputElements = BuildInputElements(output->Inputs);
+
+  return ReflectTextures(reflector.Get(), shader_desc, output);
+}
+
+bool ReflectPixelShader(ID3DBlob* blob, ReflectionData* output) {
+  if (output == nullptr) {
+    return false;
+  }
+
+  Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
+  D3D11_SHADER_DESC shader_desc;
+  if (!CreateReflector(blob, &reflector, &shader_desc)) {
+    return false;
+  }
+
+  return ReflectTextures(reflector.Get(), shader_desc, output);
+}
+
 }  // namespace ShaderReflection
 }  // namespace Rendering
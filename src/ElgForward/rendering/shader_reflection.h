@@ -45,6 +45,16 @@ struct TexureDescription {
   uint32_t BindSlotCount;
 };
 
+// Shader side of one input layout element, the format comes from the mesh channel bound to the slot. Derived from
+// the inputs once and stored in the reflection sidecar, so layouts can be built without reflecting the bytecode.
+struct InputElementDescription {
+  uint32_t InputIndex = 0;  // Into ReflectionData::Inputs, names the semantic and the mesh channel
+  uint32_t InputSlot = 0;
+  uint32_t AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+  D3D11_INPUT_CLASSIFICATION InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+  uint32_t InstanceDataStepRate = 0;
+};
+
 struct ReflectionData {
   ReflectionData() = default;
   ~ReflectionData() = default;
@@ -56,12 +66,14 @@ struct ReflectionData {
   ReflectionData& operator=(ReflectionData&&) = default;
 
   std::vector<InputDescription> Inputs = {};
+  std::vector<InputElementDescription> InputElements = {};
   std::vector<TexureDescription> Texures = {};
 };
 
-bool ReflectInputs(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ReflectionData* output);
+// Both use a single D3DReflect pass over the bytecode
+bool ReflectVertexShader(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ReflectionData* output);
 
-bool ReflectTextures(ID3DBlob* blob, ReflectionData* output);
+bool ReflectPixelShader(ID3DBlob* blob, ReflectionData* output);
 
 }  // namespace ShaderReflection
 }  // namespace Rendering
@@ -0,0 +1,273 @@
+#include "rendering/shader_reflection_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/hash.h"
+
+namespace Rendering {
+namespace ShaderReflection {
+
+const uint32_t CacheMagic = 0x52474C45;  // "ELGR"
+const uint32_t CacheVersion = 2;
+
+size_t GetCacheKey(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map) {
+  size_t seed = std::hash<std::string_view>()(std::string_view(static_cast<const char*>(blob->GetBufferPointer()), blob->GetBufferSize()));
+
+  // The map is unordered so its entries are combined in an order independent way
+  size_t channel_map_hash = 0;
+  for (const auto& entry : custom_channel_map) {
+    size_t entry_hash = 0;
+    hash_combine(entry_hash, entry.first);
+    hash_combine(entry_hash, static_cast<VertexDataChannelsType>(entry.second));
+    channel_map_hash ^= entry_hash;
+  }
+  hash_combine(seed, channel_map_hash);
+
+  return seed;
+}
+
+filesystem::path GetCachePath(const filesystem::path& bytecode_path) {
+  auto path = bytecode_path;
+  path.replace_extension(".reflection");
+  return path;
+}
+
+template<typename T>
+void Write(std::ofstream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void Write(std::ofstream& stream, const std::string& value) {
+  Write(stream, static_cast<uint32_t>(value.size()));
+  stream.write(value.data(), value.size());
+}
+
+// Sidecars are read into memory whole, every length and count is checked against the bytes left before it's used
+class CacheReader {
+public:
+  CacheReader(const std::vector<char>& data) : m_data_(data) {
+  }
+
+  size_t GetRemaining() const {
+    return m_data_.size() - m_offset_;
+  }
+
+  template<typename T>
+  bool Read(T* value) {
+    if (GetRemaining() < sizeof(T)) {
+      return false;
+    }
+
+    std::memcpy(value, m_data_.data() + m_offset_, sizeof(T));
+    m_offset_ += sizeof(T);
+    return true;
+  }
+
+  bool Read(std::string* value) {
+    uint32_t size;
+    if (!Read(&size) || size > GetRemaining()) {
+      return false;
+    }
+
+    value->assign(m_data_.data() + m_offset_, size);
+    m_offset_ += size;
+    return true;
+  }
+
+  // Enums are read as their underlying integer and only cast once the value is known to be in range
+  template<typename T>
+  bool ReadEnum(T first, T last, T* value) {
+    std::underlying_type_t<T> raw_value;
+    if (!Read(&raw_value)) {
+      return false;
+    }
+
+    if (raw_value < static_cast<std::underlying_type_t<T>>(first) || raw_value > static_cast<std::underlying_type_t<T>>(last)) {
+      return false;
+    }
+
+    *value = static_cast<T>(raw_value);
+    return true;
+  }
+
+  // Each element takes at least min_element_size bytes, so a count the rest of the file can't hold is rejected early
+  bool ReadCount(size_t min_element_size, uint32_t* count) {
+    return Read(count) && *count <= GetRemaining() / min_element_size;
+  }
+
+private:
+  const std::vector<char>& m_data_;
+  size_t m_offset_ = 0;
+};
+
+bool ReadChannel(CacheReader* reader, VertexDataChannel* channel) {
+  VertexDataChannelsType value;
+  if (!reader->Read(&value)) {
+    return false;
+  }
+
+  // A single known channel, masks of several don't name an input
+  if (value == 0 || (value & (value - 1)) != 0 || value > static_cast<VertexDataChannelsType>(VertexDataChannel::COLORS7)) {
+    return false;
+  }
+
+  *channel = static_cast<VertexDataChannel>(value);
+  return true;
+}
+
+bool ReadCache(const filesystem::path& path, size_t key, ReflectionData* output) {
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    return false;
+  }
+
+  std::vector<char> file_data(static_cast<size_t>(stream.tellg()));
+  stream.seekg(0);
+  if (!stream.read(file_data.data(), static_cast<std::streamsize>(file_data.size()))) {
+    return false;
+  }
+
+  CacheReader reader(file_data);
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t stored_key;
+  if (!reader.Read(&magic) || !reader.Read(&version) || !reader.Read(&stored_key)) {
+    return false;
+  }
+
+  if (magic != CacheMagic || version != CacheVersion || stored_key != key) {
+    return false;
+  }
+
+  ReflectionData data;
+
+  const size_t MinInputSize = sizeof(uint32_t) * 2 + sizeof(VertexDataChannel) + sizeof(uint32_t) + sizeof(D3D_REGISTER_COMPONENT_TYPE);
+  uint32_t input_count;
+  if (!reader.ReadCount(MinInputSize, &input_count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < input_count; ++i) {
+    std::string semantic_name;
+    uint32_t semantic_index;
+    VertexDataChannel channel;
+    uint32_t component_count;
+    D3D_REGISTER_COMPONENT_TYPE component_type;
+    bool input_ok = reader.Read(&semantic_name) && reader.Read(&semantic_index) && ReadChannel(&reader, &channel)
+                 && reader.Read(&component_count)
+                 && reader.ReadEnum(D3D_REGISTER_COMPONENT_UINT32, D3D_REGISTER_COMPONENT_FLOAT32, &component_type);
+    if (!input_ok || component_count < 1 || component_count > 4) {
+      return false;
+    }
+
+    data.Inputs.emplace_back(semantic_name.c_str(), semantic_index, channel, component_count, component_type);
+  }
+
+  const size_t MinInputElementSize = sizeof(uint32_t) * 3 + sizeof(D3D11_INPUT_CLASSIFICATION) + sizeof(uint32_t);
+  uint32_t input_element_count;
+  if (!reader.ReadCount(MinInputElementSize, &input_element_count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < input_element_count; ++i) {
+    InputElementDescription element;
+    bool element_ok = reader.Read(&element.InputIndex) && reader.Read(&element.InputSlot) && reader.Read(&element.AlignedByteOffset)
+                   && reader.ReadEnum(D3D11_INPUT_PER_VERTEX_DATA, D3D11_INPUT_PER_INSTANCE_DATA, &element.InputSlotClass)
+                   && reader.Read(&element.InstanceDataStepRate);
+    if (!element_ok) {
+      return false;
+    }
+
+    if (element.InputIndex >= data.Inputs.size() || element.InputSlot >= D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT) {
+      return false;
+    }
+
+    data.InputElements.emplace_back(element);
+  }
+
+  const size_t MinTextureSize = sizeof(uint32_t) + sizeof(Texture::Type) + sizeof(uint32_t) * 4;
+  uint32_t texture_count;
+  if (!reader.ReadCount(MinTextureSize, &texture_count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < texture_count; ++i) {
+    std::string name;
+    Texture::Type type;
+    uint32_t samples;
+    uint32_t channels;
+    uint32_t bind_slot_start;
+    uint32_t bind_slot_count;
+    bool texture_ok = reader.Read(&name) && reader.ReadEnum(Texture::Type::DIM_1, Texture::Type::CUBE_ARRAY, &type) && reader.Read(&samples)
+                   && reader.Read(&channels) && reader.Read(&bind_slot_start) && reader.Read(&bind_slot_count);
+    if (!texture_ok) {
+      return false;
+    }
+
+    bool is_texture_valid = channels >= 1 && channels <= 4
+                         && bind_slot_start < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT
+                         && bind_slot_count <= D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT - bind_slot_start;
+    if (!is_texture_valid) {
+      return false;
+    }
+
+    data.Texures.emplace_back(name.c_str(), type, samples, channels, bind_slot_start, bind_slot_count);
+  }
+
+  // Trailing bytes mean the sidecar wasn't written by this version
+  if (reader.GetRemaining() != 0) {
+    return false;
+  }
+
+  *output = std::move(data);
+  return true;
+}
+
+bool WriteCache(const filesystem::path& path, size_t key, const ReflectionData& data) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    return false;
+  }
+
+  Write(stream, CacheMagic);
+  Write(stream, CacheVersion);
+  Write(stream, static_cast<uint64_t>(key));
+
+  Write(stream, static_cast<uint32_t>(data.Inputs.size()));
+  for (const auto& input : data.Inputs) {
+    Write(stream, input.SemanticName);
+    Write(stream, input.SemanticIndex);
+    Write(stream, input.Channel);
+    Write(stream, input.ComponentCount);
+    Write(stream, input.ComponentType);
+  }
+
+  Write(stream, static_cast<uint32_t>(data.InputElements.size()));
+  for (const auto& element : data.InputElements) {
+    Write(stream, element.InputIndex);
+    Write(stream, element.InputSlot);
+    Write(stream, element.AlignedByteOffset);
+    Write(stream, element.InputSlotClass);
+    Write(stream, element.InstanceDataStepRate);
+  }
+
+  Write(stream, static_cast<uint32_t>(data.Texures.size()));
+  for (const auto& texture : data.Texures) {
+    Write(stream, texture.Name);
+    Write(stream, texture.Type);
+    Write(stream, texture.Samples);
+    Write(stream, texture.Channels);
+    Write(stream, texture.BindSlotStart);
+    Write(stream, texture.BindSlotCount);
+  }
+
+  return static_cast<bool>(stream);
+}
+
+}  // namespace ShaderReflection
+}  // namespace Rendering
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <d3d11.h>
+
+#include "core/filesystem.h"
+#include "rendering/shader_reflection.h"
+
+namespace Rendering {
+namespace ShaderReflection {
+
+// Key of the reflection sidecar - covers the bytecode and the custom channel map used to reflect the inputs
+size_t GetCacheKey(ID3DBlob* blob, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map);
+
+filesystem::path GetCachePath(const filesystem::path& bytecode_path);
+
+// Fails when the sidecar is missing, malformed or was written for a different key
+bool ReadCache(const filesystem::path& path, size_t key, ReflectionData* output);
+
+bool WriteCache(const filesystem::path& path, size_t key, const ReflectionData& data);
+
+}  // namespace ShaderReflection
+}  // namespace Rendering
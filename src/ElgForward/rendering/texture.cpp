@@ -1,5 +1,7 @@
 #include "texture.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 #include <d3d11.h>
@@ -10,10 +12,14 @@
 #include "core/hash.h"
 #include "core/resource_array.h"
 #include "core/handle_cache.h"
+#include "rendering/binding_set.h"
+#include "rendering/block_compression.h"
 
 namespace Rendering {
 namespace Texture {
 
+const uint32_t NoResidentLevel = static_cast<uint32_t>(-1);
+
 class Storage {
  public:
   Storage(DXGI_FORMAT format, uint32_t samples, Type type, size_t slot_count)
@@ -47,6 +53,22 @@ class Storage {
     return m_slot_count_;
   }
 
+  uint32_t GetMostDetailedLevel() const {
+    return m_most_detailed_level_;
+  }
+
+  void SetMostDetailedLevel(uint32_t level) {
+    m_most_detailed_level_ = level;
+  }
+
+  size_t GetResidentBytes() const {
+    return m_resident_bytes_;
+  }
+
+  void SetResidentBytes(size_t bytes) {
+    m_resident_bytes_ = bytes;
+  }
+
   const Microsoft::WRL::ComPtr<ID3D11Texture2D>& GetTexture() const {
     return m_texture_;
   }
@@ -68,55 +90,59 @@ class Storage {
   uint32_t m_samples_ = static_cast<uint32_t>(-1);
   Type m_type_ = Type::UNKNOWN;
   size_t m_slot_count_ = 1;
+  uint32_t m_most_detailed_level_ = NoResidentLevel;  // Only used by streamed textures
+  size_t m_resident_bytes_ = 0;
   Microsoft::WRL::ComPtr<ID3D11Texture2D> m_texture_ = nullptr;
   Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_view_ = nullptr;
 };
 
 Core::ResourceArray<Handle, Storage, 255> g_storage_;
 Core::HandleCache<size_t, Handle> g_cache_;
+size_t g_total_resident_bytes_ = 0;
 
-Handle Create(size_t name_hash, const std::vector<ImageData>& data, ID3D11Device* device) {
+UINT GetRowPitch(const ImageData& image) {
+  if (BlockCompression::IsBlockCompressed(image.Format)) {
+    return static_cast<UINT>(BlockCompression::GetRowPitch(image.Format, image.Width));
+  }
+  return image.Components * image.Width;
+}
+
+UINT GetSlicePitch(const ImageData& image) {
+  if (BlockCompression::IsBlockCompressed(image.Format)) {
+    return static_cast<UINT>(BlockCompression::GetEncodedSize(image.Format, image.Width, image.Height));
+  }
+  return image.Components * image.Width * image.Height;
+}
+
+Handle Create(size_t name_hash, Type type, DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mip_levels,
+              uint32_t array_size, const std::vector<D3D11_SUBRESOURCE_DATA>& subresources, ID3D11Device* device) {
   auto cached_handle = g_cache_.Get(name_hash);
 
   if (cached_handle.IsValid()) {
     return cached_handle;
   }
 
-  if (data.size() == 0) {
+  bool is_cube = (type == Type::CUBE || type == Type::CUBE_ARRAY);
+  bool is_supported_type = (type == Type::DIM_2 || type == Type::DIM_2_ARRAY || is_cube);
+  if (!is_supported_type || (is_cube && array_size % 6 != 0) || subresources.size() != static_cast<size_t>(mip_levels) * array_size) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Invalid texture description", nullptr);
     return {};
   }
 
-  std::vector<D3D11_SUBRESOURCE_DATA> initial_data = {};
-  uint32_t width = 0;
-  uint32_t height = 0;
-  DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
-
-  for (const auto& single_image_data : data) {
-    initial_data.emplace_back(D3D11_SUBRESOURCE_DATA {
-      single_image_data.Data,
-      single_image_data.Components * single_image_data.Width,
-      single_image_data.Components * single_image_data.Width * single_image_data.Height
-    });
-
-    width = std::max(width, single_image_data.Width);
-    height = std::max(height, single_image_data.Height);
-    format = single_image_data.Format;
-  }
-
   D3D11_TEXTURE2D_DESC desc = {};
   desc.Width = width;
   desc.Height = height;
-  desc.MipLevels = static_cast<UINT>(initial_data.size());
-  desc.ArraySize = 1;
+  desc.MipLevels = mip_levels;
+  desc.ArraySize = array_size;
   desc.Format = format;
   desc.SampleDesc.Count = 1;
   desc.Usage = D3D11_USAGE_IMMUTABLE;
   desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
   desc.CPUAccessFlags = 0;
-  desc.MiscFlags = 0;
+  desc.MiscFlags = is_cube ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
 
-  Storage new_storage(format, static_cast<uint32_t>(-1), Type::DIM_2, 1);
-  auto texture_result = device->CreateTexture2D(&desc, &initial_data[0], new_storage.GetTexture().GetAddressOf());
+  Storage new_storage(format, static_cast<uint32_t>(-1), type, 1);
+  auto texture_result = device->CreateTexture2D(&desc, &subresources[0], new_storage.GetTexture().GetAddressOf());
   if (FAILED(texture_result)) {
     DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, texture_result);
     return {};
@@ -124,9 +150,32 @@ Handle Create(size_t name_hash, const std::vector<ImageData>& data, ID3D11Device
 
   D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc = {};
   srv_desc.Format = format;
-  srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-  srv_desc.Texture2D.MipLevels = desc.MipLevels;
-  srv_desc.Texture2D.MostDetailedMip = 0;
+  switch (type) {
+    case Type::DIM_2_ARRAY:
+      srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+      srv_desc.Texture2DArray.MipLevels = desc.MipLevels;
+      srv_desc.Texture2DArray.MostDetailedMip = 0;
+      srv_desc.Texture2DArray.FirstArraySlice = 0;
+      srv_desc.Texture2DArray.ArraySize = desc.ArraySize;
+      break;
+    case Type::CUBE:
+      srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+      srv_desc.TextureCube.MipLevels = desc.MipLevels;
+      srv_desc.TextureCube.MostDetailedMip = 0;
+      break;
+    case Type::CUBE_ARRAY:
+      srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+      srv_desc.TextureCubeArray.MipLevels = desc.MipLevels;
+      srv_desc.TextureCubeArray.MostDetailedMip = 0;
+      srv_desc.TextureCubeArray.First2DArrayFace = 0;
+      srv_desc.TextureCubeArray.NumCubes = desc.ArraySize / 6;
+      break;
+    default:
+      srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+      srv_desc.Texture2D.MipLevels = desc.MipLevels;
+      srv_desc.Texture2D.MostDetailedMip = 0;
+      break;
+  }
 
   auto view_result = device->CreateShaderResourceView(new_storage.GetTexture().Get(), &srv_desc,
                                                       new_storage.GetView().GetAddressOf());
@@ -135,9 +184,65 @@ Handle Create(size_t name_hash, const std::vector<ImageData>& data, ID3D11Device
     return {};
   }
 
+  size_t resident_bytes = 0;
+  for (const auto& subresource : subresources) {
+    resident_bytes += subresource.SysMemSlicePitch;
+  }
+  new_storage.SetResidentBytes(resident_bytes);
+  g_total_resident_bytes_ += resident_bytes;
+
   auto new_handle = g_storage_.Add(std::move(new_storage));
   g_cache_.Set(name_hash, new_handle);
   return new_handle;
+}
+
+Handle CreateFromSlices(size_t name_hash, const std::vector<std::vector<ImageData>>& slices, Type type, ID3D11Device* device) {
+  auto cached_handle = g_cache_.Get(name_hash);
+
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  if (slices.size() == 0 || slices[0].size() == 0) {
+    return {};
+  }
+
+  std::vector<D3D11_SUBRESOURCE_DATA> initial_data = {};
+  uint32_t width = 0;
+  uint32_t height = 0;
+  DXGI_FORMAT format = slices[0][0].Format;
+  auto mip_levels = slices[0].size();
+
+  // Subresources are ordered by slice first, then by mip level
+  for (const auto& slice : slices) {
+    if (slice.size() != mip_levels || slice[0].Width != slices[0][0].Width || slice[0].Height != slices[0][0].Height) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Texture array slices differ in size or mip count", nullptr);
+      return {};
+    }
+
+    for (const auto& single_image_data : slice) {
+      if (single_image_data.Format != format) {
+        DXFW_TRACE(__FILE__, __LINE__, false, "Texture array slices differ in format", nullptr);
+        return {};
+      }
+
+      initial_data.emplace_back(D3D11_SUBRESOURCE_DATA {
+        single_image_data.Data,
+        GetRowPitch(single_image_data),
+        GetSlicePitch(single_image_data)
+      });
+
+      width = std::max(width, single_image_data.Width);
+      height = std::max(height, single_image_data.Height);
+    }
+  }
+
+  return Create(name_hash, type, format, width, height, static_cast<uint32_t>(mip_levels), static_cast<uint32_t>(slices.size()),
+                initial_data, device);
+}
+
+Handle Create(size_t name_hash, const std::vector<ImageData>& data, ID3D11Device* device) {
+  return CreateFromSlices(name_hash, { data }, Type::DIM_2, device);
 };
 
 Handle Create(const std::string& name, const std::vector<ImageData>& data, ID3D11Device* device) {
@@ -145,6 +250,249 @@ Handle Create(const std::string& name, const std::vector<ImageData>& data, ID3D1
   return Create(hasher(name), data, device);
 }
 
+Handle CreateArray(size_t name_hash, const std::vector<std::vector<ImageData>>& slices, ID3D11Device* device) {
+  return CreateFromSlices(name_hash, slices, Type::DIM_2_ARRAY, device);
+}
+
+// Bytes per texel of the uncompressed formats updatable textures are created with
+UINT GetTexelSize(DXGI_FORMAT format) {
+  switch (format) {
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_R8_UINT:
+      return 1;
+    case DXGI_FORMAT_R8G8_UNORM:
+    case DXGI_FORMAT_R8G8_UINT:
+      return 2;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_R8G8B8A8_UINT:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_R32_UINT:
+      return 4;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+      return 8;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+Handle CreateUpdatable(size_t name_hash, DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mip_levels,
+                       ID3D11Device* device) {
+  auto cached_handle = g_cache_.Get(name_hash);
+
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  D3D11_TEXTURE2D_DESC desc = {};
+  desc.Width = width;
+  desc.Height = height;
+  desc.MipLevels = mip_levels;
+  desc.ArraySize = 1;
+  desc.Format = format;
+  desc.SampleDesc.Count = 1;
+  desc.Usage = D3D11_USAGE_DEFAULT;
+  desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+  Storage new_storage(format, static_cast<uint32_t>(-1), Type::DIM_2, 1);
+  auto texture_result = device->CreateTexture2D(&desc, nullptr, new_storage.GetTexture().GetAddressOf());
+  if (FAILED(texture_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, texture_result);
+    return {};
+  }
+
+  auto view_result = device->CreateShaderResourceView(new_storage.GetTexture().Get(), nullptr, new_storage.GetView().GetAddressOf());
+  if (FAILED(view_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, view_result);
+    return {};
+  }
+
+  size_t resident_bytes = 0;
+  for (uint32_t level = 0; level < mip_levels; ++level) {
+    resident_bytes += static_cast<size_t>(std::max(1u, width >> level)) * std::max(1u, height >> level) * GetTexelSize(format);
+  }
+  new_storage.SetResidentBytes(resident_bytes);
+  g_total_resident_bytes_ += resident_bytes;
+
+  auto new_handle = g_storage_.Add(std::move(new_storage));
+  g_cache_.Set(name_hash, new_handle);
+  return new_handle;
+}
+
+void UpdateRegion(Handle handle, uint32_t level, const D3D11_BOX& box, const void* data, UINT row_pitch,
+                  ID3D11DeviceContext* context) {
+  auto& storage = g_storage_.Get(handle);
+
+  D3D11_TEXTURE2D_DESC desc;
+  storage.GetTexture()->GetDesc(&desc);
+
+  auto subresource = D3D11CalcSubresource(level, 0, desc.MipLevels);
+  context->UpdateSubresource(storage.GetTexture().Get(), subresource, &box, data, row_pitch, row_pitch * (box.bottom - box.top));
+}
+
+std::unordered_map<DXGI_FORMAT, Microsoft::WRL::ComPtr<ID3D11Texture2D>> g_placeholder_textures_;
+
+Microsoft::WRL::ComPtr<ID3D11Texture2D> GetPlaceholderTexture(DXGI_FORMAT format, ID3D11Device* device) {
+  auto placeholder_it = g_placeholder_textures_.find(format);
+  if (placeholder_it != std::end(g_placeholder_textures_)) {
+    return placeholder_it->second;
+  }
+
+  UINT texel_size;
+  switch (format) {
+    case DXGI_FORMAT_R8_UNORM:
+      texel_size = 1;
+      break;
+    case DXGI_FORMAT_R8G8_UNORM:
+      texel_size = 2;
+      break;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+      texel_size = 4;
+      break;
+    default:
+      DXFW_TRACE(__FILE__, __LINE__, false, "Unsupported placeholder format %d", format);
+      return nullptr;
+  }
+
+  const uint8_t texel[4] = { 128, 128, 128, 255 };
+  D3D11_SUBRESOURCE_DATA initial_data = { texel, texel_size, texel_size };
+
+  D3D11_TEXTURE2D_DESC desc = {};
+  desc.Width = 1;
+  desc.Height = 1;
+  desc.MipLevels = 1;
+  desc.ArraySize = 1;
+  desc.Format = format;
+  desc.SampleDesc.Count = 1;
+  desc.Usage = D3D11_USAGE_IMMUTABLE;
+  desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+  Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+  auto texture_result = device->CreateTexture2D(&desc, &initial_data, texture.GetAddressOf());
+  if (FAILED(texture_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, texture_result);
+    return nullptr;
+  }
+
+  g_placeholder_textures_[format] = texture;
+  return texture;
+}
+
+Handle CreatePlaceholder(size_t name_hash, DXGI_FORMAT format, ID3D11Device* device) {
+  auto cached_handle = g_cache_.Get(name_hash);
+
+  if (cached_handle.IsValid()) {
+    return cached_handle;
+  }
+
+  auto placeholder_texture = GetPlaceholderTexture(format, device);
+  if (placeholder_texture == nullptr) {
+    return {};
+  }
+
+  // Every placeholder gets a view of its own, swapping one view must not touch the other textures
+  Storage new_storage(format, static_cast<uint32_t>(-1), Type::DIM_2, 1);
+  new_storage.GetTexture() = placeholder_texture;
+  auto view_result = device->CreateShaderResourceView(placeholder_texture.Get(), nullptr, new_storage.GetView().GetAddressOf());
+  if (FAILED(view_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, view_result);
+    return {};
+  }
+
+  auto new_handle = g_storage_.Add(std::move(new_storage));
+  g_cache_.Set(name_hash, new_handle);
+  return new_handle;
+}
+
+bool CanBeMostDetailedLevel(const ImageData& level) {
+  if (!BlockCompression::IsBlockCompressed(level.Format)) {
+    return level.Width > 0 && level.Height > 0;
+  }
+
+  return level.Width >= 4 && level.Height >= 4 && level.Width % 4 == 0 && level.Height % 4 == 0;
+}
+
+bool SetResidentLevels(Handle handle, const std::vector<ImageData>& levels, uint32_t most_detailed_level,
+                       ID3D11Device* device, ID3D11DeviceContext* context) {
+  if (most_detailed_level >= levels.size()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Resident level %u is past the smallest level", most_detailed_level);
+    return false;
+  }
+
+  if (!CanBeMostDetailedLevel(levels[most_detailed_level])) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Resident level %u is %ux%u, block compressed textures need a multiple of 4",
+               most_detailed_level, levels[most_detailed_level].Width, levels[most_detailed_level].Height);
+    return false;
+  }
+
+  auto& storage = g_storage_.Get(handle);
+  auto level_count = static_cast<uint32_t>(levels.size()) - most_detailed_level;
+  const auto& top_level = levels[most_detailed_level];
+
+  D3D11_TEXTURE2D_DESC desc = {};
+  desc.Width = top_level.Width;
+  desc.Height = top_level.Height;
+  desc.MipLevels = level_count;
+  desc.ArraySize = 1;
+  desc.Format = top_level.Format;
+  desc.SampleDesc.Count = 1;
+  desc.Usage = D3D11_USAGE_DEFAULT;
+  desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+  Storage new_storage(top_level.Format, static_cast<uint32_t>(-1), Type::DIM_2, 1);
+  auto texture_result = device->CreateTexture2D(&desc, nullptr, new_storage.GetTexture().GetAddressOf());
+  if (FAILED(texture_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, texture_result);
+    return false;
+  }
+
+  auto old_level = storage.GetMostDetailedLevel();
+  UINT old_level_count = 0;
+  if (old_level != NoResidentLevel) {
+    D3D11_TEXTURE2D_DESC old_desc;
+    storage.GetTexture()->GetDesc(&old_desc);
+    old_level_count = old_desc.MipLevels;
+  }
+
+  size_t resident_bytes = 0;
+  for (auto level = most_detailed_level; level < levels.size(); ++level) {
+    auto destination = D3D11CalcSubresource(level - most_detailed_level, 0, level_count);
+    if (old_level != NoResidentLevel && level >= old_level) {
+      auto source = D3D11CalcSubresource(level - old_level, 0, old_level_count);
+      context->CopySubresourceRegion(new_storage.GetTexture().Get(), destination, 0, 0, 0, storage.GetTexture().Get(), source, nullptr);
+    } else {
+      context->UpdateSubresource(new_storage.GetTexture().Get(), destination, nullptr, levels[level].Data,
+                                 GetRowPitch(levels[level]), GetSlicePitch(levels[level]));
+    }
+    resident_bytes += GetSlicePitch(levels[level]);
+  }
+
+  auto view_result = device->CreateShaderResourceView(new_storage.GetTexture().Get(), nullptr, new_storage.GetView().GetAddressOf());
+  if (FAILED(view_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, view_result);
+    return false;
+  }
+
+  BindingSet::ReplaceView(storage.GetView().Get(), new_storage.GetView().Get());
+
+  g_total_resident_bytes_ += resident_bytes;
+  g_total_resident_bytes_ -= storage.GetResidentBytes();
+  new_storage.SetMostDetailedLevel(most_detailed_level);
+  new_storage.SetResidentBytes(resident_bytes);
+  storage = std::move(new_storage);
+  return true;
+}
+
+size_t GetResidentBytes(Handle handle) {
+  return g_storage_.Get(handle).GetResidentBytes();
+}
+
+size_t GetTotalResidentBytes() {
+  return g_total_resident_bytes_;
+}
+
 DXGI_FORMAT GetFormat(Handle handle) {
   return g_storage_.Get(handle).GetFormat();
 }
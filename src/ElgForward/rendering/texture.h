@@ -40,10 +40,51 @@ struct ImageData {
   const unsigned char* Data;
 };
 
+// Bytes in one level, block compressed images are addressed in rows of 4x4 blocks
+UINT GetRowPitch(const ImageData& image);
+
+UINT GetSlicePitch(const ImageData& image);
+
 Handle Create(size_t name_hash, const std::vector<ImageData>& data, ID3D11Device* device);
 
 Handle Create(const std::string& name, const std::vector<ImageData>& data, ID3D11Device* device);
 
+// Creates a DIM_2, DIM_2_ARRAY, CUBE or CUBE_ARRAY texture from prepared subresources, ordered by array slice
+// first and mip level second. Cube textures take six slices per cube.
+Handle Create(size_t name_hash, Type type, DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mip_levels,
+              uint32_t array_size, const std::vector<D3D11_SUBRESOURCE_DATA>& subresources, ID3D11Device* device);
+
+// Creates a DIM_2_ARRAY texture, every slice needs the same size, format and mip count
+Handle CreateArray(size_t name_hash, const std::vector<std::vector<ImageData>>& slices, ID3D11Device* device);
+
+// Creates an empty DIM_2 texture whose regions are filled with UpdateRegion, for data that changes while rendering
+Handle CreateUpdatable(size_t name_hash, DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mip_levels,
+                       ID3D11Device* device);
+
+// Copies a box of texels into one level of an updatable texture, row_pitch is the byte stride of data
+void UpdateRegion(Handle handle, uint32_t level, const D3D11_BOX& box, const void* data, UINT row_pitch,
+                  ID3D11DeviceContext* context);
+
+// Streamed textures start out as their own view of a shared 1x1 placeholder, so they can be bound before any data
+// exists. The handle stays the same while its levels arrive. Takes R8, R8G8 and R8G8B8A8 formats, which should
+// have the channel count of the final texture so materials accept it.
+Handle CreatePlaceholder(size_t name_hash, DXGI_FORMAT format, ID3D11Device* device);
+
+// Block compressed textures need a top level that is a whole number of 4x4 blocks, levels below it may be smaller
+bool CanBeMostDetailedLevel(const ImageData& level);
+
+// Rebuilds a placeholder or streamed texture as a DIM_2 texture that holds levels[most_detailed_level] down to the
+// smallest level, levels being the full chain largest first. Levels that were already resident are copied on the GPU,
+// the others are uploaded from levels. Binding sets that hold the old view are moved to the new one. Fails for a
+// most detailed level that CanBeMostDetailedLevel rejects.
+bool SetResidentLevels(Handle handle, const std::vector<ImageData>& levels, uint32_t most_detailed_level,
+                       ID3D11Device* device, ID3D11DeviceContext* context);
+
+// Size of the texture data in video memory, placeholders count as empty
+size_t GetResidentBytes(Handle handle);
+
+size_t GetTotalResidentBytes();
+
 DXGI_FORMAT GetFormat(Handle handle);
 
 size_t GetSamples(Handle handle);
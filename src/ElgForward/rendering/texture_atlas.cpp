@@ -0,0 +1,130 @@
+#include "rendering/texture_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace Rendering {
+namespace TextureAtlas {
+
+uint32_t NextPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+bool PackShelves(const std::vector<Texture::ImageData>& images, const std::vector<size_t>& order, uint32_t padding, uint32_t width,
+                 std::vector<Rect>* rects, uint32_t* height) {
+  uint32_t shelf_x = 0;
+  uint32_t shelf_y = 0;
+  uint32_t shelf_height = 0;
+
+  for (auto index : order) {
+    auto padded_width = images[index].Width + 2 * padding;
+    auto padded_height = images[index].Height + 2 * padding;
+    if (padded_width > width) {
+      return false;
+    }
+
+    if (shelf_x + padded_width > width) {
+      shelf_y += shelf_height;
+      shelf_x = 0;
+      shelf_height = 0;
+    }
+
+    auto& rect = (*rects)[index];
+    rect.X = shelf_x + padding;
+    rect.Y = shelf_y + padding;
+    rect.Width = images[index].Width;
+    rect.Height = images[index].Height;
+
+    shelf_x += padded_width;
+    shelf_height = std::max(shelf_height, padded_height);
+  }
+
+  *height = shelf_y + shelf_height;
+  return true;
+}
+
+bool Pack(const std::vector<Texture::ImageData>& images, uint32_t padding, uint32_t max_size,
+          std::vector<Rect>* rects, uint32_t* atlas_width, uint32_t* atlas_height) {
+  if (images.empty()) {
+    return false;
+  }
+
+  // Tallest first keeps the shelves tight
+  std::vector<size_t> order(images.size());
+  std::iota(std::begin(order), std::end(order), 0);
+  std::sort(std::begin(order), std::end(order), [&images](size_t lhs, size_t rhs) {
+    return images[lhs].Height > images[rhs].Height;
+  });
+
+  uint32_t min_width = 0;
+  uint64_t total_area = 0;
+  for (const auto& image : images) {
+    min_width = std::max(min_width, image.Width + 2 * padding);
+    total_area += static_cast<uint64_t>(image.Width + 2 * padding) * (image.Height + 2 * padding);
+  }
+
+  rects->resize(images.size());
+
+  // Grow the width until the shelves fit in a square, or in max_size at the largest width
+  for (auto width = NextPowerOfTwo(min_width); width <= max_size; width <<= 1) {
+    if (static_cast<uint64_t>(width) * width < total_area && width < max_size) {
+      continue;
+    }
+
+    uint32_t height;
+    if (!PackShelves(images, order, padding, width, rects, &height)) {
+      continue;
+    }
+
+    auto pow2_height = NextPowerOfTwo(height);
+    if (pow2_height <= width || (width == max_size && pow2_height <= max_size)) {
+      *atlas_width = width;
+      *atlas_height = pow2_height;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+Rect GetLevelRect(const Rect& rect, uint32_t level) {
+  Rect level_rect;
+  level_rect.X = rect.X >> level;
+  level_rect.Y = rect.Y >> level;
+  level_rect.Width = rect.Width >> level;
+  level_rect.Height = rect.Height >> level;
+  return level_rect;
+}
+
+void Blit(const Texture::ImageData& image, const Rect& rect, uint32_t padding, uint32_t atlas_width, unsigned char* atlas_data) {
+  auto pixel_size = static_cast<size_t>(image.Components);
+  auto atlas_pitch = atlas_width * pixel_size;
+
+  for (uint32_t y = 0; y < rect.Height + 2 * padding; ++y) {
+    auto source_y = std::min(static_cast<uint32_t>(std::max(static_cast<int64_t>(y) - padding, int64_t(0))), image.Height - 1);
+    auto source_row = image.Data + source_y * image.Width * pixel_size;
+    auto destination_row = atlas_data + (rect.Y - padding + y) * atlas_pitch + (rect.X - padding) * pixel_size;
+
+    for (uint32_t x = 0; x < padding; ++x) {
+      std::memcpy(destination_row + x * pixel_size, source_row, pixel_size);
+      std::memcpy(destination_row + (padding + rect.Width + x) * pixel_size, source_row + (image.Width - 1) * pixel_size, pixel_size);
+    }
+
+    std::memcpy(destination_row + padding * pixel_size, source_row, image.Width * pixel_size);
+  }
+}
+
+DirectX::XMFLOAT4 GetUvScaleOffset(const Rect& rect, uint32_t atlas_width, uint32_t atlas_height) {
+  return DirectX::XMFLOAT4(static_cast<float>(rect.Width) / atlas_width,
+                           static_cast<float>(rect.Height) / atlas_height,
+                           static_cast<float>(rect.X) / atlas_width,
+                           static_cast<float>(rect.Y) / atlas_height);
+}
+
+}  // namespace TextureAtlas
+}  // namespace Rendering
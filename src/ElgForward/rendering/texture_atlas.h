@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "rendering/texture.h"
+
+namespace Rendering {
+namespace TextureAtlas {
+
+struct Rect {
+  uint32_t X = 0;
+  uint32_t Y = 0;
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+};
+
+// Shelf packs the images into a power of two atlas no larger than max_size. The rects exclude the padding,
+// which is filled by Blit with the replicated image edges so bilinear filtering does not bleed. When the image sizes
+// and the padding are multiples of 2^n, so is every rect and its padding, and the atlas keeps n + 1 mip levels.
+bool Pack(const std::vector<Texture::ImageData>& images, uint32_t padding, uint32_t max_size,
+          std::vector<Rect>* rects, uint32_t* atlas_width, uint32_t* atlas_height);
+
+// Rect of an entry in a smaller mip level of the atlas, exact when the rect is aligned to 2^level
+Rect GetLevelRect(const Rect& rect, uint32_t level);
+
+void Blit(const Texture::ImageData& image, const Rect& rect, uint32_t padding, uint32_t atlas_width, unsigned char* atlas_data);
+
+// xy - scale, zw - offset to apply to the image texture coordinates
+DirectX::XMFLOAT4 GetUvScaleOffset(const Rect& rect, uint32_t atlas_width, uint32_t atlas_height);
+
+}  // namespace TextureAtlas
+}  // namespace Rendering
@@ -0,0 +1,243 @@
+#include "rendering/texture_residency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#include <dxfw/dxfw.h>
+
+namespace Rendering {
+namespace TextureResidency {
+
+const uint32_t PromotionsPerUpdate = 8;
+const size_t DefaultBudgetBytes = 256 * 1024 * 1024;
+
+struct Entry {
+  Texture::Handle Handle;
+  std::vector<Texture::ImageData> Levels;
+  std::shared_ptr<const void> Owner;
+  std::vector<uint32_t> TopLevels;  // Levels that can be the most detailed resident one, ascending
+  uint32_t ResidentLevel;  // Most detailed level in video memory
+  uint32_t DesiredLevel;  // Most detailed level the draws of the last used frame asked for
+  uint32_t RequestedLevel;  // Most detailed level already counted as a request
+  uint64_t LastUsedFrame = 0;
+};
+
+std::unordered_map<uint32_t, Entry> g_entries_;
+std::unordered_map<uint32_t, std::vector<Texture::Handle>> g_binding_set_textures_;
+size_t g_budget_bytes_ = DefaultBudgetBytes;
+uint64_t g_frame_ = 1;
+Counters g_counters_;
+
+void SetBudget(size_t bytes) {
+  g_budget_bytes_ = bytes;
+}
+
+bool Register(Texture::Handle handle, const std::vector<Texture::ImageData>& levels, std::shared_ptr<const void> owner,
+              ID3D11Device* device, ID3D11DeviceContext* context) {
+  if (levels.empty()) {
+    return false;
+  }
+
+  // Block compressed chains end below the 4x4 block size, those levels are only resident under a larger one
+  std::vector<uint32_t> top_levels;
+  for (uint32_t level = 0; level < levels.size(); ++level) {
+    if (Texture::CanBeMostDetailedLevel(levels[level])) {
+      top_levels.push_back(level);
+    }
+  }
+
+  if (top_levels.empty()) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Streamed texture of %ux%u has no level that can be resident", levels[0].Width, levels[0].Height);
+    return false;
+  }
+
+  auto smallest_level = top_levels.back();
+  if (!Texture::SetResidentLevels(handle, levels, smallest_level, device, context)) {
+    return false;
+  }
+
+  Entry entry;
+  entry.Handle = handle;
+  entry.Levels = levels;
+  entry.Owner = std::move(owner);
+  entry.TopLevels = std::move(top_levels);
+  entry.ResidentLevel = smallest_level;
+  entry.DesiredLevel = smallest_level;
+  entry.RequestedLevel = smallest_level;
+
+  g_entries_[handle.CompactForm()] = std::move(entry);
+  return true;
+}
+
+void RegisterBindingSet(BindingSet::Handle binding_set, const std::vector<Texture::Handle>& textures) {
+  g_binding_set_textures_[binding_set.CompactForm()] = textures;
+}
+
+// Rounds towards more detail, so the level can be the top of the texture
+uint32_t GetTopLevel(const Entry& entry, uint32_t level) {
+  auto level_it = std::upper_bound(std::begin(entry.TopLevels), std::end(entry.TopLevels), level);
+  if (level_it == std::begin(entry.TopLevels)) {
+    return entry.TopLevels.front();
+  }
+  return *(level_it - 1);
+}
+
+uint32_t GetLevelForScreenSize(const Entry& entry, float screen_size) {
+  auto smallest_level = entry.TopLevels.back();
+  auto texture_size = static_cast<float>(std::max(entry.Levels[0].Width, entry.Levels[0].Height));
+
+  if (screen_size < 1.0f) {
+    return smallest_level;
+  }
+
+  auto texels_per_pixel = texture_size / screen_size;
+  if (texels_per_pixel <= 1.0f) {
+    return GetTopLevel(entry, 0);
+  }
+
+  return GetTopLevel(entry, std::min(smallest_level, static_cast<uint32_t>(std::log2(texels_per_pixel))));
+}
+
+void Touch(BindingSet::Handle binding_set, float screen_size) {
+  auto textures_it = g_binding_set_textures_.find(binding_set.CompactForm());
+  if (textures_it == std::end(g_binding_set_textures_)) {
+    return;
+  }
+
+  for (auto texture : textures_it->second) {
+    auto entry_it = g_entries_.find(texture.CompactForm());
+    if (entry_it == std::end(g_entries_)) {
+      continue;
+    }
+
+    auto& entry = entry_it->second;
+    auto level = GetLevelForScreenSize(entry, screen_size);
+
+    // The largest use of the texture this frame decides
+    if (entry.LastUsedFrame != g_frame_) {
+      entry.LastUsedFrame = g_frame_;
+      entry.DesiredLevel = level;
+    } else {
+      entry.DesiredLevel = std::min(entry.DesiredLevel, level);
+    }
+  }
+}
+
+bool SetResidentLevel(Entry* entry, uint32_t level, ID3D11Device* device, ID3D11DeviceContext* context) {
+  if (!Texture::SetResidentLevels(entry->Handle, entry->Levels, level, device, context)) {
+    return false;
+  }
+
+  entry->ResidentLevel = level;
+  return true;
+}
+
+// Textures holding more than this frame asked for go first, then the ones unused for the longest
+Entry* FindEvictionCandidate(const Entry* requester) {
+  Entry* candidate = nullptr;
+  uint64_t candidate_key = std::numeric_limits<uint64_t>::max();
+
+  for (auto& entry_pair : g_entries_) {
+    auto& entry = entry_pair.second;
+    bool is_smallest = entry.ResidentLevel >= entry.TopLevels.back();
+    if (&entry == requester || is_smallest) {
+      continue;
+    }
+
+    bool used_this_frame = entry.LastUsedFrame == g_frame_;
+    bool over_detailed = entry.ResidentLevel < entry.DesiredLevel;
+    if (used_this_frame && !over_detailed) {
+      continue;
+    }
+
+    auto key = over_detailed ? 0 : entry.LastUsedFrame + 1;
+    if (key < candidate_key) {
+      candidate = &entry;
+      candidate_key = key;
+    }
+  }
+
+  return candidate;
+}
+
+bool MakeRoom(size_t bytes, const Entry* requester, ID3D11Device* device, ID3D11DeviceContext* context) {
+  while (Texture::GetTotalResidentBytes() + bytes > g_budget_bytes_) {
+    auto candidate = FindEvictionCandidate(requester);
+    if (candidate == nullptr) {
+      return false;
+    }
+
+    auto level = *std::upper_bound(std::begin(candidate->TopLevels), std::end(candidate->TopLevels), candidate->ResidentLevel);
+    if (!SetResidentLevel(candidate, level, device, context)) {
+      return false;
+    }
+
+    // A level that was evicted counts as a new request once a draw wants it back
+    candidate->RequestedLevel = std::max(candidate->RequestedLevel, candidate->ResidentLevel);
+    g_counters_.Evictions += 1;
+  }
+
+  return true;
+}
+
+void Update(ID3D11Device* device, ID3D11DeviceContext* context) {
+  std::vector<Entry*> requests;
+  for (auto& entry_pair : g_entries_) {
+    auto& entry = entry_pair.second;
+    if (entry.LastUsedFrame != g_frame_ || entry.DesiredLevel >= entry.ResidentLevel) {
+      continue;
+    }
+
+    if (entry.DesiredLevel < entry.RequestedLevel) {
+      g_counters_.Requests += entry.RequestedLevel - entry.DesiredLevel;
+      entry.RequestedLevel = entry.DesiredLevel;
+    }
+
+    requests.push_back(&entry);
+  }
+
+  // The textures furthest from what they need go first
+  std::sort(std::begin(requests), std::end(requests), [](const Entry* a, const Entry* b) {
+    return a->ResidentLevel - a->DesiredLevel > b->ResidentLevel - b->DesiredLevel;
+  });
+
+  auto promotions = PromotionsPerUpdate;
+  for (auto entry : requests) {
+    if (promotions == 0) {
+      break;
+    }
+
+    // Desired levels are always top levels, so there is one between it and the resident level
+    auto level = *(std::lower_bound(std::begin(entry->TopLevels), std::end(entry->TopLevels), entry->ResidentLevel) - 1);
+
+    size_t promoted_bytes = 0;
+    for (auto promoted_level = level; promoted_level < entry->ResidentLevel; ++promoted_level) {
+      promoted_bytes += Texture::GetSlicePitch(entry->Levels[promoted_level]);
+    }
+
+    if (!MakeRoom(promoted_bytes, entry, device, context)) {
+      continue;
+    }
+
+    if (!SetResidentLevel(entry, level, device, context)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error promoting texture to level %u", level);
+      continue;
+    }
+
+    --promotions;
+  }
+
+  g_frame_ += 1;
+}
+
+Counters GetCounters() {
+  auto counters = g_counters_;
+  counters.ResidentBytes = Texture::GetTotalResidentBytes();
+  counters.BudgetBytes = g_budget_bytes_;
+  return counters;
+}
+
+}  // namespace TextureResidency
+}  // namespace Rendering
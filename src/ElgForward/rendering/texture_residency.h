@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "rendering/binding_set.h"
+#include "rendering/texture.h"
+
+namespace Rendering {
+namespace TextureResidency {
+
+struct Counters {
+  size_t ResidentBytes = 0;  // Every texture, managed or not
+  size_t BudgetBytes = 0;
+  uint64_t Requests = 0;  // Levels asked for by draws while they weren't resident
+  uint64_t Evictions = 0;  // Levels dropped to stay within the budget
+};
+
+void SetBudget(size_t bytes);
+
+// Hands over the full level chain of a streamed texture, largest first. The owner keeps the level data alive - it is
+// the backing store evicted levels come back from. Only the smallest level is made resident right away.
+bool Register(Texture::Handle handle, const std::vector<Texture::ImageData>& levels, std::shared_ptr<const void> owner,
+              ID3D11Device* device, ID3D11DeviceContext* context);
+
+// Remembers the textures behind a binding set, so draws can be traced back to their textures
+void RegisterBindingSet(BindingSet::Handle binding_set, const std::vector<Texture::Handle>& textures);
+
+// Marks the textures of a binding set as used this frame. screen_size is the projected size of the object in pixels
+// and picks the level that gives about one texel per pixel.
+void Touch(BindingSet::Handle binding_set, float screen_size);
+
+// Once per frame, after the draws were touched. Promotes requested textures one level at a time and demotes the least
+// recently used ones when the budget runs out.
+void Update(ID3D11Device* device, ID3D11DeviceContext* context);
+
+Counters GetCounters();
+
+}  // namespace TextureResidency
+}  // namespace Rendering
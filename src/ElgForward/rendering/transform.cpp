@@ -0,0 +1,34 @@
+#include "transform.h"
+
+#include <vector>
+
+namespace Rendering {
+namespace Transform {
+
+std::vector<TransformAndInverseTranspose> g_transforms_;
+
+Transform Create(const TransformAndInverseTranspose& matrices) {
+  if (g_transforms_.size() >= Transform::InvalidIndex) {
+    return {};
+  }
+
+  Transform transform;
+  transform.Index = static_cast<uint32_t>(g_transforms_.size());
+  g_transforms_.push_back(matrices);
+  return transform;
+}
+
+const TransformAndInverseTranspose& Get(Transform transform) {
+  return g_transforms_[transform.Index];
+}
+
+size_t GetCount() {
+  return g_transforms_.size();
+}
+
+void Clear() {
+  g_transforms_.clear();
+}
+
+}  // namespace Transform
+}  // namespace Rendering
@@ -1,13 +1,33 @@
 #pragma once
 
-#include "rendering/constant_buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+#include "rendering/transform_and_inverse_transpose.h"
 
 namespace Rendering {
 namespace Transform {
 
+// Entry in the object transform table. Drawables keep the index, the transforms of the drawables visible in a frame
+// are copied into the object structured buffer the shaders read.
 struct Transform {
-  ConstantBuffer::Handle TransformConstantBuffer;
+  static const uint32_t InvalidIndex = static_cast<uint32_t>(-1);
+
+  uint32_t Index = InvalidIndex;
+
+  bool IsValid() const {
+    return Index != InvalidIndex;
+  }
 };
 
+Transform Create(const TransformAndInverseTranspose& matrices);
+
+const TransformAndInverseTranspose& Get(Transform transform);
+
+size_t GetCount();
+
+// Invalidates every transform created so far
+void Clear();
+
 }  // namespace Transform
 }  // namespace Rendering
@@ -1,5 +1,7 @@
 #include "vertex_layout.h"
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <d3d11.h>
@@ -14,12 +16,103 @@
 namespace Rendering {
 namespace VertexLayout {
 
+struct ElementKey {
+  uint32_t SemanticId;
+  uint32_t SemanticIndex;
+  DXGI_FORMAT Format;
+  uint32_t InputSlot;
+  uint32_t AlignedByteOffset;
+  D3D11_INPUT_CLASSIFICATION InputSlotClass;
+  uint32_t InstanceDataStepRate;
+};
+
+inline bool operator==(const ElementKey& lhs, const ElementKey& rhs) {
+  return lhs.SemanticId == rhs.SemanticId
+    && lhs.SemanticIndex == rhs.SemanticIndex
+    && lhs.Format == rhs.Format
+    && lhs.InputSlot == rhs.InputSlot
+    && lhs.AlignedByteOffset == rhs.AlignedByteOffset
+    && lhs.InputSlotClass == rhs.InputSlotClass
+    && lhs.InstanceDataStepRate == rhs.InstanceDataStepRate;
+}
+
+struct LayoutKey {
+  std::vector<ElementKey> Elements = {};
+  size_t Hash = 0;
+};
+
+inline bool operator==(const LayoutKey& lhs, const LayoutKey& rhs) {
+  return lhs.Hash == rhs.Hash && lhs.Elements == rhs.Elements;
+}
+
+}  // namespace VertexLayout
+}  // namespace Rendering
+
+namespace std {
+
+template<>
+struct hash<Rendering::VertexLayout::LayoutKey> {
+  size_t operator()(const Rendering::VertexLayout::LayoutKey& key) const {
+    return key.Hash;
+  }
+};
+
+}  // std
+
+namespace Rendering {
+namespace VertexLayout {
+
 Core::ResourceArray<Handle, Microsoft::WRL::ComPtr<ID3D11InputLayout>, 255> g_storage_;
-Core::HandleCache<std::vector<D3D11_INPUT_ELEMENT_DESC>, Handle> g_cache_;
+Core::HandleCache<LayoutKey, Handle> g_cache_;
+std::unordered_map<std::string, uint32_t> g_semantic_ids_;
+Statistics g_statistics_;
+
+uint32_t InternSemantic(const char* semantic_name) {
+  auto it = g_semantic_ids_.find(semantic_name);
+  if (it != std::end(g_semantic_ids_)) {
+    return it->second;
+  }
+
+  auto id = static_cast<uint32_t>(g_semantic_ids_.size());
+  g_semantic_ids_.emplace(semantic_name, id);
+  g_statistics_.InternedSemantics = static_cast<uint32_t>(g_semantic_ids_.size());
+  return id;
+}
+
+LayoutKey GetKey(const std::vector<D3D11_INPUT_ELEMENT_DESC>& input_layout) {
+  LayoutKey key;
+  key.Elements.reserve(input_layout.size());
+
+  for (const auto& element : input_layout) {
+    ElementKey element_key;
+    element_key.SemanticId = InternSemantic(element.SemanticName);
+    element_key.SemanticIndex = element.SemanticIndex;
+    element_key.Format = element.Format;
+    element_key.InputSlot = element.InputSlot;
+    element_key.AlignedByteOffset = element.AlignedByteOffset;
+    element_key.InputSlotClass = element.InputSlotClass;
+    element_key.InstanceDataStepRate = element.InstanceDataStepRate;
+    key.Elements.push_back(element_key);
+
+    hash_combine(key.Hash, element_key.SemanticId);
+    hash_combine(key.Hash, element_key.SemanticIndex);
+    hash_combine(key.Hash, element_key.Format);
+    hash_combine(key.Hash, element_key.InputSlot);
+    hash_combine(key.Hash, element_key.AlignedByteOffset);
+    hash_combine(key.Hash, element_key.InputSlotClass);
+    hash_combine(key.Hash, element_key.InstanceDataStepRate);
+  }
+
+  return key;
+}
 
 Handle Create(const std::vector<D3D11_INPUT_ELEMENT_DESC>& input_layout, ID3DBlob* shader_blob, ID3D11Device* device) {
-  auto cached_handle = g_cache_.Get(input_layout);
+  ++g_statistics_.Requests;
+
+  auto key = GetKey(input_layout);
+  auto cached_handle = g_cache_.Get(key);
   if (cached_handle.IsValid()) {
+    ++g_statistics_.Hits;
     return cached_handle;
   }
 
@@ -36,13 +129,17 @@ Handle Create(const std::vector<D3D11_INPUT_ELEMENT_DESC>& input_layout, ID3DBlo
   }
 
   auto new_handle = g_storage_.Add(vertex_layout);
-  g_cache_.Set(input_layout, new_handle);
+  g_cache_.Set(key, new_handle);
   return new_handle;
 };
 
-Microsoft::WRL::ComPtr<ID3D11InputLayout> Retreive(Handle handle) {
+const Microsoft::WRL::ComPtr<ID3D11InputLayout>& Retreive(Handle handle) {
   return g_storage_.Get(handle);
 }
 
+const Statistics& GetStatistics() {
+  return g_statistics_;
+}
+
 }  // namespace VertexLayout
 }  // namespace Rendering
@@ -14,9 +14,18 @@ struct VertexLayoutTag {};
 
 using Handle = Core::Handle<8, 24, VertexLayoutTag>;
 
+struct Statistics {
+  uint32_t Requests = 0;
+  uint32_t Hits = 0;
+  uint32_t InternedSemantics = 0;
+};
+
+// Layouts are keyed by content - semantic names are compared by value, not by pointer
 Handle Create(const std::vector<D3D11_INPUT_ELEMENT_DESC>& input_layout, ID3DBlob* shader_blob, ID3D11Device* device);
 
-Microsoft::WRL::ComPtr<ID3D11InputLayout> Retreive(Handle handle);
+const Microsoft::WRL::ComPtr<ID3D11InputLayout>& Retreive(Handle handle);
+
+const Statistics& GetStatistics();
 
 }  // namespace VertexLayout
 }  // namespace Rendering
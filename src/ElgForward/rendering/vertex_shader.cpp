@@ -14,6 +14,8 @@
 #include "core/resource_array.h"
 #include "core/handle_cache.h"
 #include "rendering/shader_reflection.h"
+#include "rendering/shader_reflection_cache.h"
+#include "rendering/shader_permutation.h"
 
 namespace Rendering {
 namespace VertexShader {
@@ -21,6 +23,38 @@ namespace VertexShader {
 Core::ResourceArray<Handle, ShaderData, 255> g_vertex_shader_storage_;
 Core::HandleCache<size_t, Handle> g_vertex_shader_cache_;
 
+Handle CreateFromBlob(size_t key, Microsoft::WRL::ComPtr<ID3DBlob> buffer, const filesystem::path& reflection_cache_path,
+                      const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ID3D11Device* device) {
+  auto data = ShaderData();
+  data.Buffer = buffer;
+
+  HRESULT shader_creation_result = device->CreateVertexShader(data.Buffer->GetBufferPointer(),
+                                                              data.Buffer->GetBufferSize(),
+                                                              nullptr,
+                                                              data.Shader.GetAddressOf());
+  
+  if (FAILED(shader_creation_result)) {
+    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, shader_creation_result);
+    return {};
+  }
+
+  auto reflection_key = ShaderReflection::GetCacheKey(data.Buffer.Get(), custom_channel_map);
+  if (!ShaderReflection::ReadCache(reflection_cache_path, reflection_key, &data.ReflectionData)) {
+    bool reflection_ok = ShaderReflection::ReflectVertexShader(data.Buffer.Get(), custom_channel_map, &data.ReflectionData);
+    if (!reflection_ok) {
+      return {};
+    }
+
+    if (!ShaderReflection::WriteCache(reflection_cache_path, reflection_key, data.ReflectionData)) {
+      DXFW_TRACE(__FILE__, __LINE__, false, "Error writing shader reflection cache %S", reflection_cache_path.string().c_str());
+    }
+  }
+
+  auto new_handle = g_vertex_shader_storage_.Add(std::move(data));
+  g_vertex_shader_cache_.Set(key, new_handle);
+  return new_handle;
+}
+
 Handle Create(const filesystem::path& path, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ID3D11Device* device) {
   std::hash<filesystem::path> hasher;
   size_t path_hash = hasher(path);
@@ -30,37 +64,35 @@ Handle Create(const filesystem::path& path, const std::unordered_map<std::string
     return cached_handle;
   }
 
-  auto data = ShaderData();
-  
-  HRESULT load_result = D3DReadFileToBlob(path.c_str(), data.Buffer.GetAddressOf());
+  Microsoft::WRL::ComPtr<ID3DBlob> buffer;
+  HRESULT load_result = D3DReadFileToBlob(path.c_str(), buffer.GetAddressOf());
   if (FAILED(load_result)) {
     DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, load_result);
     return {};
   }
 
-  HRESULT shader_creation_result = device->CreateVertexShader(data.Buffer->GetBufferPointer(),
-                                                              data.Buffer->GetBufferSize(),
-                                                              nullptr,
-                                                              data.Shader.GetAddressOf());
-  
-  if (FAILED(shader_creation_result)) {
-    DXFW_DIRECTX_TRACE(__FILE__, __LINE__, true, shader_creation_result);
+  return CreateFromBlob(path_hash, buffer, ShaderReflection::GetCachePath(path), custom_channel_map, device);
+}
+
+Handle Create(const ShaderPermutation::Permutation& permutation, const filesystem::path& cache_path,
+              const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ID3D11Device* device) {
+  size_t key;
+  if (!ShaderPermutation::GetKey(permutation, &key)) {
     return {};
   }
 
-  bool input_reflection_ok = ShaderReflection::ReflectInputs(data.Buffer.Get(), custom_channel_map, &data.ReflectionData);
-  if (!input_reflection_ok) {
-    return {};
+  auto cached_handle = g_vertex_shader_cache_.Get(key);
+  if (cached_handle.IsValid()) {
+    return cached_handle;
   }
 
-  bool texture_reflection_ok = ShaderReflection::ReflectTextures(data.Buffer.Get(), &data.ReflectionData);
-  if (!texture_reflection_ok) {
+  auto buffer = ShaderPermutation::Load(permutation, key, cache_path);
+  if (buffer == nullptr) {
     return {};
   }
 
-  auto new_handle = g_vertex_shader_storage_.Add(std::move(data));
-  g_vertex_shader_cache_.Set(path_hash, new_handle);
-  return new_handle;
+  auto reflection_cache_path = ShaderReflection::GetCachePath(ShaderPermutation::GetCachedFilePath(key, cache_path));
+  return CreateFromBlob(key, buffer, reflection_cache_path, custom_channel_map, device);
 }
 
 ShaderData* Retreive(Handle handle) {
@@ -10,6 +10,7 @@
 #include "core/handle.h"
 #include "rendering/vertex_data.h"
 #include "rendering/shader_reflection.h"
+#include "rendering/shader_permutation.h"
 
 namespace Rendering {
 namespace VertexShader {
@@ -51,6 +52,9 @@ struct ShaderData {
 
 Handle Create(const filesystem::path& path, const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ID3D11Device* device);
 
+Handle Create(const ShaderPermutation::Permutation& permutation, const filesystem::path& cache_path,
+              const std::unordered_map<std::string, VertexDataChannel>& custom_channel_map, ID3D11Device* device);
+
 ShaderData* Retreive(Handle handle);
 
 }  // namespace VertexShader
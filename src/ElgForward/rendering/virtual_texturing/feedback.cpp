@@ -0,0 +1,55 @@
+#include "rendering/virtual_texturing/feedback.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+void ReduceFeedback(const std::vector<uint32_t>& feedback, uint32_t level_count, std::vector<PageRequest>* requests) {
+  requests->clear();
+
+  // Neighbouring texels mostly ask for the same page, so runs are counted before touching the map
+  std::unordered_map<uint32_t, uint32_t> counts;
+  uint32_t run_value = InvalidFeedback;
+  uint32_t run_length = 0;
+  for (auto value : feedback) {
+    if (value == run_value) {
+      ++run_length;
+      continue;
+    }
+
+    if (run_value != InvalidFeedback) {
+      counts[run_value] += run_length;
+    }
+    run_value = value;
+    run_length = 1;
+  }
+
+  if (run_value != InvalidFeedback) {
+    counts[run_value] += run_length;
+  }
+
+  std::unordered_map<PageId, uint32_t> pages;
+  for (const auto& count : counts) {
+    auto page = UnpackPageId(count.first);
+    for (; page.Level < level_count; page = GetParent(page)) {
+      pages[page] += count.second;
+    }
+  }
+
+  requests->reserve(pages.size());
+  for (const auto& page : pages) {
+    requests->push_back({ page.first, page.second });
+  }
+
+  std::sort(std::begin(*requests), std::end(*requests), [](const PageRequest& a, const PageRequest& b) {
+    if (a.Page.Level != b.Page.Level) {
+      return a.Page.Level > b.Page.Level;
+    }
+    return a.Count > b.Count;
+  });
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rendering/virtual_texturing/page_id.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+struct PageRequest {
+  PageId Page = {};
+  uint32_t Count = 0;  // Feedback texels that asked for the page or one of its descendants
+};
+
+// Reduces a frame of feedback - packed page ids, InvalidFeedback where nothing was sampled - to unique page requests.
+// Every page also requests its ancestors, so a missing page sharpens one level at a time instead of waiting on the
+// finest one. Requests are ordered coarsest level first and by count within a level. Ids outside level_count levels
+// are dropped.
+void ReduceFeedback(const std::vector<uint32_t>& feedback, uint32_t level_count, std::vector<PageRequest>* requests);
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
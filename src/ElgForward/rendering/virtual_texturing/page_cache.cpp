@@ -0,0 +1,80 @@
+#include "rendering/virtual_texturing/page_cache.h"
+
+#include <iterator>
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+PageCache::PageCache(uint32_t width_in_slots, uint32_t height_in_slots)
+    : m_width_(width_in_slots),
+      m_height_(height_in_slots) {
+  auto capacity = static_cast<uint32_t>(GetCapacity());
+  m_free_slots_.reserve(capacity);
+  for (auto slot_index = capacity; slot_index-- > 0;) {
+    m_free_slots_.push_back(slot_index);
+  }
+}
+
+bool PageCache::Find(const PageId& page, Slot* slot) const {
+  auto page_it = m_pages_.find(page);
+  if (page_it == std::end(m_pages_)) {
+    return false;
+  }
+
+  *slot = GetSlot(page_it->second->SlotIndex);
+  return true;
+}
+
+bool PageCache::Touch(const PageId& page, uint64_t frame) {
+  auto page_it = m_pages_.find(page);
+  if (page_it == std::end(m_pages_)) {
+    return false;
+  }
+
+  page_it->second->LastUsedFrame = frame;
+  m_lru_.splice(std::begin(m_lru_), m_lru_, page_it->second);
+  return true;
+}
+
+bool PageCache::Allocate(const PageId& page, uint64_t frame, Slot* slot, bool* evicted, PageId* evicted_page) {
+  *evicted = false;
+
+  uint32_t slot_index;
+  if (!m_free_slots_.empty()) {
+    slot_index = m_free_slots_.back();
+    m_free_slots_.pop_back();
+  } else {
+    auto victim_it = std::end(m_lru_);
+    for (auto it = m_lru_.rbegin(); it != m_lru_.rend(); ++it) {
+      if (!it->Pinned && it->LastUsedFrame < frame) {
+        victim_it = std::prev(it.base());
+        break;
+      }
+    }
+
+    if (victim_it == std::end(m_lru_)) {
+      return false;
+    }
+
+    slot_index = victim_it->SlotIndex;
+    *evicted = true;
+    *evicted_page = victim_it->Page;
+    m_pages_.erase(victim_it->Page);
+    m_lru_.erase(victim_it);
+  }
+
+  m_lru_.push_front({ page, slot_index, frame, false });
+  m_pages_[page] = std::begin(m_lru_);
+  *slot = GetSlot(slot_index);
+  return true;
+}
+
+void PageCache::Pin(const PageId& page) {
+  auto page_it = m_pages_.find(page);
+  if (page_it != std::end(m_pages_)) {
+    page_it->second->Pinned = true;
+  }
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
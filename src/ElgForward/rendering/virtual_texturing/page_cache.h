@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "rendering/virtual_texturing/page_id.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+// Allocator for the fixed grid of slots in the physical page cache texture, with least recently used replacement.
+// Has no GPU dependencies so paging decisions can run headless.
+class PageCache {
+ public:
+  struct Slot {
+    uint32_t X = 0;
+    uint32_t Y = 0;
+  };
+
+  PageCache(uint32_t width_in_slots, uint32_t height_in_slots);
+
+  ~PageCache() = default;
+
+  PageCache(const PageCache&) = delete;
+  PageCache& operator=(const PageCache&) = delete;
+
+  PageCache(PageCache&&) = default;
+  PageCache& operator=(PageCache&&) = default;
+
+  bool Find(const PageId& page, Slot* slot) const;
+
+  // Marks a resident page as used in frame, returns false when the page isn't resident
+  bool Touch(const PageId& page, uint64_t frame);
+
+  // Takes a free slot, or the slot of the least recently used page that wasn't used in frame. *evicted is set when a
+  // page had to make room. Fails when every slot is pinned or in use this frame.
+  bool Allocate(const PageId& page, uint64_t frame, Slot* slot, bool* evicted, PageId* evicted_page);
+
+  // Pinned pages are never evicted - used for the coarsest level so every lookup has a fallback
+  void Pin(const PageId& page);
+
+  size_t GetCapacity() const {
+    return static_cast<size_t>(m_width_) * m_height_;
+  }
+
+  size_t GetResidentCount() const {
+    return m_pages_.size();
+  }
+
+ private:
+  struct Entry {
+    PageId Page;
+    uint32_t SlotIndex;
+    uint64_t LastUsedFrame;
+    bool Pinned;
+  };
+
+  Slot GetSlot(uint32_t slot_index) const {
+    return { slot_index % m_width_, slot_index / m_width_ };
+  }
+
+  uint32_t m_width_;
+  uint32_t m_height_;
+  std::list<Entry> m_lru_;  // Most recently used at the front
+  std::unordered_map<PageId, std::list<Entry>::iterator> m_pages_;
+  std::vector<uint32_t> m_free_slots_;
+};
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
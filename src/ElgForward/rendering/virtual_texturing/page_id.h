@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+// Page of the virtual texture, level 0 is the most detailed
+struct PageId {
+  uint32_t Level = 0;
+  uint32_t X = 0;
+  uint32_t Y = 0;
+
+  bool operator==(const PageId& other) const {
+    return Level == other.Level && X == other.X && Y == other.Y;
+  }
+
+  bool operator!=(const PageId& other) const {
+    return !(*this == other);
+  }
+};
+
+constexpr static const uint32_t MaxPagesPerAxis = 1 << 14;
+constexpr static const uint32_t MaxLevels = 1 << 4;
+
+// Pixels that sampled no virtual texture write this into the feedback buffer
+constexpr static const uint32_t InvalidFeedback = 0xFFFFFFFF;
+
+// Same packing as PackPageId in shaders/virtual_texture.h - x in the low 14 bits, y in the next 14 and the level on top
+inline uint32_t PackPageId(const PageId& page) {
+  return (page.Level << 28) | (page.Y << 14) | page.X;
+}
+
+inline PageId UnpackPageId(uint32_t packed) {
+  PageId page;
+  page.Level = packed >> 28;
+  page.Y = (packed >> 14) & (MaxPagesPerAxis - 1);
+  page.X = packed & (MaxPagesPerAxis - 1);
+  return page;
+}
+
+inline PageId GetParent(const PageId& page) {
+  PageId parent;
+  parent.Level = page.Level + 1;
+  parent.X = page.X / 2;
+  parent.Y = page.Y / 2;
+  return parent;
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
+
+namespace std {
+
+template<>
+struct hash<Rendering::VirtualTexturing::PageId> {
+  size_t operator()(const Rendering::VirtualTexturing::PageId& page) const {
+    return std::hash<uint32_t>()(Rendering::VirtualTexturing::PackPageId(page));
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,82 @@
+#include "rendering/virtual_texturing/page_loader.h"
+
+#include <algorithm>
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+PageLoader::PageLoader(PageProvider provider, uint32_t thread_count)
+    : m_provider_(std::move(provider)) {
+  for (uint32_t i = 0; i < std::max(1u, thread_count); ++i) {
+    m_workers_.emplace_back(&PageLoader::RunWorker, this);
+  }
+}
+
+PageLoader::~PageLoader() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    m_stop_ = true;
+    m_queue_.clear();
+  }
+  m_condition_.notify_all();
+
+  for (auto& worker : m_workers_) {
+    worker.join();
+  }
+}
+
+void PageLoader::Schedule(const std::vector<PageId>& pages) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    m_queue_.clear();
+    for (const auto& page : pages) {
+      if (m_in_flight_.find(page) == std::end(m_in_flight_)) {
+        m_queue_.push_back(page);
+      }
+    }
+  }
+  m_condition_.notify_all();
+}
+
+void PageLoader::Collect(size_t max_pages, std::vector<LoadedPage>* pages) {
+  std::lock_guard<std::mutex> lock(m_mutex_);
+  while (max_pages > 0 && !m_finished_.empty()) {
+    m_in_flight_.erase(m_finished_.front().Page);
+    pages->emplace_back(std::move(m_finished_.front()));
+    m_finished_.pop_front();
+    --max_pages;
+  }
+}
+
+size_t PageLoader::GetQueuedCount() const {
+  std::lock_guard<std::mutex> lock(m_mutex_);
+  return m_queue_.size();
+}
+
+void PageLoader::RunWorker() {
+  while (true) {
+    LoadedPage loaded_page;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex_);
+      m_condition_.wait(lock, [this] {
+        return m_stop_ || !m_queue_.empty();
+      });
+
+      if (m_stop_) {
+        return;
+      }
+
+      loaded_page.Page = m_queue_.front();
+      m_queue_.pop_front();
+      m_in_flight_.insert(loaded_page.Page);
+    }
+
+    loaded_page.Ok = m_provider_(loaded_page.Page, &loaded_page.Texels);
+
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    m_finished_.emplace_back(std::move(loaded_page));
+  }
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "rendering/virtual_texturing/page_id.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+// Fills texels with one page including its border, tightly packed rows. Runs on the loader threads.
+using PageProvider = std::function<bool(const PageId& page, std::vector<uint8_t>* texels)>;
+
+struct LoadedPage {
+  PageId Page = {};
+  std::vector<uint8_t> Texels = {};
+  bool Ok = false;
+};
+
+// Priority queue of page loads served by a small pool of threads. Has no GPU dependencies so the I/O scheduling can
+// run headless.
+class PageLoader {
+ public:
+  PageLoader(PageProvider provider, uint32_t thread_count);
+
+  ~PageLoader();
+
+  PageLoader(const PageLoader&) = delete;
+  PageLoader& operator=(const PageLoader&) = delete;
+
+  PageLoader(PageLoader&&) = delete;
+  PageLoader& operator=(PageLoader&&) = delete;
+
+  // Replaces the queue with this frame's pages, highest priority first. Queued pages that are no longer requested
+  // are dropped, pages that are loading or waiting to be collected are skipped.
+  void Schedule(const std::vector<PageId>& pages);
+
+  // Takes up to max_pages finished loads, oldest first
+  void Collect(size_t max_pages, std::vector<LoadedPage>* pages);
+
+  size_t GetQueuedCount() const;
+
+ private:
+  void RunWorker();
+
+  PageProvider m_provider_;
+  mutable std::mutex m_mutex_;
+  std::condition_variable m_condition_;
+  std::deque<PageId> m_queue_;
+  std::unordered_set<PageId> m_in_flight_;  // Loading or finished but not collected
+  std::deque<LoadedPage> m_finished_;
+  std::vector<std::thread> m_workers_;
+  bool m_stop_ = false;
+};
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
@@ -0,0 +1,84 @@
+#include "rendering/virtual_texturing/page_table.h"
+
+#include <algorithm>
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+PageTable::PageTable(uint32_t width_in_pages, uint32_t height_in_pages) {
+  auto width = std::max(1u, width_in_pages);
+  auto height = std::max(1u, height_in_pages);
+
+  while (true) {
+    Level level;
+    level.Width = width;
+    level.Height = height;
+    level.Mapped.resize(static_cast<size_t>(width) * height);
+    level.Resolved.resize(static_cast<size_t>(width) * height);
+    m_levels_.emplace_back(std::move(level));
+
+    if (width == 1 && height == 1) {
+      break;
+    }
+
+    width = std::max(1u, width / 2);
+    height = std::max(1u, height / 2);
+  }
+
+  m_dirty_levels_ = GetLevelCount();
+}
+
+bool PageTable::IsValid(const PageId& page) const {
+  return page.Level < m_levels_.size() && page.X < m_levels_[page.Level].Width && page.Y < m_levels_[page.Level].Height;
+}
+
+void PageTable::Map(const PageId& page, uint32_t cache_x, uint32_t cache_y) {
+  auto& entry = m_levels_[page.Level].Mapped[GetIndex(page)];
+  entry.CacheX = static_cast<uint8_t>(cache_x);
+  entry.CacheY = static_cast<uint8_t>(cache_y);
+  entry.Level = static_cast<uint8_t>(page.Level);
+  entry.Valid = 1;
+
+  m_dirty_levels_ = std::max(m_dirty_levels_, page.Level + 1);
+}
+
+void PageTable::Unmap(const PageId& page) {
+  m_levels_[page.Level].Mapped[GetIndex(page)] = {};
+  m_dirty_levels_ = std::max(m_dirty_levels_, page.Level + 1);
+}
+
+bool PageTable::IsMapped(const PageId& page) const {
+  return m_levels_[page.Level].Mapped[GetIndex(page)].Valid != 0;
+}
+
+bool PageTable::Update(uint32_t* dirty_levels) {
+  if (m_dirty_levels_ == 0) {
+    return false;
+  }
+
+  // A change only affects its own level and the finer levels that may fall back to it
+  for (auto level = m_dirty_levels_; level-- > 0;) {
+    auto& current = m_levels_[level];
+    const Level* parent = (level + 1 < m_levels_.size()) ? &m_levels_[level + 1] : nullptr;
+
+    for (uint32_t y = 0; y < current.Height; ++y) {
+      for (uint32_t x = 0; x < current.Width; ++x) {
+        auto index = static_cast<size_t>(y) * current.Width + x;
+        if (current.Mapped[index].Valid || parent == nullptr) {
+          current.Resolved[index] = current.Mapped[index];
+        } else {
+          auto parent_x = std::min(x / 2, parent->Width - 1);
+          auto parent_y = std::min(y / 2, parent->Height - 1);
+          current.Resolved[index] = parent->Resolved[static_cast<size_t>(parent_y) * parent->Width + parent_x];
+        }
+      }
+    }
+  }
+
+  *dirty_levels = m_dirty_levels_;
+  m_dirty_levels_ = 0;
+  return true;
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
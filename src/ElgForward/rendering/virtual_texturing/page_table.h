@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rendering/virtual_texturing/page_id.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+// One texel of the R8G8B8A8_UINT page table texture. Points at the cache slot of the page itself or, while that isn't
+// resident, of its nearest resident ancestor.
+struct PageTableEntry {
+  uint8_t CacheX = 0;
+  uint8_t CacheY = 0;
+  uint8_t Level = 0;  // Level of the page the slot holds
+  uint8_t Valid = 0;
+};
+
+static_assert(sizeof(PageTableEntry) == 4, "PageTableEntry must match the page table texel");
+
+// CPU side of the page table, one grid of entries per level. Has no GPU dependencies so paging decisions can run headless.
+class PageTable {
+ public:
+  PageTable(uint32_t width_in_pages, uint32_t height_in_pages);
+
+  ~PageTable() = default;
+
+  PageTable(const PageTable&) = delete;
+  PageTable& operator=(const PageTable&) = delete;
+
+  PageTable(PageTable&&) = default;
+  PageTable& operator=(PageTable&&) = default;
+
+  uint32_t GetLevelCount() const {
+    return static_cast<uint32_t>(m_levels_.size());
+  }
+
+  uint32_t GetLevelWidth(uint32_t level) const {
+    return m_levels_[level].Width;
+  }
+
+  uint32_t GetLevelHeight(uint32_t level) const {
+    return m_levels_[level].Height;
+  }
+
+  bool IsValid(const PageId& page) const;
+
+  void Map(const PageId& page, uint32_t cache_x, uint32_t cache_y);
+
+  void Unmap(const PageId& page);
+
+  bool IsMapped(const PageId& page) const;
+
+  // Resolves the fallback entries of every level at or below the coarsest changed level. Returns false when nothing
+  // changed, otherwise *dirty_levels is the number of levels from level 0 that need uploading.
+  bool Update(uint32_t* dirty_levels);
+
+  const std::vector<PageTableEntry>& GetEntries(uint32_t level) const {
+    return m_levels_[level].Resolved;
+  }
+
+ private:
+  struct Level {
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<PageTableEntry> Mapped;  // Pages resident at exactly this level
+    std::vector<PageTableEntry> Resolved;  // Mapped entries with the fallbacks filled in
+  };
+
+  size_t GetIndex(const PageId& page) const {
+    return static_cast<size_t>(page.Y) * m_levels_[page.Level].Width + page.X;
+  }
+
+  std::vector<Level> m_levels_;
+  uint32_t m_dirty_levels_ = 0;
+};
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
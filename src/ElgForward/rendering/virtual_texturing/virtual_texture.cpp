@@ -0,0 +1,156 @@
+#include "rendering/virtual_texturing/virtual_texture.h"
+
+#include <string>
+
+#include <dxfw/dxfw.h>
+
+#include "core/hash.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+// Only four byte texel formats are paged
+const uint32_t BytesPerTexel = 4;
+
+// Page table entries address cache slots with one byte per axis
+const uint32_t MaxCacheSlotsPerAxis = 256;
+
+VirtualTexture::VirtualTexture(const VirtualTextureDesc& desc, PageProvider provider)
+    : m_desc_(desc),
+      m_page_table_(desc.Width / desc.PageSize, desc.Height / desc.PageSize),
+      m_page_cache_(desc.CacheWidthInPages, desc.CacheHeightInPages),
+      m_page_loader_(provider, desc.LoaderThreads),
+      m_provider_(provider) {
+}
+
+bool VirtualTexture::Initialize(size_t name_hash, ID3D11Device* device, ID3D11DeviceContext* context) {
+  bool is_texel_size_supported = m_desc_.Format == DXGI_FORMAT_R8G8B8A8_UNORM || m_desc_.Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                              || m_desc_.Format == DXGI_FORMAT_B8G8R8A8_UNORM;
+  bool is_size_supported = m_desc_.PageSize > 0 && m_desc_.Width % m_desc_.PageSize == 0 && m_desc_.Height % m_desc_.PageSize == 0
+                        && m_desc_.Width / m_desc_.PageSize <= MaxPagesPerAxis && m_desc_.Height / m_desc_.PageSize <= MaxPagesPerAxis
+                        && m_page_table_.GetLevelCount() <= MaxLevels;
+  bool is_cache_supported = m_desc_.CacheWidthInPages > 0 && m_desc_.CacheHeightInPages > 0
+                         && m_desc_.CacheWidthInPages <= MaxCacheSlotsPerAxis && m_desc_.CacheHeightInPages <= MaxCacheSlotsPerAxis;
+  if (!is_texel_size_supported || !is_size_supported || !is_cache_supported) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Unsupported virtual texture description", nullptr);
+    return false;
+  }
+
+  size_t page_table_hash = name_hash;
+  hash_combine(page_table_hash, std::string("page_table"));
+  m_page_table_texture_ = Texture::CreateUpdatable(page_table_hash, DXGI_FORMAT_R8G8B8A8_UINT, m_page_table_.GetLevelWidth(0),
+                                                   m_page_table_.GetLevelHeight(0), m_page_table_.GetLevelCount(), device);
+
+  auto slot_size = m_desc_.PageSize + 2 * m_desc_.PageBorder;
+  size_t cache_hash = name_hash;
+  hash_combine(cache_hash, std::string("cache"));
+  m_cache_texture_ = Texture::CreateUpdatable(cache_hash, m_desc_.Format, m_desc_.CacheWidthInPages * slot_size,
+                                              m_desc_.CacheHeightInPages * slot_size, 1, device);
+
+  if (!m_page_table_texture_.IsValid() || !m_cache_texture_.IsValid()) {
+    return false;
+  }
+
+  PageId root;
+  root.Level = m_page_table_.GetLevelCount() - 1;
+
+  std::vector<uint8_t> texels;
+  if (!m_provider_(root, &texels) || !MakeResident(root, texels, context)) {
+    DXFW_TRACE(__FILE__, __LINE__, false, "Error loading the coarsest virtual texture page", nullptr);
+    return false;
+  }
+  m_page_cache_.Pin(root);
+
+  Update({}, context);
+  return true;
+}
+
+bool VirtualTexture::MakeResident(const PageId& page, const std::vector<uint8_t>& texels, ID3D11DeviceContext* context) {
+  auto slot_size = m_desc_.PageSize + 2 * m_desc_.PageBorder;
+  if (texels.size() != static_cast<size_t>(slot_size) * slot_size * BytesPerTexel) {
+    return false;
+  }
+
+  PageCache::Slot slot;
+  bool evicted;
+  PageId evicted_page;
+  if (!m_page_cache_.Allocate(page, m_frame_, &slot, &evicted, &evicted_page)) {
+    return false;
+  }
+
+  if (evicted) {
+    m_page_table_.Unmap(evicted_page);
+    m_statistics_.Evictions += 1;
+  }
+
+  D3D11_BOX box = { slot.X * slot_size, slot.Y * slot_size, 0, (slot.X + 1) * slot_size, (slot.Y + 1) * slot_size, 1 };
+  Texture::UpdateRegion(m_cache_texture_, 0, box, texels.data(), slot_size * BytesPerTexel, context);
+
+  m_page_table_.Map(page, slot.X, slot.Y);
+  m_statistics_.Uploads += 1;
+  return true;
+}
+
+void VirtualTexture::Update(const std::vector<uint32_t>& feedback, ID3D11DeviceContext* context) {
+  m_frame_ += 1;
+
+  ReduceFeedback(feedback, m_page_table_.GetLevelCount(), &m_requests_);
+
+  m_loads_.clear();
+  for (const auto& request : m_requests_) {
+    if (!m_page_table_.IsValid(request.Page)) {
+      continue;
+    }
+
+    m_statistics_.Requests += 1;
+    if (m_page_cache_.Touch(request.Page, m_frame_)) {
+      m_statistics_.Hits += 1;
+    } else {
+      m_loads_.push_back(request.Page);
+    }
+  }
+
+  m_page_loader_.Schedule(m_loads_);
+
+  m_loaded_pages_.clear();
+  m_page_loader_.Collect(m_desc_.UploadsPerFrame, &m_loaded_pages_);
+  for (const auto& loaded_page : m_loaded_pages_) {
+    PageCache::Slot slot;
+    if (m_page_cache_.Find(loaded_page.Page, &slot)) {
+      continue;
+    }
+
+    // Also fails once every slot holds a page this frame needs, the page is requested again next frame
+    if (!loaded_page.Ok || !MakeResident(loaded_page.Page, loaded_page.Texels, context)) {
+      m_statistics_.FailedLoads += 1;
+    }
+  }
+
+  uint32_t dirty_levels;
+  if (m_page_table_.Update(&dirty_levels)) {
+    for (uint32_t level = 0; level < dirty_levels; ++level) {
+      auto width = m_page_table_.GetLevelWidth(level);
+      auto height = m_page_table_.GetLevelHeight(level);
+      D3D11_BOX box = { 0, 0, 0, width, height, 1 };
+      Texture::UpdateRegion(m_page_table_texture_, level, box, m_page_table_.GetEntries(level).data(),
+                            width * static_cast<UINT>(sizeof(PageTableEntry)), context);
+    }
+  }
+}
+
+GpuVirtualTextureParameters VirtualTexture::GetShaderParameters() const {
+  auto slot_size = static_cast<float>(m_desc_.PageSize + 2 * m_desc_.PageBorder);
+
+  GpuVirtualTextureParameters parameters = {};
+  parameters.SizeInPages[0] = static_cast<float>(m_page_table_.GetLevelWidth(0));
+  parameters.SizeInPages[1] = static_cast<float>(m_page_table_.GetLevelHeight(0));
+  parameters.PageSize = static_cast<float>(m_desc_.PageSize);
+  parameters.PageBorder = static_cast<float>(m_desc_.PageBorder);
+  parameters.CacheSizeInTexels[0] = m_desc_.CacheWidthInPages * slot_size;
+  parameters.CacheSizeInTexels[1] = m_desc_.CacheHeightInPages * slot_size;
+  parameters.LevelCount = m_page_table_.GetLevelCount();
+  return parameters;
+}
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "core/memory_helpers.h"
+#include "rendering/texture.h"
+#include "rendering/virtual_texturing/feedback.h"
+#include "rendering/virtual_texturing/page_cache.h"
+#include "rendering/virtual_texturing/page_loader.h"
+#include "rendering/virtual_texturing/page_table.h"
+
+namespace Rendering {
+namespace VirtualTexturing {
+
+struct VirtualTextureDesc {
+  uint32_t Width = 0;  // Texels at level 0, a multiple of PageSize
+  uint32_t Height = 0;
+  uint32_t PageSize = 128;
+  uint32_t PageBorder = 4;  // Texels repeated around every page so filtering never reaches the neighbouring slot
+  DXGI_FORMAT Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+  uint32_t CacheWidthInPages = 32;
+  uint32_t CacheHeightInPages = 32;
+  uint32_t UploadsPerFrame = 16;
+  uint32_t LoaderThreads = 2;
+};
+
+// Matches VirtualTextureParameters in shaders/virtual_texture.h
+struct GpuVirtualTextureParameters {
+  float SizeInPages[2];
+  float PageSize;
+  float PageBorder;
+  float CacheSizeInTexels[2];
+  uint32_t LevelCount;
+  PAD(4);
+};
+
+static_assert(sizeof(GpuVirtualTextureParameters) == 32, "GpuVirtualTextureParameters must match the HLSL layout");
+
+struct Statistics {
+  uint64_t Requests = 0;
+  uint64_t Hits = 0;
+  uint64_t Uploads = 0;
+  uint64_t Evictions = 0;
+  uint64_t FailedLoads = 0;
+};
+
+// Sparse texture made of fixed size pages that are paged into a cache texture on demand. Pages are requested through
+// the feedback of the previous frames and looked up on the GPU through the page table texture.
+class VirtualTexture {
+ public:
+  VirtualTexture(const VirtualTextureDesc& desc, PageProvider provider);
+
+  ~VirtualTexture() = default;
+
+  VirtualTexture(const VirtualTexture&) = delete;
+  VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+  VirtualTexture(VirtualTexture&&) = delete;
+  VirtualTexture& operator=(VirtualTexture&&) = delete;
+
+  // Creates the page table and cache textures and makes the coarsest page resident for good, so every lookup
+  // finds something
+  bool Initialize(size_t name_hash, ID3D11Device* device, ID3D11DeviceContext* context);
+
+  // One frame of paging - reduces the feedback, schedules the missing pages, uploads finished pages into the cache
+  // and refreshes the page table levels that changed
+  void Update(const std::vector<uint32_t>& feedback, ID3D11DeviceContext* context);
+
+  Texture::Handle GetPageTable() const {
+    return m_page_table_texture_;
+  }
+
+  Texture::Handle GetCache() const {
+    return m_cache_texture_;
+  }
+
+  GpuVirtualTextureParameters GetShaderParameters() const;
+
+  const Statistics& GetStatistics() const {
+    return m_statistics_;
+  }
+
+ private:
+  bool MakeResident(const PageId& page, const std::vector<uint8_t>& texels, ID3D11DeviceContext* context);
+
+  VirtualTextureDesc m_desc_;
+  PageTable m_page_table_;
+  PageCache m_page_cache_;
+  PageLoader m_page_loader_;
+  PageProvider m_provider_;
+  Texture::Handle m_page_table_texture_ = {};
+  Texture::Handle m_cache_texture_ = {};
+  std::vector<PageRequest> m_requests_;
+  std::vector<PageId> m_loads_;
+  std::vector<LoadedPage> m_loaded_pages_;
+  uint64_t m_frame_ = 0;
+  Statistics m_statistics_;
+};
+
+}  // namespace VirtualTexturing
+}  // namespace Rendering
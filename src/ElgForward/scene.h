@@ -8,10 +8,16 @@
 #include "rendering/lens/perspective_lens.h"
 #include "rendering/cameras/trackball_camera.h"
 #include "rendering/lights/directional_light.h"
+#include "rendering/lights/gpu_lights.h"
+#include "rendering/lights/light_clustering.h"
+#include "rendering/lights/light_culling.h"
+#include "rendering/lights/light_spatial_hash.h"
 #include "rendering/lights/point_light.h"
 #include "rendering/lights/spot_light.h"
+#include "rendering/materials/basic.h"
 #include "rendering/camera_script.h"
 #include "rendering/drawable.h"
+#include "rendering/per_object.h"
 #include "rendering/typed_constant_buffer.h"
 #include "rendering/typed_structured_buffer.h"
 #include "rendering/texture.h"
@@ -21,6 +27,14 @@ struct PerFrame {
   int SpotLightCount = 0;
   int PointLightCount = 0;
   PAD(4);
+  uint32_t ClusterCountX = 0;
+  uint32_t ClusterCountY = 0;
+  uint32_t ClusterCountZ = 0;
+  float ClusterSliceScale = 0.0f;
+  float ClusterSliceBias = 0.0f;
+  float ClusterTileWidth = 0.0f;
+  float ClusterTileHeight = 0.0f;
+  PAD(4);
 };
 
 struct PerCamera {
@@ -31,13 +45,47 @@ struct PerCamera {
 
 struct Scene {
   std::vector<Rendering::Drawable> Drawables;
+  std::vector<uint32_t> VisibleDrawables;  // Indices of the drawables that passed culling this frame, in draw order
   Rendering::Lens::PerspectiveLens Lens;
   Rendering::Cameras::TrackballCamera Camera;
   Rendering::CameraScript CameraScript;
 
+  std::vector<Rendering::Lights::DirectionalLight> DirectionalLights;
+  std::vector<Rendering::Lights::SpotLight> SpotLights;
+  std::vector<Rendering::Lights::PointLight> PointLights;
+
   Rendering::ConstantBuffer::TypedHandle<PerFrame> PerFrameConstantBuffer;
   Rendering::ConstantBuffer::TypedHandle<PerCamera> PerCameraConstantBuffer;
   Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::DirectionalLight> DirectionalLightsStructuredBuffer;
-  Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::SpotLight> SpotLightsStructuredBuffer;
-  Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::PointLight> PointLightsStructuredBuffer;
+  Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::GpuSpotLight> SpotLightsStructuredBuffer;
+  Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::GpuPointLight> PointLightsStructuredBuffer;
+
+  Rendering::Lights::ClusterGrid LightClusterGrid;
+  Rendering::Lights::LightClusterBuilder LightClusterBuilder;
+  Rendering::StructuredBuffer::TypedHandle<Rendering::Lights::Cluster> ClustersStructuredBuffer;
+  Rendering::StructuredBuffer::TypedHandle<uint32_t> ClusterLightIndicesStructuredBuffer;
+
+  Rendering::StructuredBuffer::TypedHandle<Rendering::Materials::GpuBasic> BasicMaterialsStructuredBuffer;
+
+  // One entry for every visible drawable, a draw picks its entry with the index in the per draw constant buffer
+  Rendering::ConstantBuffer::TypedHandle<Rendering::PerDraw> PerDrawConstantBuffer;
+  Rendering::StructuredBuffer::TypedHandle<Rendering::PerObject> ObjectsStructuredBuffer;
+
+  Rendering::Lights::LightSpatialHash LightSpatialHash;
+  std::vector<uint32_t> PointLightGpuIndices;  // Scene light index to structured buffer index
+  std::vector<uint32_t> SpotLightGpuIndices;
+
+  // Light culling scratch, cleared every frame and only reallocated when the light counts grow
+  std::vector<Rendering::Lights::VisibleLight> VisibleLights;
+  std::vector<uint32_t> PointLightSourceIndices;  // Structured buffer index to scene light index
+  std::vector<uint32_t> SpotLightSourceIndices;
+  std::vector<DirectX::BoundingSphere> PointLightSpheres;  // View space bounds of the visible lights
+  std::vector<DirectX::BoundingSphere> SpotLightSpheres;
+
+  // Lights that passed culling but didn't fit the light buffers last frame, traced when they change
+  size_t DroppedPointLights = 0;
+  size_t DroppedSpotLights = 0;
+  size_t DroppedDirectionalLights = 0;
+  size_t DroppedClusterLights = 0;  // Light entries past MaxLightsPerCluster in full clusters
+  size_t DroppedDrawables = 0;  // Visible drawables past the end of the object buffer
 };
@@ -22,6 +22,14 @@ cbuffer PerFrameConstants : PER_FRAME_CONSTANT_BUFFER_REGISTER{
   int SpotLightCount;
   int PointLightCount;
   float pad;
+  uint ClusterCountX;
+  uint ClusterCountY;
+  uint ClusterCountZ;
+  float ClusterSliceScale;
+  float ClusterSliceBias;
+  float ClusterTileWidth;
+  float ClusterTileHeight;
+  float pad2;
 };
 
 cbuffer PerCamersConstants : PER_CAMERA_CONSTANT_BUFFER_REGISTER{
@@ -30,9 +38,24 @@ cbuffer PerCamersConstants : PER_CAMERA_CONSTANT_BUFFER_REGISTER{
   float4x4 ProjectionMatrix;
 }
 
-cbuffer PerObjectConstants : PER_OBJECT_CONSTANT_BUFFER_REGISTER{
+// Matches Rendering::PerObject, one entry for every drawable drawn this frame
+struct PerObject {
   float4x4 ModelMatrix;
   float4x4 ModelMatrixInverseTranspose;
+  uint PointLightCount;
+  uint SpotLightCount;
+  uint2 pad;
+  uint4 PointLightIndices[2];
+  uint4 SpotLightIndices[2];
+  uint MaterialIndex;
+  uint3 pad2;
+};
+
+StructuredBuffer<PerObject> Objects : OBJECT_BUFFER_REGISTER;
+
+cbuffer PerDrawConstants : PER_DRAW_CONSTANT_BUFFER_REGISTER{
+  uint ObjectIndex;
+  uint3 pad3;
 }
 
 #endif // ELGFORWARD_SHADERS_BASIC_H_
@@ -0,0 +1,40 @@
+#pragma pack_matrix(row_major)
+
+#include "registers.h"
+#include "basic.h"
+#include "lights.h"
+#include "basic_material.h"
+#include "clustered.h"
+
+float4 main(VertexShaderOutput input) : SV_TARGET {
+  float3 n = normalize(input.Normal);
+
+  float4 diffuse_color = GetMaterialDiffuseColor(input.TexCoord);
+
+  Cluster cluster = GetCluster(input.PositionClipSpace, input.PositionViewSpace.z);
+
+  float4 finalColor = float4(0.0, 0.0, 0.0, 0.0);
+  for (uint i = 0; i < cluster.PointLightCount; ++i) {
+    PointLight light = PointLights[ClusterLightIndices[cluster.Offset + i]];
+
+    float3 l = normalize(light.PositionViewSpace - input.PositionViewSpace.xyz);
+    float nDotL = dot(l, n);
+
+    finalColor += GetDiffuseColor(light) * diffuse_color * max(nDotL, 0);
+  }
+
+  uint spot_offset = cluster.Offset + cluster.PointLightCount;
+  for (uint j = 0; j < cluster.SpotLightCount; ++j) {
+    SpotLight light = SpotLights[ClusterLightIndices[spot_offset + j]];
+
+    float3 l = normalize(light.PositionViewSpace - input.PositionViewSpace.xyz);
+    float nDotL = dot(l, n);
+
+    float cone = GetSpotCone(light, l);
+
+    finalColor += GetDiffuseColor(light) * diffuse_color * max(nDotL, 0) * cone;
+  }
+
+  // Light colors carry no alpha, the material keeps its own for blended materials
+  return float4(finalColor.rgb, diffuse_color.a);
+}
@@ -0,0 +1,73 @@
+#ifndef ELGFORWARD_SHADERS_BASIC_MATERIAL_H_
+#define ELGFORWARD_SHADERS_BASIC_MATERIAL_H_
+
+#include "registers.h"
+
+#if defined(MATERIAL_TABLE) && MATERIAL_TABLE
+
+// Matches Rendering::Materials::GpuBasic, indexed with the MaterialIndex of the drawn object
+struct BasicMaterial {
+  float4 DiffuseColor;
+  float4 SpecularColor;
+  float SpecularPower;
+  uint HasDiffuseTexture;
+  uint DiffuseTextureLayer;
+  uint pad;
+  float4 DiffuseTextureUvScaleOffset;
+};
+
+StructuredBuffer<BasicMaterial> BasicMaterials : MATERIAL_BUFFER_REGISTER;
+
+#define MATERIAL_PARAMETER(name) BasicMaterials[Objects[ObjectIndex].MaterialIndex].name
+
+#else
+
+cbuffer PerMaterialConstants : PER_MATERIAL_CONSTANT_BUFFER_REGISTER {
+  float4 DiffuseColor;
+  float4 SpecularColor;
+  float SpecularPower;
+  bool HasDiffuseTexture;
+  uint DiffuseTextureLayer;
+  float4 DiffuseTextureUvScaleOffset;
+};
+
+#define MATERIAL_PARAMETER(name) name
+
+#endif
+
+SamplerState LinearSampler : LINEAR_SAMPLER_REGISTER;
+
+// Packed diffuse textures are either a slice of a texture array or a region of an atlas
+#if defined(DIFFUSE_TEXTURE_ARRAY) && DIFFUSE_TEXTURE_ARRAY
+Texture2DArray<float4> DiffuseTexture : DIFFUSE_TEXTURE_REGISTER;
+
+float4 SampleDiffuseTexture(float2 tex_coord) {
+  return DiffuseTexture.Sample(LinearSampler, float3(tex_coord, MATERIAL_PARAMETER(DiffuseTextureLayer)));
+}
+#else
+Texture2D<float4> DiffuseTexture : DIFFUSE_TEXTURE_REGISTER;
+
+// Atlas regions are clamped the way the sampler clamps a standalone texture. The gradients come from the unclamped
+// coordinates, so mip selection matches a standalone texture too. Regions hold at most 4 mip levels.
+float4 SampleDiffuseTexture(float2 tex_coord) {
+  float4 scale_offset = MATERIAL_PARAMETER(DiffuseTextureUvScaleOffset);
+  float2 atlas_coord = saturate(tex_coord) * scale_offset.xy + scale_offset.zw;
+  return DiffuseTexture.SampleGrad(LinearSampler, atlas_coord, ddx(tex_coord) * scale_offset.xy, ddy(tex_coord) * scale_offset.xy);
+}
+#endif
+
+// HAS_DIFFUSE_TEXTURE is set by the shader permutations, offline builds without it fall back to a dynamic branch
+float4 GetMaterialDiffuseColor(float2 tex_coord) {
+#if !defined(HAS_DIFFUSE_TEXTURE)
+  if (MATERIAL_PARAMETER(HasDiffuseTexture)) {
+    return SampleDiffuseTexture(tex_coord);
+  }
+  return MATERIAL_PARAMETER(DiffuseColor);
+#elif HAS_DIFFUSE_TEXTURE
+  return SampleDiffuseTexture(tex_coord);
+#else
+  return MATERIAL_PARAMETER(DiffuseColor);
+#endif
+}
+
+#endif  // ELGFORWARD_SHADERS_BASIC_MATERIAL_H_
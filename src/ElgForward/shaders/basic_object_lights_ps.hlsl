@@ -0,0 +1,38 @@
+#pragma pack_matrix(row_major)
+
+#include "registers.h"
+#include "basic.h"
+#include "lights.h"
+#include "basic_material.h"
+
+float4 main(VertexShaderOutput input) : SV_TARGET {
+  float3 n = normalize(input.Normal);
+
+  float4 diffuse_color = GetMaterialDiffuseColor(input.TexCoord);
+
+  PerObject object = Objects[ObjectIndex];
+
+  float4 finalColor = float4(0.0, 0.0, 0.0, 0.0);
+  for (uint i = 0; i < object.PointLightCount; ++i) {
+    PointLight light = PointLights[object.PointLightIndices[i / 4][i % 4]];
+
+    float3 l = normalize(light.PositionViewSpace - input.PositionViewSpace.xyz);
+    float nDotL = dot(l, n);
+
+    finalColor += GetDiffuseColor(light) * diffuse_color * max(nDotL, 0);
+  }
+
+  for (uint j = 0; j < object.SpotLightCount; ++j) {
+    SpotLight light = SpotLights[object.SpotLightIndices[j / 4][j % 4]];
+
+    float3 l = normalize(light.PositionViewSpace - input.PositionViewSpace.xyz);
+    float nDotL = dot(l, n);
+
+    float cone = GetSpotCone(light, l);
+
+    finalColor += GetDiffuseColor(light) * diffuse_color * max(nDotL, 0) * cone;
+  }
+
+  // Light colors carry no alpha, the material keeps its own for blended materials
+  return float4(finalColor.rgb, diffuse_color.a);
+}
@@ -6,9 +6,11 @@
 VertexShaderOutput main(VertexShaderInput input) {
   VertexShaderOutput output;
 
-  float4x4 modelViewMatrix = mul(ModelMatrix, ViewMatrix);
+  PerObject object = Objects[ObjectIndex];
+
+  float4x4 modelViewMatrix = mul(object.ModelMatrix, ViewMatrix);
   float4x4 modelViewProjectionMatrix = mul(modelViewMatrix, ProjectionMatrix);
-  float4x4 modelViewMatrixInverseTranspose = mul(ModelMatrixInverseTranspose, ViewMatrixInverseTranspose);
+  float4x4 modelViewMatrixInverseTranspose = mul(object.ModelMatrixInverseTranspose, ViewMatrixInverseTranspose);
 
   float4 positionMs = float4(input.PositionMs, 1.0);
   output.PositionClipSpace = mul(positionMs, modelViewProjectionMatrix);
@@ -0,0 +1,24 @@
+#ifndef ELGFORWARD_SHADERS_CLUSTERED_H_
+#define ELGFORWARD_SHADERS_CLUSTERED_H_
+
+#include "registers.h"
+#include "basic.h"
+
+struct Cluster {
+  uint Offset;
+  uint PointLightCount;
+  uint SpotLightCount;
+  uint Padding;
+};
+
+StructuredBuffer<Cluster> Clusters : CLUSTER_BUFFER_REGISTER;
+StructuredBuffer<uint> ClusterLightIndices : CLUSTER_LIGHT_INDEX_BUFFER_REGISTER;
+
+Cluster GetCluster(float4 position_screen_space, float view_space_depth) {
+  uint slice = (uint)clamp(floor(log(view_space_depth) * ClusterSliceScale + ClusterSliceBias), 0.0, ClusterCountZ - 1.0);
+  uint x = min((uint)(position_screen_space.x / ClusterTileWidth), ClusterCountX - 1);
+  uint y = min((uint)(position_screen_space.y / ClusterTileHeight), ClusterCountY - 1);
+  return Clusters[(slice * ClusterCountY + y) * ClusterCountX + x];
+}
+
+#endif // ELGFORWARD_SHADERS_CLUSTERED_H_
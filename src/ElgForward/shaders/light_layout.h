@@ -0,0 +1,20 @@
+#ifndef ELGFORWARD_SHADERS_LIGHT_LAYOUT_H_
+#define ELGFORWARD_SHADERS_LIGHT_LAYOUT_H_
+
+// Byte layout of the packed lights - checked against the C++ side in rendering/lights/gpu_lights.h and against the
+// HLSL side in shaders/lights.h
+
+#define GPU_POINT_LIGHT_SIZE 32
+#define GPU_POINT_LIGHT_POSITION_OFFSET 0
+#define GPU_POINT_LIGHT_RANGE_OFFSET 12
+#define GPU_POINT_LIGHT_DIFFUSE_COLOR_OFFSET 16
+#define GPU_POINT_LIGHT_SPECULAR_COLOR_OFFSET 20
+
+#define GPU_SPOT_LIGHT_SIZE 32
+#define GPU_SPOT_LIGHT_POSITION_OFFSET 0
+#define GPU_SPOT_LIGHT_RANGE_OFFSET 12
+#define GPU_SPOT_LIGHT_DIRECTION_OFFSET 16
+#define GPU_SPOT_LIGHT_DIFFUSE_COLOR_OFFSET 24
+#define GPU_SPOT_LIGHT_SPECULAR_COLOR_OFFSET 28
+
+#endif  // ELGFORWARD_SHADERS_LIGHT_LAYOUT_H_
@@ -0,0 +1,74 @@
+#ifndef ELGFORWARD_SHADERS_LIGHTS_H_
+#define ELGFORWARD_SHADERS_LIGHTS_H_
+
+#include "registers.h"
+#include "light_layout.h"
+
+// Structured buffer members are packed tightly in declaration order, so the offsets in light_layout.h have to
+// follow the member sizes below. The checks fail the shader build when the two drift apart.
+#if GPU_POINT_LIGHT_POSITION_OFFSET != 0 || \
+    GPU_POINT_LIGHT_RANGE_OFFSET != GPU_POINT_LIGHT_POSITION_OFFSET + 12 || \
+    GPU_POINT_LIGHT_DIFFUSE_COLOR_OFFSET != GPU_POINT_LIGHT_RANGE_OFFSET + 4 || \
+    GPU_POINT_LIGHT_SPECULAR_COLOR_OFFSET != GPU_POINT_LIGHT_DIFFUSE_COLOR_OFFSET + 4 || \
+    GPU_POINT_LIGHT_SIZE <= GPU_POINT_LIGHT_SPECULAR_COLOR_OFFSET + 4 || \
+    GPU_POINT_LIGHT_SIZE % 4 != 0
+#error PointLight does not match light_layout.h
+#endif
+
+#if GPU_SPOT_LIGHT_POSITION_OFFSET != 0 || \
+    GPU_SPOT_LIGHT_RANGE_OFFSET != GPU_SPOT_LIGHT_POSITION_OFFSET + 12 || \
+    GPU_SPOT_LIGHT_DIRECTION_OFFSET != GPU_SPOT_LIGHT_RANGE_OFFSET + 4 || \
+    GPU_SPOT_LIGHT_DIFFUSE_COLOR_OFFSET != GPU_SPOT_LIGHT_DIRECTION_OFFSET + 8 || \
+    GPU_SPOT_LIGHT_SPECULAR_COLOR_OFFSET != GPU_SPOT_LIGHT_DIFFUSE_COLOR_OFFSET + 4 || \
+    GPU_SPOT_LIGHT_SIZE != GPU_SPOT_LIGHT_SPECULAR_COLOR_OFFSET + 4
+#error SpotLight does not match light_layout.h
+#endif
+
+// Colors are R11G11B10 floats with the intensity folded in
+struct PointLight {
+  float3 PositionViewSpace;
+  float Range;
+  uint DiffuseColor;
+  uint SpecularColor;
+  uint pad[(GPU_POINT_LIGHT_SIZE - GPU_POINT_LIGHT_SPECULAR_COLOR_OFFSET - 4) / 4];
+};
+
+// DirectionAndCosAngle holds four halfs - view space direction and the cosine of the spotlight angle
+struct SpotLight {
+  float3 PositionViewSpace;
+  float Range;
+  uint2 DirectionAndCosAngle;
+  uint DiffuseColor;
+  uint SpecularColor;
+};
+
+StructuredBuffer<PointLight> PointLights : POINT_LIGHT_BUFFER_REGISTER;
+StructuredBuffer<SpotLight> SpotLights : SPOT_LIGHT_BUFFER_REGISTER;
+
+float3 UnpackR11G11B10Float(uint packed) {
+  // Both formats share the half float exponent so shifting the bits in place is enough
+  uint r = (packed << 4) & 0x7FF0;
+  uint g = (packed >> 7) & 0x7FF0;
+  uint b = (packed >> 17) & 0x7FE0;
+  return f16tof32(uint3(r, g, b));
+}
+
+float4 UnpackHalf4(uint2 packed) {
+  return f16tof32(uint4(packed.x, packed.x >> 16, packed.y, packed.y >> 16));
+}
+
+float4 GetDiffuseColor(PointLight light) {
+  return float4(UnpackR11G11B10Float(light.DiffuseColor), 0.0);
+}
+
+float4 GetDiffuseColor(SpotLight light) {
+  return float4(UnpackR11G11B10Float(light.DiffuseColor), 0.0);
+}
+
+float GetSpotCone(SpotLight light, float3 l) {
+  float4 direction_and_cos_angle = UnpackHalf4(light.DirectionAndCosAngle);
+  float cos_angle = dot(-l, normalize(direction_and_cos_angle.xyz));
+  return step(direction_and_cos_angle.w, cos_angle);
+}
+
+#endif  // ELGFORWARD_SHADERS_LIGHTS_H_
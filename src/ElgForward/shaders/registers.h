@@ -9,7 +9,7 @@
 
 #define PER_FRAME_CONSTANT_BUFFER_REGISTER CONSTANT_BUFFER_REGISTER(0)
 #define PER_CAMERA_CONSTANT_BUFFER_REGISTER CONSTANT_BUFFER_REGISTER(1)
-#define PER_OBJECT_CONSTANT_BUFFER_REGISTER CONSTANT_BUFFER_REGISTER(2)
+#define PER_DRAW_CONSTANT_BUFFER_REGISTER CONSTANT_BUFFER_REGISTER(2)
 #define PER_MATERIAL_CONSTANT_BUFFER_REGISTER CONSTANT_BUFFER_REGISTER(3)
 
 #ifdef __cplusplus
@@ -24,6 +24,13 @@
 
 #define DIFFUSE_TEXTURE_REGISTER TEXTURE_REGISTER(3)
 
+#define CLUSTER_BUFFER_REGISTER TEXTURE_REGISTER(4)
+#define CLUSTER_LIGHT_INDEX_BUFFER_REGISTER TEXTURE_REGISTER(5)
+
+#define MATERIAL_BUFFER_REGISTER TEXTURE_REGISTER(6)
+
+#define OBJECT_BUFFER_REGISTER TEXTURE_REGISTER(7)
+
 #ifdef __cplusplus
 #define SAMPLER_REGISTER(num) num
 #else
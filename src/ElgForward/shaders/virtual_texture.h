@@ -0,0 +1,49 @@
+#ifndef ELGFORWARD_SHADERS_VIRTUAL_TEXTURE_H_
+#define ELGFORWARD_SHADERS_VIRTUAL_TEXTURE_H_
+
+// Matches Rendering::VirtualTexturing::GpuVirtualTextureParameters
+struct VirtualTextureParameters {
+  float2 SizeInPages;
+  float PageSize;
+  float PageBorder;
+  float2 CacheSizeInTexels;
+  uint LevelCount;
+  uint pad;
+};
+
+// Matches Rendering::VirtualTexturing::PackPageId, written to the feedback target and read back by the CPU
+uint PackPageId(uint level, uint2 page) {
+  return (level << 28) | (page.y << 14) | page.x;
+}
+
+// Page table texels are (cache x, cache y, resident level, valid), unmapped pages already hold their closest
+// resident ancestor so a single load finds the page to sample
+float4 SampleVirtualTexture(Texture2D<uint4> page_table, Texture2D<float4> cache, SamplerState cache_sampler,
+                            VirtualTextureParameters parameters, float2 uv, out uint feedback) {
+  float2 size_in_texels = parameters.SizeInPages * parameters.PageSize;
+  float2 uv_dx = ddx(uv);
+  float2 uv_dy = ddy(uv);
+
+  float2 texel_dx = uv_dx * size_in_texels;
+  float2 texel_dy = uv_dy * size_in_texels;
+  float lod = 0.5f * log2(max(dot(texel_dx, texel_dx), dot(texel_dy, texel_dy)));
+  uint level = (uint)clamp(floor(lod), 0.0f, (float)(parameters.LevelCount - 1));
+
+  float2 level_size_in_pages = max(floor(parameters.SizeInPages / exp2(level)), 1.0f);
+  uint2 page = (uint2)clamp(floor(frac(uv) * level_size_in_pages), 0.0f, level_size_in_pages - 1.0f);
+  feedback = PackPageId(level, page);
+
+  uint4 entry = page_table.Load(int3(page, level));
+  float level_scale = exp2(-(float)entry.z);
+
+  float2 level_texel = frac(uv) * size_in_texels * level_scale;
+  float2 in_page = level_texel - floor(level_texel / parameters.PageSize) * parameters.PageSize;
+
+  float slot_size = parameters.PageSize + 2.0f * parameters.PageBorder;
+  float2 cache_uv = (entry.xy * slot_size + parameters.PageBorder + in_page) / parameters.CacheSizeInTexels;
+  float2 gradient_scale = size_in_texels * level_scale / parameters.CacheSizeInTexels;
+
+  return cache.SampleGrad(cache_sampler, cache_uv, uv_dx * gradient_scale, uv_dy * gradient_scale);
+}
+
+#endif  // ELGFORWARD_SHADERS_VIRTUAL_TEXTURE_H_
@@ -0,0 +1,46 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "pack_writer.h"
+
+// ElgPack <root> <output.pack> [<file or directory> ...] packs the listed files, or everything under the root when
+// none are given. Directories are packed recursively.
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: ElgPack <root> <output.pack> [<file or directory> ...]" << std::endl;
+    return -1;
+  }
+
+  filesystem::path root_path(argv[1]);
+  filesystem::path output_path(argv[2]);
+
+  std::vector<filesystem::path> inputs;
+  for (int i = 3; i < argc; ++i) {
+    inputs.emplace_back(argv[i]);
+  }
+  if (inputs.empty()) {
+    inputs.emplace_back(root_path);
+  }
+
+  std::vector<filesystem::path> source_paths;
+  for (const auto& input : inputs) {
+    std::error_code error;
+    if (filesystem::is_directory(input, error)) {
+      for (const auto& directory_entry : filesystem::recursive_directory_iterator(input)) {
+        // The archive may be written inside the directory being packed
+        if (directory_entry.is_regular_file() && !filesystem::equivalent(directory_entry.path(), output_path, error)) {
+          source_paths.emplace_back(directory_entry.path());
+        }
+      }
+    } else if (filesystem::is_regular_file(input, error)) {
+      source_paths.emplace_back(input);
+    } else {
+      std::cerr << "Input " << input.string() << " not found" << std::endl;
+      return -1;
+    }
+  }
+
+  return Pack::WritePackArchive(source_paths, root_path, output_path) ? 0 : -1;
+}
@@ -0,0 +1,202 @@
+#include "pack_writer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include <lz4.h>
+#include <lz4hc.h>
+
+#include "core/pack_file.h"
+
+namespace Pack {
+
+struct PackedFile {
+  filesystem::path SourcePath;
+  filesystem::path RelativePath;
+  uint64_t PathHash = 0;
+  uint64_t Size = 0;
+  std::vector<uint32_t> Blocks;  // Stored size of each block, empty when the file is stored as is
+  std::vector<uint8_t> Blob;
+};
+
+bool ReadFile(const filesystem::path& path, std::vector<uint8_t>* data) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return false;
+  }
+
+  data->resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(data->data()), static_cast<std::streamsize>(data->size()));
+  return static_cast<bool>(file);
+}
+
+// Blocks that don't shrink are kept as they are, files that don't shrink at all skip compression
+bool CompressFile(PackedFile* file) {
+  std::vector<uint8_t> source;
+  if (!ReadFile(file->SourcePath, &source)) {
+    return false;
+  }
+
+  file->Size = source.size();
+
+  auto block_count = Core::PackFile::GetBlockCount(source.size(), Core::PackFile::BlockSize);
+  std::vector<char> compressed(static_cast<size_t>(LZ4_compressBound(static_cast<int>(Core::PackFile::BlockSize))));
+
+  for (uint64_t i = 0; i < block_count; ++i) {
+    auto block_begin = source.data() + static_cast<size_t>(i * Core::PackFile::BlockSize);
+    auto block_size = static_cast<int>(std::min<uint64_t>(Core::PackFile::BlockSize, source.size() - i * Core::PackFile::BlockSize));
+
+    auto compressed_size = LZ4_compress_HC(reinterpret_cast<const char*>(block_begin), compressed.data(), block_size,
+                                           static_cast<int>(compressed.size()), LZ4HC_CLEVEL_MAX);
+    if (compressed_size > 0 && compressed_size < block_size) {
+      file->Blob.insert(std::end(file->Blob), compressed.data(), compressed.data() + compressed_size);
+      file->Blocks.emplace_back(static_cast<uint32_t>(compressed_size));
+    } else {
+      file->Blob.insert(std::end(file->Blob), block_begin, block_begin + block_size);
+      file->Blocks.emplace_back(static_cast<uint32_t>(block_size));
+    }
+  }
+
+  if (file->Blob.size() >= source.size()) {
+    file->Blob = std::move(source);
+    file->Blocks.clear();
+  }
+
+  return true;
+}
+
+uint64_t Align(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+template<typename T>
+void Write(std::ofstream& stream, const T* values, size_t count) {
+  stream.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+void WritePadding(std::ofstream& stream, uint64_t offset) {
+  static const char zeros[Core::PackFile::BlobAlignment] = {};
+  auto position = static_cast<uint64_t>(stream.tellp());
+  stream.write(zeros, static_cast<std::streamsize>(offset - position));
+}
+
+bool WritePackArchive(const std::vector<filesystem::path>& source_paths, const filesystem::path& root_path,
+                      const filesystem::path& output_path) {
+  std::vector<PackedFile> files;
+  for (const auto& source_path : source_paths) {
+    PackedFile file;
+    file.SourcePath = source_path;
+    if (!Core::PackFile::GetRelativePath(source_path, root_path, &file.RelativePath)) {
+      std::cerr << "Skipping " << source_path.string() << ", it is outside of " << root_path.string() << std::endl;
+      continue;
+    }
+
+    file.PathHash = Core::PackFile::HashPath(file.RelativePath);
+    files.emplace_back(std::move(file));
+  }
+
+  std::sort(std::begin(files), std::end(files), [](const auto& lhs, const auto& rhs) {
+    return lhs.PathHash < rhs.PathHash;
+  });
+
+  // The directory only keeps hashes, two paths sharing one would make a file unreachable
+  for (size_t i = 1; i < files.size(); ++i) {
+    if (files[i].PathHash == files[i - 1].PathHash) {
+      std::cerr << "Path hash collision between " << files[i - 1].RelativePath.string() << " and " << files[i].RelativePath.string() << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<uint8_t> files_ok(files.size(), 0);
+  auto worker_count = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), static_cast<uint32_t>(files.size()));
+
+  auto run_worker = [&](uint32_t worker_index) {
+    for (size_t i = worker_index; i < files.size(); i += worker_count) {
+      files_ok[i] = CompressFile(&files[i]) ? 1 : 0;
+    }
+  };
+
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 1; i < worker_count; ++i) {
+    futures.emplace_back(std::async(std::launch::async, run_worker, i));
+  }
+
+  if (worker_count > 0) {
+    run_worker(0);
+  }
+
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!files_ok[i]) {
+      std::cerr << "Error reading " << files[i].SourcePath.string() << std::endl;
+      return false;
+    }
+  }
+
+  // Header, directory and block table first, then every blob on its own aligned offset
+  std::vector<Core::PackFile::Entry> entries(files.size());
+  std::vector<uint32_t> blocks;
+
+  Core::PackFile::Header header = {};
+  header.Magic = Core::PackFile::Magic;
+  header.Version = Core::PackFile::Version;
+  header.BlockSize = Core::PackFile::BlockSize;
+  header.Entries.Offset = Align(sizeof(Core::PackFile::Header), alignof(Core::PackFile::Entry));
+  header.Entries.Count = entries.size();
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    auto& entry = entries[i];
+    entry.PathHash = files[i].PathHash;
+    entry.StoredSize = files[i].Blob.size();
+    entry.Size = files[i].Size;
+    entry.FirstBlock = static_cast<uint32_t>(blocks.size());
+    entry.CompressionType = files[i].Blocks.empty() ? Core::PackFile::Compression::None : Core::PackFile::Compression::Lz4;
+    blocks.insert(std::end(blocks), std::begin(files[i].Blocks), std::end(files[i].Blocks));
+  }
+
+  header.Blocks.Offset = Align(header.Entries.Offset + sizeof(Core::PackFile::Entry) * entries.size(), alignof(uint32_t));
+  header.Blocks.Count = blocks.size();
+
+  auto offset = header.Blocks.Offset + sizeof(uint32_t) * blocks.size();
+  for (auto& entry : entries) {
+    entry.Offset = Align(offset, Core::PackFile::BlobAlignment);
+    offset = entry.Offset + entry.StoredSize;
+  }
+  header.FileSize = offset;
+
+  std::ofstream stream(output_path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    std::cerr << "Error creating " << output_path.string() << std::endl;
+    return false;
+  }
+
+  Write(stream, &header, 1);
+  WritePadding(stream, header.Entries.Offset);
+  Write(stream, entries.data(), entries.size());
+  WritePadding(stream, header.Blocks.Offset);
+  Write(stream, blocks.data(), blocks.size());
+
+  uint64_t source_bytes = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    WritePadding(stream, entries[i].Offset);
+    Write(stream, files[i].Blob.data(), files[i].Blob.size());
+    source_bytes += files[i].Size;
+  }
+
+  if (!stream) {
+    std::cerr << "Error writing " << output_path.string() << std::endl;
+    return false;
+  }
+
+  std::cout << "Packed " << files.size() << " files, " << source_bytes << " bytes into " << header.FileSize << " bytes" << std::endl;
+  return true;
+}
+
+}  // namespace Pack
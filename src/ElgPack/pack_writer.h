@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+#include "core/filesystem.h"
+
+namespace Pack {
+
+// Files are stored under their path relative to the root, which is how the engine looks them up once the archive is
+// mounted with the same root
+bool WritePackArchive(const std::vector<filesystem::path>& source_paths, const filesystem::path& root_path,
+                      const filesystem::path& output_path);
+
+}  // namespace Pack
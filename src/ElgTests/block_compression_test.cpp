@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "rendering/block_compression.h"
+#include "test_helpers.h"
+
+using namespace Rendering;
+
+struct TestImage {
+  uint32_t Width;
+  uint32_t Height;
+  std::vector<uint8_t> Data;
+
+  Texture::ImageData GetImageData() const {
+    return Texture::ImageData(Width, Height, 4, DXGI_FORMAT_R8G8B8A8_UNORM, Data.data());
+  }
+};
+
+// Smooth gradients with a little noise and a few hard edges, closer to real textures than pure noise
+TestImage MakeTestImage(uint32_t width, uint32_t height, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::uniform_int_distribution<int> noise_distribution(-6, 6);
+
+  TestImage image = { width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4) };
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      auto u = static_cast<float>(x) / width;
+      auto v = static_cast<float>(y) / height;
+      bool is_stripe = ((x / 37) + (y / 53)) % 5 == 0;
+
+      int channels[4] = {
+        static_cast<int>(255.0f * u),
+        static_cast<int>(255.0f * v),
+        static_cast<int>(127.5f + 127.5f * std::sin(10.0f * (u + v))),
+        is_stripe ? 32 : 224,
+      };
+
+      auto pixel = image.Data.data() + (static_cast<size_t>(y) * width + x) * 4;
+      for (int c = 0; c < 4; ++c) {
+        pixel[c] = static_cast<uint8_t>(std::min(std::max(channels[c] + noise_distribution(random), 0), 255));
+      }
+    }
+  }
+  return image;
+}
+
+TestImage MakeFlatImage(uint32_t width, uint32_t height, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  TestImage image = { width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4) };
+  for (size_t i = 0; i < image.Data.size(); i += 4) {
+    image.Data[i + 0] = r;
+    image.Data[i + 1] = g;
+    image.Data[i + 2] = b;
+    image.Data[i + 3] = a;
+  }
+  return image;
+}
+
+const DXGI_FORMAT Formats[] = { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC4_UNORM, DXGI_FORMAT_BC5_UNORM };
+
+const char* GetFormatName(DXGI_FORMAT format) {
+  switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+      return "BC1";
+    case DXGI_FORMAT_BC3_UNORM:
+      return "BC3";
+    case DXGI_FORMAT_BC4_UNORM:
+      return "BC4";
+    case DXGI_FORMAT_BC5_UNORM:
+      return "BC5";
+    default:
+      return "?";
+  }
+}
+
+void TestEncodedSize() {
+  auto image = MakeTestImage(64, 36, 1);
+  for (auto format : Formats) {
+    std::vector<uint8_t> encoded;
+    CHECK(BlockCompression::Encode(image.GetImageData(), format, &encoded));
+    CHECK(encoded.size() == BlockCompression::GetEncodedSize(format, 64, 36));
+    CHECK(encoded.size() == 16 * 9 * BlockCompression::GetBlockSize(format));
+  }
+}
+
+// Blocks of a single value are stored without error, as long as the 565 endpoints can hold the color
+void TestFlatImageIsExact() {
+  auto image = MakeFlatImage(32, 32, 0, 130, 255, 77);
+  for (auto format : Formats) {
+    std::vector<uint8_t> encoded;
+    CHECK(BlockCompression::Encode(image.GetImageData(), format, &encoded));
+    CHECK(std::isinf(BlockCompression::ComputePsnr(image.GetImageData(), format, encoded)));
+  }
+}
+
+void TestQualityOfSmoothImage() {
+  auto image = MakeTestImage(256, 256, 2);
+  for (auto format : Formats) {
+    std::vector<uint8_t> encoded;
+    CHECK(BlockCompression::Encode(image.GetImageData(), format, &encoded));
+
+    // Single channel formats have eight levels per block and should do much better than the 565 colors
+    auto psnr = BlockCompression::ComputePsnr(image.GetImageData(), format, encoded);
+    auto min_psnr = (format == DXGI_FORMAT_BC4_UNORM || format == DXGI_FORMAT_BC5_UNORM) ? 36.0 : 30.0;
+    CHECK(psnr > min_psnr);
+  }
+}
+
+// Sizes that are not a multiple of four encode partial edge blocks
+void TestUnalignedSize() {
+  auto image = MakeTestImage(254, 251, 3);
+  std::vector<uint8_t> encoded;
+  CHECK(BlockCompression::Encode(image.GetImageData(), DXGI_FORMAT_BC1_UNORM, &encoded));
+  CHECK(encoded.size() == 8 * 64 * 63);
+  CHECK(BlockCompression::ComputePsnr(image.GetImageData(), DXGI_FORMAT_BC1_UNORM, encoded) > 30.0);
+}
+
+void TestInvalidInputIsRejected() {
+  auto image = MakeTestImage(16, 16, 4);
+  std::vector<uint8_t> encoded;
+  CHECK(!BlockCompression::Encode(image.GetImageData(), DXGI_FORMAT_R8G8B8A8_UNORM, &encoded));
+
+  Texture::ImageData single_channel(16, 16, 1, DXGI_FORMAT_R8_UNORM, image.Data.data());
+  CHECK(!BlockCompression::Encode(single_channel, DXGI_FORMAT_BC1_UNORM, &encoded));
+  CHECK(!BlockCompression::Encode(single_channel, DXGI_FORMAT_BC5_UNORM, &encoded));
+}
+
+void BenchmarkEncode() {
+  std::printf("%8s %12s %12s %12s %10s\n", "format", "size", "ms", "Mpixel/s", "PSNR dB");
+  for (uint32_t size : { 256, 1024, 4096 }) {
+    auto image = MakeTestImage(size, size, size);
+    for (auto format : Formats) {
+      std::vector<uint8_t> encoded;
+      auto repetitions = size >= 4096 ? 3 : 10;
+      auto milliseconds = Tests::TimeMilliseconds(repetitions, [&]() {
+        BlockCompression::Encode(image.GetImageData(), format, &encoded);
+      });
+
+      auto megapixels_per_second = static_cast<double>(size) * size / (milliseconds * 1000.0);
+      auto psnr = BlockCompression::ComputePsnr(image.GetImageData(), format, encoded);
+      std::printf("%8s %7ux%-4u %12.3f %12.1f %10.2f\n", GetFormatName(format), size, size, milliseconds, megapixels_per_second, psnr);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  TestEncodedSize();
+  TestFlatImageIsExact();
+  TestQualityOfSmoothImage();
+  TestUnalignedSize();
+  TestInvalidInputIsRejected();
+
+  if (Tests::IsBenchmarkRun(argc, argv)) {
+    BenchmarkEncode();
+  }
+
+  return Tests::Finish("BlockCompressionTest");
+}
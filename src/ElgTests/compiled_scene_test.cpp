@@ -0,0 +1,165 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "core/mapped_file.h"
+#include "loaders/compiled_scene.h"
+#include "loaders/scene_compiler.h"
+#include "loaders/scene_file.h"
+#include "loaders/transform_loader.h"
+#include "rendering/transform_and_inverse_transpose.h"
+#include "test_helpers.h"
+
+using namespace Loaders;
+
+void WriteFile(const filesystem::path& path, const std::string& text) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+std::string ReadFile(const filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+const char* SceneText =
+  "{ \"meshes\": [], \"materials\": [], \"lights\": \"lights.json\", \"scene\": [\n"
+  "{ \"name\": \"first\", \"mesh_name\": \"cube cube\", \"material_name\": \"basic1\", "
+  "\"transform\": { \"translation\": [1.0, 2.0, 3.0], \"rotation\": [0.0, 1.0, 0.0, 0.5], \"scale\": [0.5, 0.5, 0.5] } },\n"
+  "{ \"name\": \"second\", \"mesh_name\": \"cube cube\", \"material_name\": \"basic2\", "
+  "\"transform\": { \"translation\": [-4.0, 0.0, 8.0], \"rotation\": [1.0, 0.0, 0.0, 1.5], \"scale\": [2.0, 2.0, 2.0] } },\n"
+  "{ \"name\": \"third\", \"mesh_name\": \"sphere\", \"material_name\": \"basic1\" }\n"
+  "] }\n";
+
+std::string MakeLights(float range) {
+  std::string lights = "{ \"lights\": [\n";
+  lights += "{ \"type\": \"directional\", \"direction\": [0.0, -1.0, 0.0], \"diffuse\": [1.0, 1.0, 1.0, 1.0], "
+            "\"specular\": [1.0, 1.0, 1.0, 1.0], \"intensity\": 1.0, \"enabled\": true },\n";
+  for (int i = 0; i < 3; ++i) {
+    lights += "{ \"type\": \"point\", \"position\": [" + std::to_string(i * 5) + ".0, 0.0, 0.0], "
+              "\"diffuse\": [0.8, 0.8, 0.8, 1.0], \"specular\": [0.8, 0.8, 0.8, 1.0], \"range\": " + std::to_string(range) +
+              ", \"intensity\": 1.0, \"enabled\": true }" + (i < 2 ? ",\n" : "\n");
+  }
+  lights += "] }\n";
+  return lights;
+}
+
+std::string GetString(const uint8_t* data, size_t size, const CompiledScene::Header& header, uint32_t index) {
+  auto entries = CompiledScene::GetSection<CompiledScene::StringEntry>(data, size, header.Strings);
+  auto string_data = CompiledScene::GetSection<char>(data, size, header.StringData);
+  if (entries == nullptr || string_data == nullptr || index >= header.Strings.Count) {
+    return std::string();
+  }
+
+  const auto& entry = entries[index];
+  if (static_cast<uint64_t>(entry.Offset) + entry.Length > header.StringData.Count) {
+    return std::string();
+  }
+  return std::string(string_data + entry.Offset, entry.Length);
+}
+
+// Content hash of a source file, computed the same way the loader checks it
+bool IsSourceCurrent(const filesystem::path& path, const CompiledScene::SourceRecord& source) {
+  auto contents = ReadFile(path);
+  return contents.size() == source.Size
+      && CompiledScene::HashContents(reinterpret_cast<const uint8_t*>(contents.data()), contents.size()) == source.ContentHash;
+}
+
+// Compiles a scene with a lights file and reads the result back the way LoadCompiledScene maps it, without a device
+void TestCompiledSceneMatchesSources(const filesystem::path& directory) {
+  auto scene_path = directory / "scene.json";
+  auto lights_path = directory / "lights.json";
+  auto output_path = directory / "scene.elgscene";
+  WriteFile(scene_path, SceneText);
+  WriteFile(lights_path, MakeLights(10.0f));
+
+  CHECK(CompileScene(scene_path, directory, output_path));
+
+  nlohmann::json json_scene;
+  std::vector<DrawableDescription> drawables;
+  CHECK(ReadSceneFile(scene_path, &json_scene, &drawables));
+  CHECK(drawables.size() == 3);
+
+  Core::MappedFile file;
+  bool is_open = file.Open(output_path);
+  CHECK(is_open && file.GetSize() >= sizeof(CompiledScene::Header));
+  if (!is_open || file.GetSize() < sizeof(CompiledScene::Header)) {
+    return;
+  }
+
+  const uint8_t* data = file.GetData();
+  size_t size = file.GetSize();
+
+  CompiledScene::Header header;
+  std::memcpy(&header, data, sizeof(header));
+  CHECK(header.Magic == CompiledScene::Magic);
+  CHECK(header.Version == CompiledScene::Version);
+  CHECK(header.FileSize == size);
+
+  // Drawables keep their order, mesh and material names are stored once
+  auto records = CompiledScene::GetSection<CompiledScene::DrawableRecord>(data, size, header.Drawables);
+  auto mesh_names = CompiledScene::GetSection<uint32_t>(data, size, header.MeshNames);
+  auto material_names = CompiledScene::GetSection<uint32_t>(data, size, header.MaterialNames);
+  CHECK(records != nullptr && mesh_names != nullptr && material_names != nullptr);
+  CHECK(header.Drawables.Count == drawables.size());
+  CHECK(header.MeshNames.Count == 2);
+  CHECK(header.MaterialNames.Count == 2);
+
+  for (size_t i = 0; records != nullptr && i < header.Drawables.Count && i < drawables.size(); ++i) {
+    const auto& record = records[i];
+    CHECK(GetString(data, size, header, record.Name) == drawables[i].Name);
+    CHECK(record.Mesh < header.MeshNames.Count && GetString(data, size, header, mesh_names[record.Mesh]) == drawables[i].MeshName);
+    CHECK(record.Material < header.MaterialNames.Count
+          && GetString(data, size, header, material_names[record.Material]) == drawables[i].MaterialName);
+    CHECK(((record.Flags & CompiledScene::DrawableHasTransform) != 0) == drawables[i].HasTransform);
+  }
+
+  // Transforms are stored ready for the transform table
+  auto transforms = CompiledScene::GetSection<Rendering::Transform::TransformAndInverseTranspose>(data, size, header.Transforms);
+  CHECK(transforms != nullptr);
+  CHECK(header.Transforms.Count == drawables.size());
+  for (size_t i = 0; transforms != nullptr && i < header.Transforms.Count && i < drawables.size(); ++i) {
+    auto expected = ComputeTransform(drawables[i].Transform);
+    CHECK(std::memcmp(&transforms[i], &expected, sizeof(expected)) == 0);
+  }
+
+  // Lights
+  CHECK(header.DirectionalLights.Count == 1);
+  CHECK(header.PointLights.Count == 3);
+  CHECK(header.SpotLights.Count == 0);
+  CHECK(header.PointLights.Positions.Count == 3 && header.PointLights.Ranges.Count == 3);
+  auto ranges = CompiledScene::GetSection<float>(data, size, header.PointLights.Ranges);
+  CHECK(ranges != nullptr && ranges[0] == 10.0f);
+
+  // The scene file, then the lights file, both current
+  auto sources = CompiledScene::GetSection<CompiledScene::SourceRecord>(data, size, header.Sources);
+  CHECK(sources != nullptr);
+  CHECK(header.Sources.Count == 2);
+  if (sources != nullptr && header.Sources.Count == 2) {
+    CHECK(GetString(data, size, header, sources[0].Path) == "scene.json");
+    CHECK(GetString(data, size, header, sources[1].Path) == "lights.json");
+    CHECK(IsSourceCurrent(scene_path, sources[0]));
+    CHECK(IsSourceCurrent(lights_path, sources[1]));
+
+    // A changed lights file no longer matches its record, so the loader falls back to the JSON scene
+    auto lights_record = sources[1];
+    file.Close();
+    WriteFile(lights_path, MakeLights(12.0f));
+    CHECK(!IsSourceCurrent(lights_path, lights_record));
+  }
+}
+
+int main(int, char**) {
+  auto directory = filesystem::temp_directory_path() / "elg_compiled_scene_test";
+  std::error_code error;
+  filesystem::create_directories(directory, error);
+
+  TestCompiledSceneMatchesSources(directory);
+
+  filesystem::remove_all(directory, error);
+
+  return Tests::Finish("CompiledSceneTest");
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "core/json_stream.h"
+#include "test_helpers.h"
+
+// Flattens the visitor events, so a streamed record can be compared with the same record replayed from a document
+class RecordingVisitor : public Core::JsonRecordVisitor {
+ public:
+  void BeginRecord() override {
+    Events.emplace_back("begin");
+    m_record_begin_ = Events.size();
+  }
+
+  void Value(const std::string& path, int32_t index, const Core::JsonStreamValue& value) override {
+    std::ostringstream event;
+    event << path << '|' << index << '|' << static_cast<int>(value.ValueType) << '|';
+    switch (value.ValueType) {
+      case Core::JsonStreamValue::Type::Boolean:
+        event << value.Boolean;
+        break;
+      case Core::JsonStreamValue::Type::Integer:
+      case Core::JsonStreamValue::Type::Float:
+        event << value.Number;
+        break;
+      case Core::JsonStreamValue::Type::String:
+        event << *value.String;
+        break;
+      default:
+        break;
+    }
+    Events.emplace_back(event.str());
+  }
+
+  // nlohmann::json keeps object members sorted by key, so the events of a record are compared in sorted order
+  void EndRecord() override {
+    std::sort(std::begin(Events) + m_record_begin_, std::end(Events));
+    Events.emplace_back("end");
+    m_record_begin_ = Events.size();
+  }
+
+  std::vector<std::string> Events;
+
+ private:
+  size_t m_record_begin_ = 0;
+};
+
+// Pulls out the fields the scene loader keeps, the work both load paths have to do per drawable
+class DrawableCounter : public Core::JsonRecordVisitor {
+ public:
+  void BeginRecord() override {
+  }
+
+  void Value(const std::string& path, int32_t index, const Core::JsonStreamValue& value) override {
+    if (path == "name" || path == "mesh_name" || path == "material_name") {
+      NameBytes += value.String != nullptr ? value.String->size() : 0;
+    } else if (path == "transform.translation" && index >= 0) {
+      Sum += value.Number;
+    }
+  }
+
+  void EndRecord() override {
+    ++Count;
+  }
+
+  size_t Count = 0;
+  size_t NameBytes = 0;
+  double Sum = 0.0;
+};
+
+void WriteFile(const filesystem::path& path, const std::string& text) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+std::string ReadFile(const filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  std::ostringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+// Same layout as the scene files in assets/scenes, with drawable_count entries in "scene"
+std::string MakeScene(size_t drawable_count) {
+  std::mt19937 random(11);
+  std::uniform_real_distribution<float> position_distribution(-100.0f, 100.0f);
+
+  std::ostringstream scene;
+  scene << "{\n  \"meshes\": [ { \"prefix\": \"cube\", \"path\": \"assets/meshes/cube.obj\", \"options\": { \"index_buffer_format\": \"32_UINT\" } } ],\n";
+  scene << "  \"materials\": [ { \"name\": \"basic1\", \"type\": \"basic\", \"diffuse\": [0.2, 0.4, 0.8, 1.0], \"specular_power\": 100.0 } ],\n";
+  scene << "  \"lights\": \"assets/lights/cube_lights.json\",\n";
+  scene << "  \"scene\": [\n";
+  for (size_t i = 0; i < drawable_count; ++i) {
+    scene << "    {\n      \"name\": \"drawable_" << i << "\",\n      \"mesh_name\": \"cube cube\",\n      \"material_name\": \"basic1\",\n";
+    scene << "      \"transform\" : {\n        \"translation\": [" << position_distribution(random) << ", " << position_distribution(random)
+          << ", " << position_distribution(random) << "],\n";
+    scene << "        \"rotation\": [0.0, 1.0, 0.0, " << position_distribution(random) << "],\n";
+    scene << "        \"scale\": [0.5, 0.5, 0.5]\n      }\n    }" << (i + 1 < drawable_count ? "," : "") << "\n";
+  }
+  scene << "  ],\n  \"camera\": { \"position\": [0.0, 1.0, -5.0], \"fov\": 60 }\n}\n";
+  return scene.str();
+}
+
+void CheckMatchesDocument(const filesystem::path& path, const std::string& text, const std::string& record_array) {
+  WriteFile(path, text);
+
+  RecordingVisitor streamed;
+  nlohmann::json streamed_rest;
+  CHECK(Core::StreamJsonFile(path, record_array, &streamed, &streamed_rest));
+
+  auto document = nlohmann::json::parse(text);
+  RecordingVisitor replayed;
+  for (const auto& record : document[record_array]) {
+    Core::VisitJsonRecord(record, &replayed);
+  }
+
+  CHECK(streamed.Events == replayed.Events);
+
+  document[record_array] = nlohmann::json::array();
+  CHECK(streamed_rest == document);
+}
+
+void TestStreamMatchesDocument(const filesystem::path& path) {
+  CheckMatchesDocument(path, MakeScene(50), "scene");
+
+  // Nesting, escapes and every value type inside the records
+  CheckMatchesDocument(path, R"({ "before": { "a": [1, 2.5, "x"] },
+    "records": [
+      { "s": "quote \" backslash \\ tab \t unicode é 😀", "n": null, "t": true, "f": false },
+      { "nested": [[1, 2], [], [[3]]], "deep": { "er": { "est": -1.5e-3 } }, "empty": {} },
+      42, "bare", [ { "in_array": 1 } ]
+    ],
+    "after": [] })", "records");
+
+  // The record array may be missing or empty
+  CheckMatchesDocument(path, R"({ "records": [] })", "records");
+
+  WriteFile(path, R"({ "other": [1, 2] })");
+  RecordingVisitor missing;
+  nlohmann::json missing_rest;
+  CHECK(Core::StreamJsonFile(path, "records", &missing, &missing_rest));
+  CHECK(missing.Events.empty());
+  CHECK(missing_rest == nlohmann::json::parse(R"({ "other": [1, 2] })"));
+}
+
+void TestMalformedFilesAreRejected(const filesystem::path& path) {
+  const char* documents[] = {
+    "",
+    "{",
+    R"({ "records": [ { "a": 1 }, )",
+    R"({ "records": [ { "a": 1 } ] } trailing)",
+    R"({ "records": [ { "a": tru } ] })",
+    R"({ "records": [ { "a": "unterminated } ] })",
+    R"({ "records": [ { "a": 1, } ] })",
+    R"({ "records": [ { "a": 01 } ] })",
+    R"({ "records": [ { "a": "\x" } ] })",
+  };
+
+  for (auto document : documents) {
+    WriteFile(path, document);
+    RecordingVisitor visitor;
+    nlohmann::json rest;
+    CHECK(!Core::StreamJsonFile(path, "records", &visitor, &rest));
+  }
+
+  CHECK(!Core::StreamJsonFile(path.string() + ".missing", "records", nullptr, nullptr));
+}
+
+// Streaming against the document path the scene loader used before, on generated scenes
+void BenchmarkSceneLoad(const filesystem::path& path) {
+  std::printf("%10s %10s %12s %12s\n", "drawables", "MB", "document ms", "stream ms");
+  for (size_t drawable_count : { 10000, 50000, 200000 }) {
+    WriteFile(path, MakeScene(drawable_count));
+    auto megabytes = static_cast<double>(filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+    DrawableCounter document_counter;
+    auto document_milliseconds = Tests::TimeMilliseconds(3, [&]() {
+      document_counter = {};
+      auto document = nlohmann::json::parse(ReadFile(path));
+      for (const auto& record : document["scene"]) {
+        document_counter.NameBytes += record["name"].get_ref<const std::string&>().size();
+        document_counter.NameBytes += record["mesh_name"].get_ref<const std::string&>().size();
+        document_counter.NameBytes += record["material_name"].get_ref<const std::string&>().size();
+        for (const auto& value : record["transform"]["translation"]) {
+          document_counter.Sum += value.get<double>();
+        }
+        ++document_counter.Count;
+      }
+    });
+
+    DrawableCounter stream_counter;
+    auto stream_milliseconds = Tests::TimeMilliseconds(3, [&]() {
+      stream_counter = {};
+      nlohmann::json rest;
+      Core::StreamJsonFile(path, "scene", &stream_counter, &rest);
+    });
+
+    CHECK(document_counter.Count == drawable_count && stream_counter.Count == drawable_count);
+    CHECK(document_counter.NameBytes == stream_counter.NameBytes);
+
+    std::printf("%10zu %10.1f %12.1f %12.1f\n", drawable_count, megabytes, document_milliseconds, stream_milliseconds);
+  }
+}
+
+int main(int argc, char** argv) {
+  auto path = filesystem::temp_directory_path() / "elg_json_stream_test.json";
+
+  TestStreamMatchesDocument(path);
+  TestMalformedFilesAreRejected(path);
+
+  if (Tests::IsBenchmarkRun(argc, argv)) {
+    BenchmarkSceneLoad(path);
+  }
+
+  std::error_code error;
+  filesystem::remove(path, error);
+
+  return Tests::Finish("JsonStreamTest");
+}
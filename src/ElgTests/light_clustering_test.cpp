@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include "rendering/lights/light_clustering.h"
+#include "test_helpers.h"
+
+using namespace Rendering::Lights;
+
+const uint32_t TileCountX = 16;
+const uint32_t TileCountY = 8;
+const uint32_t SliceCount = 24;
+const float NearPlane = 0.1f;
+const float FarPlane = 100.0f;
+
+// 90 degree horizontal field of view at 4:3
+ClusterGrid BuildTestGrid() {
+  return BuildClusterGrid(TileCountX, TileCountY, SliceCount, NearPlane, FarPlane, 2.0f * NearPlane, 1.5f * NearPlane);
+}
+
+bool IsInFrustum(const ClusterGrid& grid, const DirectX::XMFLOAT3& point) {
+  return point.z > grid.NearPlane && point.z < grid.FarPlane
+      && std::abs(point.x / point.z) < grid.TanHalfWidth
+      && std::abs(point.y / point.z) < grid.TanHalfHeight;
+}
+
+// Same mapping the pixel shader uses, rows are counted from the top of the screen
+size_t GetClusterIndex(const ClusterGrid& grid, const DirectX::XMFLOAT3& point) {
+  auto x = static_cast<uint32_t>((point.x / point.z + grid.TanHalfWidth) / (2.0f * grid.TanHalfWidth) * grid.TileCountX);
+  auto row = static_cast<uint32_t>((grid.TanHalfHeight - point.y / point.z) / (2.0f * grid.TanHalfHeight) * grid.TileCountY);
+  auto slice = static_cast<uint32_t>(std::floor(std::log(point.z) * grid.GetSliceScale() + grid.GetSliceBias()));
+
+  x = std::min(x, grid.TileCountX - 1);
+  row = std::min(row, grid.TileCountY - 1);
+  slice = std::min(slice, grid.SliceCount - 1);
+  return (static_cast<size_t>(slice) * grid.TileCountY + row) * grid.TileCountX + x;
+}
+
+bool HasLight(const LightClusterBuilder& builder, size_t cluster_index, uint32_t light_index, bool is_spot_light) {
+  const auto& cluster = builder.GetClusters()[cluster_index];
+  const auto& light_indices = builder.GetLightIndices();
+
+  auto begin = cluster.Offset + (is_spot_light ? cluster.PointLightCount : 0);
+  auto end = begin + (is_spot_light ? cluster.SpotLightCount : cluster.PointLightCount);
+  for (auto i = begin; i < end; ++i) {
+    if (light_indices[i] == light_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+DirectX::BoundingSphere MakeSphere(float x, float y, float z, float radius) {
+  return DirectX::BoundingSphere(DirectX::XMFLOAT3(x, y, z), radius);
+}
+
+std::vector<DirectX::BoundingSphere> MakeRandomLights(size_t count, float min_radius, float max_radius, std::mt19937* random) {
+  std::uniform_real_distribution<float> depth_distribution(1.0f, 0.8f * FarPlane);
+  std::uniform_real_distribution<float> unit_distribution(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> radius_distribution(min_radius, max_radius);
+
+  std::vector<DirectX::BoundingSphere> lights;
+  for (size_t i = 0; i < count; ++i) {
+    auto z = depth_distribution(*random);
+    lights.emplace_back(MakeSphere(unit_distribution(*random) * z, unit_distribution(*random) * 0.75f * z, z, radius_distribution(*random)));
+  }
+  return lights;
+}
+
+void TestSmallLightLandsInItsCluster() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+
+  for (auto z : { 0.5f, 3.0f, 17.0f, 61.0f }) {
+    auto light = MakeSphere(0.31f * z, -0.17f * z, z, 0.001f);
+    builder.Build(grid, &light, 1, nullptr, 0);
+
+    CHECK(HasLight(builder, GetClusterIndex(grid, light.Center), 0, false));
+    // Binning is conservative, but a tiny light away from tile edges must not spread over the grid
+    CHECK(builder.GetLightIndices().size() <= 8);
+  }
+}
+
+void TestLightsOutsideTheFrustum() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+
+  std::vector<DirectX::BoundingSphere> lights = {
+    MakeSphere(0.0f, 0.0f, -5.0f, 1.0f),  // Behind the camera
+    MakeSphere(0.0f, 0.0f, 2.0f * FarPlane, 1.0f),  // Past the far plane
+    MakeSphere(100.0f, 0.0f, 5.0f, 1.0f),  // Right of the frustum
+    MakeSphere(0.0f, -100.0f, 5.0f, 1.0f),  // Below the frustum
+  };
+  builder.Build(grid, lights.data(), lights.size(), lights.data(), lights.size());
+
+  CHECK(builder.GetLightIndices().empty());
+  for (const auto& cluster : builder.GetClusters()) {
+    CHECK(cluster.PointLightCount == 0 && cluster.SpotLightCount == 0);
+  }
+}
+
+void TestEnclosingLightIsInEveryCluster() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+
+  auto light = MakeSphere(0.0f, 0.0f, 50.0f, 1000.0f);
+  builder.Build(grid, &light, 1, nullptr, 0);
+
+  CHECK(builder.GetClusters().size() == grid.GetClusterCount());
+  CHECK(builder.GetLightIndices().size() == grid.GetClusterCount());
+  for (size_t i = 0; i < builder.GetClusters().size(); ++i) {
+    CHECK(builder.GetClusters()[i].PointLightCount == 1 && HasLight(builder, i, 0, false));
+  }
+}
+
+void TestPointLightsPrecedeSpotLights() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+
+  std::vector<DirectX::BoundingSphere> point_lights = { MakeSphere(-40.0f, 0.0f, 20.0f, 0.01f), MakeSphere(1.0f, 1.0f, 10.0f, 0.01f) };
+  std::vector<DirectX::BoundingSphere> spot_lights = { MakeSphere(1.0f, 1.0f, 10.0f, 0.01f) };
+  builder.Build(grid, point_lights.data(), point_lights.size(), spot_lights.data(), spot_lights.size());
+
+  const auto& cluster = builder.GetClusters()[GetClusterIndex(grid, spot_lights[0].Center)];
+  CHECK(cluster.PointLightCount == 1);
+  CHECK(cluster.SpotLightCount == 1);
+  CHECK(builder.GetLightIndices()[cluster.Offset] == 1);
+  CHECK(builder.GetLightIndices()[cluster.Offset + 1] == 0);
+}
+
+// Every point of a light inside the frustum has to find the light in its cluster
+void TestFullClustersAreCapped() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+  builder.SetMaxLightsPerCluster(4);
+
+  // Three point lights and three spot lights enclosing the whole grid
+  std::vector<DirectX::BoundingSphere> lights(3, MakeSphere(0.0f, 0.0f, 50.0f, 1000.0f));
+  builder.Build(grid, lights.data(), lights.size(), lights.data(), lights.size());
+
+  CHECK(builder.GetLightIndices().size() == 4 * grid.GetClusterCount());
+  CHECK(builder.GetDroppedLightCount() == 2 * grid.GetClusterCount());
+  for (size_t i = 0; i < builder.GetClusters().size(); ++i) {
+    const auto& cluster = builder.GetClusters()[i];
+    CHECK(cluster.PointLightCount == 3 && cluster.SpotLightCount == 1);
+    CHECK(HasLight(builder, i, 2, false) && HasLight(builder, i, 0, true) && !HasLight(builder, i, 1, true));
+  }
+
+  // Clusters under the cap are left as they are
+  builder.Build(grid, lights.data(), 2, lights.data(), 2);
+  CHECK(builder.GetDroppedLightCount() == 0);
+  CHECK(builder.GetLightIndices().size() == 4 * grid.GetClusterCount());
+}
+
+void TestSampledPointsFindTheirLights() {
+  auto grid = BuildTestGrid();
+  LightClusterBuilder builder(4);
+
+  std::mt19937 random(1234);
+  auto point_lights = MakeRandomLights(200, 0.1f, 6.0f, &random);
+  auto spot_lights = MakeRandomLights(100, 0.1f, 6.0f, &random);
+  builder.Build(grid, point_lights.data(), point_lights.size(), spot_lights.data(), spot_lights.size());
+
+  std::uniform_real_distribution<float> unit_distribution(-1.0f, 1.0f);
+  auto check_samples = [&](const std::vector<DirectX::BoundingSphere>& lights, bool is_spot_light) {
+    for (size_t i = 0; i < lights.size(); ++i) {
+      for (int sample = 0; sample < 64; ++sample) {
+        DirectX::XMFLOAT3 offset(unit_distribution(random), unit_distribution(random), unit_distribution(random));
+        if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z > 1.0f) {
+          continue;
+        }
+
+        const auto& light = lights[i];
+        DirectX::XMFLOAT3 point(light.Center.x + offset.x * light.Radius, light.Center.y + offset.y * light.Radius,
+                                light.Center.z + offset.z * light.Radius);
+        if (IsInFrustum(grid, point)) {
+          CHECK(HasLight(builder, GetClusterIndex(grid, point), static_cast<uint32_t>(i), is_spot_light));
+        }
+      }
+    }
+  };
+
+  check_samples(point_lights, false);
+  check_samples(spot_lights, true);
+}
+
+void TestWorkerCountDoesNotChangeTheResult() {
+  auto grid = BuildTestGrid();
+
+  std::mt19937 random(42);
+  auto point_lights = MakeRandomLights(500, 0.5f, 4.0f, &random);
+  auto spot_lights = MakeRandomLights(250, 0.5f, 4.0f, &random);
+
+  LightClusterBuilder single_builder(1);
+  single_builder.Build(grid, point_lights.data(), point_lights.size(), spot_lights.data(), spot_lights.size());
+
+  LightClusterBuilder multi_builder(7);
+  multi_builder.Build(grid, point_lights.data(), point_lights.size(), spot_lights.data(), spot_lights.size());
+
+  CHECK(single_builder.GetLightIndices() == multi_builder.GetLightIndices());
+  CHECK(single_builder.GetClusters().size() == multi_builder.GetClusters().size());
+  for (size_t i = 0; i < single_builder.GetClusters().size(); ++i) {
+    const auto& single = single_builder.GetClusters()[i];
+    const auto& multi = multi_builder.GetClusters()[i];
+    CHECK(single.Offset == multi.Offset && single.PointLightCount == multi.PointLightCount && single.SpotLightCount == multi.SpotLightCount);
+  }
+}
+
+void BenchmarkBuild() {
+  auto grid = BuildTestGrid();
+  std::mt19937 random(7);
+
+  LightClusterBuilder single_builder(1);
+  LightClusterBuilder builder;
+
+  std::printf("%10s %12s %12s %14s\n", "lights", "1 worker ms", "all ms", "light indices");
+  for (size_t light_count : { 256, 1024, 4096, 16384, 65536 }) {
+    auto point_lights = MakeRandomLights(light_count / 2, 0.5f, 4.0f, &random);
+    auto spot_lights = MakeRandomLights(light_count / 2, 0.5f, 4.0f, &random);
+
+    auto build = [&](LightClusterBuilder* target) {
+      target->Build(grid, point_lights.data(), point_lights.size(), spot_lights.data(), spot_lights.size());
+    };
+
+    auto repetitions = light_count >= 16384 ? 5 : 20;
+    auto single_milliseconds = Tests::TimeMilliseconds(repetitions, [&]() { build(&single_builder); });
+    auto milliseconds = Tests::TimeMilliseconds(repetitions, [&]() { build(&builder); });
+
+    std::printf("%10zu %12.3f %12.3f %14zu\n", light_count, single_milliseconds, milliseconds, builder.GetLightIndices().size());
+  }
+}
+
+int main(int argc, char** argv) {
+  TestSmallLightLandsInItsCluster();
+  TestLightsOutsideTheFrustum();
+  TestEnclosingLightIsInEveryCluster();
+  TestPointLightsPrecedeSpotLights();
+  TestFullClustersAreCapped();
+  TestSampledPointsFindTheirLights();
+  TestWorkerCountDoesNotChangeTheResult();
+
+  if (Tests::IsBenchmarkRun(argc, argv)) {
+    BenchmarkBuild();
+  }
+
+  return Tests::Finish("LightClusteringTest");
+}
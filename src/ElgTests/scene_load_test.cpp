@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "loaders/scene_file.h"
+#include "loaders/transform_loader.h"
+#include "rendering/transform.h"
+#include "test_helpers.h"
+
+using namespace Loaders;
+
+void WriteFile(const filesystem::path& path, const std::string& text) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+// Same layout as the scene files in assets/scenes, with drawable_count entries in "scene"
+std::string MakeScene(size_t drawable_count) {
+  std::mt19937 random(17);
+  std::uniform_real_distribution<float> position_distribution(-100.0f, 100.0f);
+
+  std::ostringstream scene;
+  scene << "{ \"meshes\": [], \"materials\": [], \"scene\": [\n";
+  for (size_t i = 0; i < drawable_count; ++i) {
+    scene << "{ \"name\": \"drawable_" << i << "\", \"mesh_name\": \"cube cube\", \"material_name\": \"basic1\", ";
+    scene << "\"transform\": { \"translation\": [" << position_distribution(random) << ", " << position_distribution(random)
+          << ", " << position_distribution(random) << "], ";
+    scene << "\"rotation\": [0.0, 1.0, 0.0, " << position_distribution(random) << "], \"scale\": [0.5, 0.5, 0.5] } }"
+          << (i + 1 < drawable_count ? ",\n" : "\n");
+  }
+  scene << "] }\n";
+  return scene.str();
+}
+
+// The part of a scene load that doesn't need a device - reading the drawables and creating their transforms
+bool LoadTransforms(const filesystem::path& path, std::vector<DrawableDescription>* drawables,
+                    std::vector<Rendering::Transform::Transform>* transforms) {
+  drawables->clear();
+  transforms->clear();
+  Rendering::Transform::Clear();
+
+  nlohmann::json json_scene;
+  if (!ReadSceneFile(path, &json_scene, drawables)) {
+    return false;
+  }
+
+  transforms->reserve(drawables->size());
+  for (const auto& drawable : *drawables) {
+    Rendering::Transform::Transform transform;
+    if (!CreateTransform(drawable.Transform, &transform)) {
+      return false;
+    }
+    transforms->push_back(transform);
+  }
+  return true;
+}
+
+bool IsSameMatrix(const DirectX::XMMATRIX& a, const DirectX::XMMATRIX& b) {
+  return std::memcmp(&a, &b, sizeof(DirectX::XMMATRIX)) == 0;
+}
+
+// More drawables than the old per drawable constant buffer pool could hold, each keeps its own transform
+void TestEveryDrawableHasItsOwnTransform(const filesystem::path& path) {
+  const size_t DrawableCount = 1000;
+  WriteFile(path, MakeScene(DrawableCount));
+
+  std::vector<DrawableDescription> drawables;
+  std::vector<Rendering::Transform::Transform> transforms;
+  CHECK(LoadTransforms(path, &drawables, &transforms));
+  CHECK(drawables.size() == DrawableCount);
+  CHECK(transforms.size() == DrawableCount);
+  CHECK(Rendering::Transform::GetCount() == DrawableCount);
+
+  for (size_t i = 0; i < transforms.size() && i < drawables.size(); ++i) {
+    CHECK(transforms[i].IsValid() && transforms[i].Index == i);
+
+    auto expected = ComputeTransform(drawables[i].Transform);
+    const auto& actual = Rendering::Transform::Get(transforms[i]);
+    CHECK(IsSameMatrix(actual.Matrix, expected.Matrix));
+    CHECK(IsSameMatrix(actual.MatrixInverseTranspose, expected.MatrixInverseTranspose));
+  }
+
+  Rendering::Transform::Clear();
+  CHECK(Rendering::Transform::GetCount() == 0);
+}
+
+void BenchmarkSceneLoad(const filesystem::path& path) {
+  std::printf("%10s %10s %12s %14s %14s\n", "drawables", "MB", "load ms", "us/drawable", "transforms MB");
+  for (size_t drawable_count : { 1000, 10000, 100000, 1000000 }) {
+    WriteFile(path, MakeScene(drawable_count));
+    auto megabytes = static_cast<double>(filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+    std::vector<DrawableDescription> drawables;
+    std::vector<Rendering::Transform::Transform> transforms;
+    bool load_ok = true;
+    auto repetitions = drawable_count >= 1000000 ? 1 : 3;
+    auto milliseconds = Tests::TimeMilliseconds(repetitions, [&]() {
+      load_ok = load_ok && LoadTransforms(path, &drawables, &transforms);
+    });
+
+    CHECK(load_ok);
+    CHECK(transforms.size() == drawable_count);
+
+    auto transform_megabytes = static_cast<double>(Rendering::Transform::GetCount() * sizeof(Rendering::Transform::TransformAndInverseTranspose)) / (1024.0 * 1024.0);
+    std::printf("%10zu %10.1f %12.1f %14.3f %14.1f\n", drawable_count, megabytes, milliseconds,
+                milliseconds * 1000.0 / drawable_count, transform_megabytes);
+  }
+
+  Rendering::Transform::Clear();
+}
+
+int main(int argc, char** argv) {
+  auto path = filesystem::temp_directory_path() / "elg_scene_load_test.json";
+
+  TestEveryDrawableHasItsOwnTransform(path);
+
+  if (Tests::IsBenchmarkRun(argc, argv)) {
+    BenchmarkSceneLoad(path);
+  }
+
+  std::error_code error;
+  filesystem::remove(path, error);
+
+  return Tests::Finish("SceneLoadTest");
+}
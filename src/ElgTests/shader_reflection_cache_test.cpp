@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "core/filesystem.h"
+#include "rendering/shader_input_layout.h"
+#include "rendering/shader_reflection_cache.h"
+#include "test_helpers.h"
+
+using namespace Rendering;
+using namespace Rendering::ShaderReflection;
+
+const size_t CacheKey = 0x1234567;
+
+// Offsets into a sidecar written from MakeReflectionData - header, input count, then the first input
+const size_t FirstNameLengthOffset = 20;
+const size_t FirstChannelOffset = 36;
+const size_t FirstComponentTypeOffset = 44;
+
+ReflectionData MakeReflectionData() {
+  ReflectionData data;
+  data.Inputs.emplace_back("POSITION", 0, VertexDataChannel::POSITIONS, 3, D3D_REGISTER_COMPONENT_FLOAT32);
+  data.Inputs.emplace_back("TEXCOORD", 0, VertexDataChannel::TEXCOORDS0, 2, D3D_REGISTER_COMPONENT_FLOAT32);
+  data.InputElements = BuildInputElements(data.Inputs);
+  data.Texures.emplace_back("diffuse_texture", Texture::Type::DIM_2, 0, 4, 0, 1);
+  return data;
+}
+
+std::vector<char> ReadFile(const filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  std::vector<char> data(static_cast<size_t>(stream.tellg()));
+  stream.seekg(0);
+  stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+  return data;
+}
+
+void WriteFile(const filesystem::path& path, const std::vector<char>& data) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+template<typename T>
+void Patch(std::vector<char>* data, size_t offset, T value) {
+  std::memcpy(data->data() + offset, &value, sizeof(T));
+}
+
+bool ReadPatched(const filesystem::path& path, const std::vector<char>& data) {
+  WriteFile(path, data);
+  ReflectionData output;
+  return ReadCache(path, CacheKey, &output);
+}
+
+void TestRoundTrip(const filesystem::path& path) {
+  auto data = MakeReflectionData();
+  CHECK(WriteCache(path, CacheKey, data));
+
+  ReflectionData output;
+  CHECK(ReadCache(path, CacheKey, &output));
+  CHECK(output.Inputs.size() == 2);
+  CHECK(output.InputElements.size() == 2);
+  CHECK(output.Texures.size() == 1);
+  if (output.Inputs.size() != 2 || output.InputElements.size() != 2 || output.Texures.size() != 1) {
+    return;
+  }
+
+  CHECK(output.Inputs[1].SemanticName == "TEXCOORD");
+  CHECK(output.Inputs[1].Channel == VertexDataChannel::TEXCOORDS0);
+  CHECK(output.Inputs[1].ComponentCount == 2);
+  CHECK(output.InputElements[1].InputIndex == 1 && output.InputElements[1].InputSlot == 1);
+  CHECK(output.InputElements[1].InputSlotClass == D3D11_INPUT_PER_VERTEX_DATA);
+  CHECK(output.Texures[0].Name == "diffuse_texture");
+  CHECK(output.Texures[0].Type == Texture::Type::DIM_2);
+
+  CHECK(!ReadCache(path, CacheKey + 1, &output));
+}
+
+void TestMalformedSidecarsAreRejected(const filesystem::path& path) {
+  CHECK(WriteCache(path, CacheKey, MakeReflectionData()));
+  auto valid = ReadFile(path);
+  CHECK(ReadPatched(path, valid));
+
+  for (size_t size = 0; size < valid.size(); ++size) {
+    CHECK(!ReadPatched(path, std::vector<char>(valid.begin(), valid.begin() + size)));
+  }
+
+  auto trailing = valid;
+  trailing.push_back(0);
+  CHECK(!ReadPatched(path, trailing));
+
+  auto huge_name = valid;
+  Patch<uint32_t>(&huge_name, FirstNameLengthOffset, 0xFFFFFFFF);
+  CHECK(!ReadPatched(path, huge_name));
+
+  auto huge_input_count = valid;
+  Patch<uint32_t>(&huge_input_count, FirstNameLengthOffset - sizeof(uint32_t), 0x7FFFFFFF);
+  CHECK(!ReadPatched(path, huge_input_count));
+
+  auto combined_channels = valid;
+  Patch<uint32_t>(&combined_channels, FirstChannelOffset, 0x3);
+  CHECK(!ReadPatched(path, combined_channels));
+
+  auto unknown_channel = valid;
+  Patch<uint32_t>(&unknown_channel, FirstChannelOffset, 0x100000);
+  CHECK(!ReadPatched(path, unknown_channel));
+
+  auto unknown_component_type = valid;
+  Patch<uint32_t>(&unknown_component_type, FirstComponentTypeOffset, 7);
+  CHECK(!ReadPatched(path, unknown_component_type));
+}
+
+// Layouts come from the sidecar alone, the bytecode is never reflected
+void TestInputLayoutFromSidecar(const filesystem::path& path) {
+  CHECK(WriteCache(path, CacheKey, MakeReflectionData()));
+
+  ReflectionData data;
+  CHECK(ReadCache(path, CacheKey, &data));
+
+  std::vector<D3D11_INPUT_ELEMENT_DESC> input_layout;
+  std::vector<uint32_t> mesh_buffer_indices;
+
+  std::vector<VertexDataChannel> mesh_channels = { VertexDataChannel::NORMALS, VertexDataChannel::TEXCOORDS0, VertexDataChannel::POSITIONS };
+  std::vector<DXGI_FORMAT> mesh_formats = { DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT };
+  CHECK(BuildInputLayout(data, mesh_channels, mesh_formats, &input_layout, &mesh_buffer_indices));
+  CHECK(input_layout.size() == 2);
+  CHECK(mesh_buffer_indices == std::vector<uint32_t>({ 2, 1 }));
+  if (input_layout.size() == 2) {
+    CHECK(std::strcmp(input_layout[0].SemanticName, "POSITION") == 0);
+    CHECK(input_layout[0].Format == DXGI_FORMAT_R32G32B32_FLOAT && input_layout[0].InputSlot == 0);
+    CHECK(input_layout[1].Format == DXGI_FORMAT_R32G32_FLOAT && input_layout[1].InputSlot == 1);
+    CHECK(input_layout[1].AlignedByteOffset == D3D11_APPEND_ALIGNED_ELEMENT);
+  }
+
+  std::vector<DXGI_FORMAT> incompatible_formats = { DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT };
+  CHECK(!BuildInputLayout(data, mesh_channels, incompatible_formats, &input_layout, &mesh_buffer_indices));
+
+  std::vector<VertexDataChannel> missing_channels = { VertexDataChannel::POSITIONS };
+  std::vector<DXGI_FORMAT> missing_formats = { DXGI_FORMAT_R32G32B32_FLOAT };
+  CHECK(!BuildInputLayout(data, missing_channels, missing_formats, &input_layout, &mesh_buffer_indices));
+}
+
+int main(int, char**) {
+  auto path = filesystem::temp_directory_path() / "elg_shader_reflection_cache_test.reflection";
+
+  TestRoundTrip(path);
+  TestMalformedSidecarsAreRejected(path);
+  TestInputLayoutFromSidecar(path);
+
+  std::error_code error;
+  filesystem::remove(path, error);
+
+  return Tests::Finish("ShaderReflectionCacheTest");
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Minimal checks for the headless test programs. Failed checks are counted and printed, the program exit code
+// reports them to ctest. Benchmarks only run when the program is started with --benchmark.
+namespace Tests {
+
+inline int g_failure_count_ = 0;
+
+inline void ReportFailure(const char* file, int line, const char* expression) {
+  std::printf("%s(%d): check failed: %s\n", file, line, expression);
+  ++g_failure_count_;
+}
+
+#define CHECK(expression) \
+  do { \
+    if (!(expression)) { \
+      Tests::ReportFailure(__FILE__, __LINE__, #expression); \
+    } \
+  } while (false)
+
+inline bool IsBenchmarkRun(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--benchmark") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Average wall time of one call in milliseconds
+template<typename Function>
+double TimeMilliseconds(int repetitions, Function function) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    function();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+  return elapsed.count() / repetitions;
+}
+
+inline int Finish(const char* test_name) {
+  if (g_failure_count_ > 0) {
+    std::printf("%s: %d checks failed\n", test_name, g_failure_count_);
+    return 1;
+  }
+
+  std::printf("%s: all checks passed\n", test_name);
+  return 0;
+}
+
+}  // namespace Tests
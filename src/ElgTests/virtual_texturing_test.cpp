@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "rendering/virtual_texturing/feedback.h"
+#include "rendering/virtual_texturing/page_cache.h"
+#include "rendering/virtual_texturing/page_table.h"
+#include "test_helpers.h"
+
+using namespace Rendering::VirtualTexturing;
+
+PageId MakePage(uint32_t level, uint32_t x, uint32_t y) {
+  PageId page;
+  page.Level = level;
+  page.X = x;
+  page.Y = y;
+  return page;
+}
+
+const PageRequest* FindRequest(const std::vector<PageRequest>& requests, const PageId& page) {
+  for (const auto& request : requests) {
+    if (request.Page == page) {
+      return &request;
+    }
+  }
+  return nullptr;
+}
+
+void TestFreeSlotsAreTakenFirst() {
+  PageCache cache(2, 2);
+  CHECK(cache.GetCapacity() == 4);
+
+  std::set<std::pair<uint32_t, uint32_t>> slots;
+  for (uint32_t i = 0; i < 4; ++i) {
+    PageCache::Slot slot;
+    bool evicted = true;
+    PageId evicted_page;
+    CHECK(cache.Allocate(MakePage(0, i, 0), 1, &slot, &evicted, &evicted_page));
+    CHECK(!evicted);
+    CHECK(slot.X < 2 && slot.Y < 2);
+    slots.insert(std::make_pair(slot.X, slot.Y));
+  }
+
+  CHECK(slots.size() == 4);
+  CHECK(cache.GetResidentCount() == 4);
+
+  PageCache::Slot slot;
+  CHECK(cache.Find(MakePage(0, 2, 0), &slot));
+  CHECK(!cache.Find(MakePage(1, 2, 0), &slot));
+}
+
+void TestLeastRecentlyUsedIsEvicted() {
+  PageCache cache(3, 1);
+  PageCache::Slot slot;
+  bool evicted;
+  PageId evicted_page;
+
+  CHECK(cache.Allocate(MakePage(0, 0, 0), 1, &slot, &evicted, &evicted_page));
+  CHECK(cache.Allocate(MakePage(0, 1, 0), 2, &slot, &evicted, &evicted_page));
+  CHECK(cache.Allocate(MakePage(0, 2, 0), 3, &slot, &evicted, &evicted_page));
+
+  // The oldest page was used again, so the next oldest goes
+  CHECK(cache.Touch(MakePage(0, 0, 0), 4));
+  PageCache::Slot victim_slot;
+  CHECK(cache.Find(MakePage(0, 1, 0), &victim_slot));
+
+  CHECK(cache.Allocate(MakePage(0, 3, 0), 5, &slot, &evicted, &evicted_page));
+  CHECK(evicted);
+  CHECK(evicted_page == MakePage(0, 1, 0));
+  CHECK(slot.X == victim_slot.X && slot.Y == victim_slot.Y);
+  CHECK(!cache.Find(MakePage(0, 1, 0), &slot));
+  CHECK(cache.GetResidentCount() == 3);
+
+  CHECK(!cache.Touch(MakePage(0, 1, 0), 5));
+}
+
+void TestPagesUsedThisFrameAreKept() {
+  PageCache cache(2, 1);
+  PageCache::Slot slot;
+  bool evicted;
+  PageId evicted_page;
+
+  CHECK(cache.Allocate(MakePage(0, 0, 0), 7, &slot, &evicted, &evicted_page));
+  CHECK(cache.Allocate(MakePage(0, 1, 0), 7, &slot, &evicted, &evicted_page));
+  CHECK(!cache.Allocate(MakePage(0, 2, 0), 7, &slot, &evicted, &evicted_page));
+  CHECK(cache.GetResidentCount() == 2);
+
+  CHECK(cache.Allocate(MakePage(0, 2, 0), 8, &slot, &evicted, &evicted_page));
+  CHECK(evicted);
+}
+
+void TestPinnedPagesAreNeverEvicted() {
+  PageCache cache(2, 1);
+  PageCache::Slot slot;
+  bool evicted;
+  PageId evicted_page;
+
+  auto root = MakePage(3, 0, 0);
+  CHECK(cache.Allocate(root, 1, &slot, &evicted, &evicted_page));
+  cache.Pin(root);
+
+  for (uint32_t frame = 2; frame < 10; ++frame) {
+    CHECK(cache.Allocate(MakePage(0, frame, 0), frame, &slot, &evicted, &evicted_page));
+    CHECK(evicted_page != root);
+    CHECK(cache.Find(root, &slot));
+  }
+
+  // The only unpinned page is in use this frame
+  CHECK(!cache.Allocate(MakePage(0, 100, 0), 9, &slot, &evicted, &evicted_page));
+}
+
+void TestFeedbackRequestsAncestors() {
+  const uint32_t LevelCount = 4;
+
+  std::vector<uint32_t> feedback = {
+    PackPageId(MakePage(0, 3, 1)), PackPageId(MakePage(0, 3, 1)), PackPageId(MakePage(0, 3, 1)),
+    InvalidFeedback,
+    PackPageId(MakePage(0, 2, 1)),
+    PackPageId(MakePage(1, 4, 4)),
+    PackPageId(MakePage(0, 3, 1)),
+  };
+
+  std::vector<PageRequest> requests;
+  ReduceFeedback(feedback, LevelCount, &requests);
+
+  // Two level 0 pages, their shared parent at (1, 0), (4, 4) at level 1 and its chain to the root
+  auto page_0 = FindRequest(requests, MakePage(0, 3, 1));
+  auto page_1 = FindRequest(requests, MakePage(0, 2, 1));
+  auto parent = FindRequest(requests, MakePage(1, 1, 0));
+  auto other = FindRequest(requests, MakePage(1, 4, 4));
+  auto other_parent = FindRequest(requests, MakePage(2, 2, 2));
+  auto shared_parent = FindRequest(requests, MakePage(2, 0, 0));
+  auto root_0 = FindRequest(requests, MakePage(3, 0, 0));
+  auto root_1 = FindRequest(requests, MakePage(3, 1, 1));
+
+  CHECK(requests.size() == 8);
+  CHECK(page_0 != nullptr && page_0->Count == 4);
+  CHECK(page_1 != nullptr && page_1->Count == 1);
+  CHECK(parent != nullptr && parent->Count == 5);
+  CHECK(other != nullptr && other->Count == 1);
+  CHECK(other_parent != nullptr && other_parent->Count == 1);
+  CHECK(shared_parent != nullptr && shared_parent->Count == 5);
+  CHECK(root_0 != nullptr && root_0->Count == 5);
+  CHECK(root_1 != nullptr && root_1->Count == 1);
+
+  // Coarsest level first, most requested first within a level
+  CHECK(std::is_sorted(std::begin(requests), std::end(requests), [](const PageRequest& a, const PageRequest& b) {
+    if (a.Page.Level != b.Page.Level) {
+      return a.Page.Level > b.Page.Level;
+    }
+    return a.Count > b.Count;
+  }));
+}
+
+void TestFeedbackOutsideTheLevelsIsDropped() {
+  std::vector<uint32_t> feedback = { InvalidFeedback, PackPageId(MakePage(5, 0, 0)), InvalidFeedback };
+
+  std::vector<PageRequest> requests = { { MakePage(0, 0, 0), 1 } };
+  ReduceFeedback(feedback, 4, &requests);
+  CHECK(requests.empty());
+
+  ReduceFeedback({}, 4, &requests);
+  CHECK(requests.empty());
+}
+
+void TestPageTableFallsBackToAncestors() {
+  PageTable table(8, 4);
+  CHECK(table.GetLevelCount() == 4);
+
+  // A new table is uploaded once, even with nothing mapped
+  uint32_t dirty_levels;
+  CHECK(table.Update(&dirty_levels));
+  CHECK(dirty_levels == 4);
+  CHECK(!table.Update(&dirty_levels));
+
+  table.Map(MakePage(3, 0, 0), 1, 2);
+  CHECK(table.Update(&dirty_levels));
+  CHECK(dirty_levels == 4);
+
+  const auto& entries = table.GetEntries(0);
+  CHECK(std::all_of(std::begin(entries), std::end(entries), [](const PageTableEntry& entry) {
+    return entry.Valid && entry.CacheX == 1 && entry.CacheY == 2 && entry.Level == 3;
+  }));
+
+  // A finer page only covers its own descendants
+  table.Map(MakePage(1, 1, 0), 5, 6);
+  CHECK(table.Update(&dirty_levels));
+  CHECK(dirty_levels == 2);
+  CHECK(table.GetEntries(0)[2].CacheX == 5 && table.GetEntries(0)[2].Level == 1);
+  CHECK(table.GetEntries(0)[0].CacheX == 1 && table.GetEntries(0)[0].Level == 3);
+
+  table.Unmap(MakePage(1, 1, 0));
+  CHECK(table.Update(&dirty_levels));
+  CHECK(table.GetEntries(0)[2].CacheX == 1 && table.GetEntries(0)[2].Level == 3);
+}
+
+int main(int, char**) {
+  TestFreeSlotsAreTakenFirst();
+  TestLeastRecentlyUsedIsEvicted();
+  TestPagesUsedThisFrameAreKept();
+  TestPinnedPagesAreNeverEvicted();
+  TestFeedbackRequestsAncestors();
+  TestFeedbackOutsideTheLevelsIsDropped();
+  TestPageTableFallsBackToAncestors();
+
+  return Tests::Finish("VirtualTexturingTest");
+}